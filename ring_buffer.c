@@ -6,7 +6,7 @@
  * @version 2.1
  */
 
-#include "ring_buffer.h"
+#include "ring_buffer_internal.h"
 
 /* External declarations -----------------------------------------------------*/
 
@@ -18,6 +18,10 @@ extern const struct ring_buffer_ops ring_buffer_lockfree_ops;
 extern const struct ring_buffer_ops ring_buffer_disable_irq_ops;
 #endif
 
+#if RING_BUFFER_ENABLE_SPINLOCK
+extern const struct ring_buffer_ops ring_buffer_spinlock_ops;
+#endif
+
 #if RING_BUFFER_ENABLE_MUTEX
 extern const struct ring_buffer_ops ring_buffer_mutex_ops;
 extern bool ring_buffer_mutex_init(ring_buffer_t *rb);
@@ -25,28 +29,65 @@ extern void ring_buffer_mutex_deinit(ring_buffer_t *rb);
 #endif
 
 /* Private defines -----------------------------------------------------------*/
-#define MAX_CUSTOM_OPS  4  /**< 最多支持 4 个自定义策略 */
 
-/* Private types -------------------------------------------------------------*/
+/**
+ * @brief 注册表槽位的原子访问
+ *
+ * 非 GCC/Clang 编译器退化为普通读写，此时须在单一上下文中完成注册/注销
+ */
+#if defined(__GNUC__)
+#define OPS_SLOT_LOAD(p)            __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define OPS_SLOT_XCHG(p, v)         __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+#define OPS_SLOT_CAS(p, expect, v)  \
+    __atomic_compare_exchange_n((p), &(expect), (v), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+#define OPS_SLOT_LOAD(p)            (*(p))
+#define OPS_SLOT_XCHG(p, v)         ops_slot_xchg((p), (v))
+#define OPS_SLOT_CAS(p, expect, v)  ((*(p) == (expect)) ? (*(p) = (v), true) : false)
+#endif
 
 /**
- * @brief 自定义策略注册表项
+ * @brief 记录追踪事件（未设置追踪编号的缓冲区只多一次判断）
+ *
+ * 所有读写入口都经由这两个宏记录，len < req 即为写入溢出或读出不足；
+ * 单字节读写只在失败时记录，分散/聚集的请求长度只在记录时才计算
  */
-typedef struct {
-    ring_buffer_type_t type;
-    const struct ring_buffer_ops *ops;
-} custom_ops_entry_t;
+#if RING_BUFFER_ENABLE_TRACE
+#define RB_TRACE(rb, op, req, len)  do { \
+    if ((rb)->trace_id != 0) rb_trace_record((rb), (op), (req), (len)); \
+} while (0)
+#define RB_TRACE_IOV(rb, op, iov, iovcnt, len)  do { \
+    if ((rb)->trace_id != 0) rb_trace_record((rb), (op), trace_iov_total((iov), (iovcnt)), (len)); \
+} while (0)
+#else
+#define RB_TRACE(rb, op, req, len)  do { } while (0)
+#define RB_TRACE_IOV(rb, op, iov, iovcnt, len)  do { } while (0)
+#endif
 
 /* Private variables ---------------------------------------------------------*/
 
 /**
  * @brief 自定义策略注册表
+ *
+ * 以 (type - RING_BUFFER_TYPE_CUSTOM_BASE) 直接索引，查找为 O(1)；
+ * 槽位为 NULL 表示未注册
  */
-static custom_ops_entry_t custom_ops_registry[MAX_CUSTOM_OPS];
-static uint8_t custom_ops_count = 0;
+static const struct ring_buffer_ops *custom_ops_table[RING_BUFFER_MAX_CUSTOM_OPS];
 
 /* Private functions ---------------------------------------------------------*/
 
+#if RING_BUFFER_ENABLE_TRACE
+static uint16_t trace_iov_total(const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    uint32_t total = 0;
+    
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+    return (total > 0xFFFF) ? 0xFFFF : (uint16_t)total;
+}
+#endif
+
 /**
  * @brief 公共初始化逻辑
  */
@@ -64,6 +105,26 @@ static bool ring_buffer_init_common(ring_buffer_t *rb, uint8_t *buffer, uint16_t
     rb->tail = 0;
     rb->lock = NULL;
     rb->ops = NULL;
+    rb->ctx = NULL;
+    
+#if RING_BUFFER_ENABLE_SPINLOCK
+    rb->spin.owner = 0;
+    rb->spin.next = 0;
+#endif
+    
+#if RING_BUFFER_ENABLE_RING_SET
+    rb->set = NULL;
+    rb->set_index = 0;
+#endif
+    
+#if RING_BUFFER_ENABLE_TRACE
+    rb->trace_id = 0;
+#endif
+    
+#if RING_BUFFER_ENABLE_SNAPSHOT
+    rb->write_seq = 0;
+    rb->read_seq = 0;
+#endif
     
 #if RING_BUFFER_ENABLE_STATISTICS
     rb->write_count = 0;
@@ -74,17 +135,38 @@ static bool ring_buffer_init_common(ring_buffer_t *rb, uint8_t *buffer, uint16_t
     return true;
 }
 
+#if !defined(__GNUC__)
+static const struct ring_buffer_ops *ops_slot_xchg(const struct ring_buffer_ops **slot,
+                                                   const struct ring_buffer_ops *ops)
+{
+    const struct ring_buffer_ops *prev = *slot;
+    *slot = ops;
+    return prev;
+}
+#endif
+
+/**
+ * @brief 自定义策略类型对应的注册表槽位
+ *
+ * @return 槽位指针，类型超出注册表范围返回 NULL
+ */
+static const struct ring_buffer_ops **custom_ops_slot(ring_buffer_type_t type)
+{
+    if (type < RING_BUFFER_TYPE_CUSTOM_BASE ||
+        (unsigned)(type - RING_BUFFER_TYPE_CUSTOM_BASE) >= RING_BUFFER_MAX_CUSTOM_OPS) {
+        return NULL;
+    }
+    return &custom_ops_table[type - RING_BUFFER_TYPE_CUSTOM_BASE];
+}
+
 /**
  * @brief 查找自定义策略
  */
 static const struct ring_buffer_ops* find_custom_ops(ring_buffer_type_t type)
 {
-    for (uint8_t i = 0; i < custom_ops_count; i++) {
-        if (custom_ops_registry[i].type == type) {
-            return custom_ops_registry[i].ops;
-        }
-    }
-    return NULL;
+    const struct ring_buffer_ops **slot = custom_ops_slot(type);
+
+    return slot ? OPS_SLOT_LOAD(slot) : NULL;
 }
 
 /* Exported functions --------------------------------------------------------*/
@@ -132,6 +214,13 @@ bool ring_buffer_create(
             return true;
 #endif
         
+#if RING_BUFFER_ENABLE_SPINLOCK
+        case RING_BUFFER_TYPE_SPINLOCK:
+            rb->ops = &ring_buffer_spinlock_ops;
+            RB_LOG("Created spinlock buffer (size=%u)", size);
+            return true;
+#endif
+        
         default:
             /* 尝试查找自定义策略 */
             if (type >= RING_BUFFER_TYPE_CUSTOM_BASE) {
@@ -166,6 +255,13 @@ void ring_buffer_destroy(ring_buffer_t *rb)
     }
 #endif
     
+#if RING_BUFFER_ENABLE_RING_SET
+    /* 退出所属选择器 */
+    if (rb->set) {
+        ring_buffer_set_remove(rb->set, rb);
+    }
+#endif
+    
     RB_LOG("Destroyed buffer");
     
     /* 清空结构体 */
@@ -175,6 +271,7 @@ void ring_buffer_destroy(ring_buffer_t *rb)
     rb->tail = 0;
     rb->lock = NULL;
     rb->ops = NULL;
+    rb->ctx = NULL;
 }
 
 /**
@@ -183,32 +280,46 @@ void ring_buffer_destroy(ring_buffer_t *rb)
 bool ring_buffer_register_ops(ring_buffer_type_t type, const struct ring_buffer_ops *ops)
 {
 #if RING_BUFFER_ENABLE_PARAM_CHECK
-    if (!ops || type < RING_BUFFER_TYPE_CUSTOM_BASE) {
+    if (!ops) {
         RB_LOG("Register failed: invalid parameters");
         return false;
     }
+#endif
+    
+    const struct ring_buffer_ops **slot = custom_ops_slot(type);
+    const struct ring_buffer_ops *expect = NULL;
     
-    if (custom_ops_count >= MAX_CUSTOM_OPS) {
-        RB_LOG("Register failed: registry full");
+    if (!slot) {
+        RB_LOG("Register failed: type %d out of range", type);
         return false;
     }
     
-    /* 检查是否已注册 */
-    if (find_custom_ops(type)) {
+    /* 仅空槽位可写入，并发注册同一类型时只有一个成功 */
+    if (!OPS_SLOT_CAS(slot, expect, ops)) {
         RB_LOG("Register failed: type %d already registered", type);
         return false;
     }
-#endif
-    
-    /* 添加到注册表 */
-    custom_ops_registry[custom_ops_count].type = type;
-    custom_ops_registry[custom_ops_count].ops = ops;
-    custom_ops_count++;
     
     RB_LOG("Registered custom ops (type=%d)", type);
     return true;
 }
 
+/**
+ * @brief 注销自定义策略
+ */
+bool ring_buffer_unregister_ops(ring_buffer_type_t type)
+{
+    const struct ring_buffer_ops **slot = custom_ops_slot(type);
+    
+    if (!slot || OPS_SLOT_XCHG(slot, NULL) == NULL) {
+        RB_LOG("Unregister failed: type %d not registered", type);
+        return false;
+    }
+    
+    RB_LOG("Unregistered custom ops (type=%d)", type);
+    return true;
+}
+
 /* ==================== 便捷封装 API 实现 ==================== */
 
 bool ring_buffer_write(ring_buffer_t *rb, uint8_t data)
@@ -218,7 +329,12 @@ bool ring_buffer_write(ring_buffer_t *rb, uint8_t data)
         return false;
     }
 #endif
-    return rb->ops->write(rb, data);
+    bool ret = rb->ops->write(rb, data);
+    
+    if (!ret) {
+        RB_TRACE(rb, RING_BUFFER_OP_WRITE, 1, 0);
+    }
+    return ret;
 }
 
 bool ring_buffer_read(ring_buffer_t *rb, uint8_t *data)
@@ -228,7 +344,12 @@ bool ring_buffer_read(ring_buffer_t *rb, uint8_t *data)
         return false;
     }
 #endif
-    return rb->ops->read(rb, data);
+    bool ret = rb->ops->read(rb, data);
+    
+    if (!ret) {
+        RB_TRACE(rb, RING_BUFFER_OP_READ, 1, 0);
+    }
+    return ret;
 }
 
 uint16_t ring_buffer_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
@@ -238,7 +359,10 @@ uint16_t ring_buffer_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_
         return 0;
     }
 #endif
-    return rb->ops->write_multi(rb, data, len);
+    uint16_t ret = rb->ops->write_multi(rb, data, len);
+    
+    RB_TRACE(rb, RING_BUFFER_OP_WRITE_MULTI, len, ret);
+    return ret;
 }
 
 uint16_t ring_buffer_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
@@ -248,7 +372,36 @@ uint16_t ring_buffer_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
         return 0;
     }
 #endif
-    return rb->ops->read_multi(rb, data, len);
+    uint16_t ret = rb->ops->read_multi(rb, data, len);
+    
+    RB_TRACE(rb, RING_BUFFER_OP_READ_MULTI, len, ret);
+    return ret;
+}
+
+uint16_t ring_buffer_writev(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!rb || !iov || iovcnt == 0 || !rb->ops || !rb->ops->writev) {
+        return 0;
+    }
+#endif
+    uint16_t ret = rb->ops->writev(rb, iov, iovcnt);
+    
+    RB_TRACE_IOV(rb, RING_BUFFER_OP_WRITEV, iov, iovcnt, ret);
+    return ret;
+}
+
+uint16_t ring_buffer_readv(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!rb || !iov || iovcnt == 0 || !rb->ops || !rb->ops->readv) {
+        return 0;
+    }
+#endif
+    uint16_t ret = rb->ops->readv(rb, iov, iovcnt);
+    
+    RB_TRACE_IOV(rb, RING_BUFFER_OP_READV, iov, iovcnt, ret);
+    return ret;
 }
 
 uint16_t ring_buffer_available(const ring_buffer_t *rb)
@@ -300,3 +453,198 @@ void ring_buffer_clear(ring_buffer_t *rb)
 #endif
     rb->ops->clear(rb);
 }
+
+#if RING_BUFFER_ENABLE_SNAPSHOT
+bool ring_buffer_snapshot(const ring_buffer_t *rb, ring_buffer_snapshot_t *snap)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!rb || !snap) {
+        return false;
+    }
+#endif
+
+    for (uint32_t i = 0; i < RING_BUFFER_SNAPSHOT_RETRIES; i++) {
+        uint32_t wseq = __atomic_load_n(&rb->write_seq, __ATOMIC_ACQUIRE);
+        uint32_t rseq = __atomic_load_n(&rb->read_seq, __ATOMIC_ACQUIRE);
+
+        if ((wseq | rseq) & 1u) {
+            continue;   /* 有写者正在修改 */
+        }
+
+        snap->size = rb->size;
+        snap->head = rb->head;
+        snap->tail = rb->tail;
+#if RING_BUFFER_ENABLE_STATISTICS
+        snap->write_count = rb->write_count;
+        snap->read_count = rb->read_count;
+        snap->overflow_count = rb->overflow_count;
+#endif
+
+        /* 字段读取须在复核序号之前完成 */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (rb->write_seq == wseq && rb->read_seq == rseq) {
+            snap->occupancy = (snap->size == 0) ? 0 :
+                (uint16_t)((snap->head + snap->size - snap->tail) % snap->size);
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif /* RING_BUFFER_ENABLE_SNAPSHOT */
+
+#if RING_BUFFER_ENABLE_CRC
+uint16_t ring_buffer_write_multi_crc(ring_buffer_t *rb, const uint8_t *data, uint16_t len,
+                                     ring_buffer_crc_type_t type, uint32_t *crc)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!rb || !data || !crc || len == 0 || !rb->ops || !rb->ops->write_multi_crc) {
+        return 0;
+    }
+#endif
+    uint16_t ret = rb->ops->write_multi_crc(rb, data, len, type, crc);
+    
+    RB_TRACE(rb, RING_BUFFER_OP_WRITE_MULTI_CRC, len, ret);
+    return ret;
+}
+
+uint16_t ring_buffer_read_multi_crc(ring_buffer_t *rb, uint8_t *data, uint16_t len,
+                                    ring_buffer_crc_type_t type, uint32_t *crc)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!rb || !data || !crc || len == 0 || !rb->ops || !rb->ops->read_multi_crc) {
+        return 0;
+    }
+#endif
+    uint16_t ret = rb->ops->read_multi_crc(rb, data, len, type, crc);
+    
+    RB_TRACE(rb, RING_BUFFER_OP_READ_MULTI_CRC, len, ret);
+    return ret;
+}
+#endif /* RING_BUFFER_ENABLE_CRC */
+
+#if RING_BUFFER_ENABLE_FD_IO
+ssize_t ring_buffer_fill_from_fd(ring_buffer_t *rb, int fd, uint16_t max)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!rb || fd < 0 || !rb->ops || !rb->ops->fill_from_fd) {
+        return -1;
+    }
+#endif
+    ssize_t ret = rb->ops->fill_from_fd(rb, fd, max);
+    
+    /* 传输量受对端数据量限制，不算溢出；只有缓冲区满时才记为溢出 */
+    RB_TRACE(rb, RING_BUFFER_OP_FILL_FROM_FD,
+             (ret > 0) ? (uint16_t)ret : (rb->ops->is_full(rb) ? max : 0),
+             (ret > 0) ? (uint16_t)ret : 0);
+    return ret;
+}
+
+ssize_t ring_buffer_drain_to_fd(ring_buffer_t *rb, int fd, uint16_t max)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!rb || fd < 0 || !rb->ops || !rb->ops->drain_to_fd) {
+        return -1;
+    }
+#endif
+    ssize_t ret = rb->ops->drain_to_fd(rb, fd, max);
+    
+    /* 只有缓冲区空时才记为读出不足 */
+    RB_TRACE(rb, RING_BUFFER_OP_DRAIN_TO_FD,
+             (ret > 0) ? (uint16_t)ret : (rb->ops->is_empty(rb) ? max : 0),
+             (ret > 0) ? (uint16_t)ret : 0);
+    return ret;
+}
+#endif /* RING_BUFFER_ENABLE_FD_IO */
+
+#if RING_BUFFER_ENABLE_RESIZE
+bool ring_buffer_resize(ring_buffer_t *rb, uint8_t *buffer, uint16_t size, uint8_t **old_buffer)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!rb || !buffer || size < RING_BUFFER_MIN_SIZE || !rb->ops || !rb->ops->resize) {
+        return false;
+    }
+#endif
+    
+    /* 原存储块由策略在临界区内交回，不能在这里提前读取 rb->buffer */
+    uint8_t *old;
+    uint16_t old_size;
+    
+    if (!rb->ops->resize(rb, buffer, size, &old, &old_size)) {
+        return false;
+    }
+    
+    if (old_buffer) {
+        *old_buffer = old;
+    }
+    
+    RB_LOG("Resized buffer (size=%u)", size);
+    return true;
+}
+
+#if RING_BUFFER_ENABLE_STATISTICS
+bool ring_buffer_auto_resize(ring_buffer_t *rb, ring_buffer_resize_policy_t *policy)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!rb || !policy || !policy->alloc || !rb->ops || !rb->ops->resize) {
+        return false;
+    }
+#endif
+    
+    /* 不加锁读取，只用于决策；实际换下的存储块大小以 resize 操作返回的为准 */
+    uint32_t overflow_count = __atomic_load_n(&rb->overflow_count, __ATOMIC_RELAXED);
+    uint32_t overflows = overflow_count - policy->last_overflow;
+    uint16_t cur_size = __atomic_load_n(&rb->size, __ATOMIC_RELAXED);
+    uint16_t new_size = cur_size;
+    
+    policy->last_overflow = overflow_count;
+    
+    if (overflows > 0) {
+        policy->idle_checks = 0;
+        
+        /* 溢出过多：翻倍，不超过上限 */
+        if (overflows >= policy->grow_overflows && cur_size < policy->max_size) {
+            new_size = (cur_size > policy->max_size / 2) ? policy->max_size : cur_size * 2;
+        }
+    } else if (policy->min_size != 0 && ring_buffer_available(rb) < cur_size / 4) {
+        /* 持续空闲：减半，不低于下限 */
+        if (++policy->idle_checks >= policy->shrink_checks && cur_size / 2 >= policy->min_size) {
+            new_size = cur_size / 2;
+        }
+    } else {
+        policy->idle_checks = 0;
+    }
+    
+    if (new_size == cur_size) {
+        return false;
+    }
+    
+    uint8_t *buffer = policy->alloc(new_size, policy->arg);
+    uint8_t *old;
+    uint16_t old_size;
+    
+    if (!buffer) {
+        return false;
+    }
+    
+    if (!rb->ops->resize(rb, buffer, new_size, &old, &old_size)) {
+        /* 缩容时数据放不下，放弃本次 */
+        if (policy->release) {
+            policy->release(buffer, new_size, policy->arg);
+        }
+        return false;
+    }
+    
+    policy->idle_checks = 0;
+    policy->last_overflow = __atomic_load_n(&rb->overflow_count, __ATOMIC_RELAXED);
+    RB_LOG("Resized buffer (size=%u)", new_size);
+    
+    if (policy->release) {
+        policy->release(old, old_size, policy->arg);
+    }
+    
+    return true;
+}
+#endif /* RING_BUFFER_ENABLE_STATISTICS */
+#endif /* RING_BUFFER_ENABLE_RESIZE */
@@ -35,20 +35,80 @@ extern "C" {
 #include <string.h>
 #include "ring_buffer_config.h"
 
+#if RING_BUFFER_ENABLE_FD_IO
+#include <sys/types.h>
+#endif
+
 /* Exported types ------------------------------------------------------------*/
 
 /**
  * @brief 线程安全策略枚举
+ *
+ * @note 取值固定，已注册的自定义类型号不随内置策略增加而改变；
+ *       之后新增的内置策略从 0x80 起编号，不占用自定义区间
  */
 typedef enum {
-    RING_BUFFER_TYPE_LOCKFREE = 0,   /**< 无锁模式（SPSC）*/
-    RING_BUFFER_TYPE_DISABLE_IRQ,    /**< 关中断模式（裸机）*/
-    RING_BUFFER_TYPE_MUTEX,          /**< 互斥锁模式（RTOS）*/
-    RING_BUFFER_TYPE_CUSTOM_BASE     /**< 自定义策略起始值 */
+    RING_BUFFER_TYPE_LOCKFREE = 0,          /**< 无锁模式（SPSC）*/
+    RING_BUFFER_TYPE_DISABLE_IRQ = 1,       /**< 关中断模式（裸机）*/
+    RING_BUFFER_TYPE_MUTEX = 2,             /**< 互斥锁模式（RTOS）*/
+    RING_BUFFER_TYPE_CUSTOM_BASE = 3,       /**< 自定义策略起始值 */
+    RING_BUFFER_TYPE_SPINLOCK = 0x80        /**< 自旋锁模式（多核）*/
 } ring_buffer_type_t;
 
+/**
+ * @brief 分散/聚集读写的数据段
+ *
+ * @note
+ * - 用法类似 POSIX struct iovec，但 len 为 uint16_t，内存布局不兼容，不能与 struct iovec 互相强转
+ * - 写入时 base 指向的数据不会被修改
+ */
+typedef struct {
+    void *base;                             /**< 数据段起始地址 */
+    uint16_t len;                           /**< 数据段长度（字节）*/
+} ring_buffer_iovec_t;
+
+#if RING_BUFFER_ENABLE_CRC
+/**
+ * @brief CRC 算法枚举
+ */
+typedef enum {
+    RING_BUFFER_CRC16_CCITT = 0,     /**< CRC-16/CCITT-FALSE（0x1021，初值 0xFFFF）*/
+    RING_BUFFER_CRC16_MODBUS,        /**< CRC-16/MODBUS（0x8005 反射，初值 0xFFFF）*/
+    RING_BUFFER_CRC32,               /**< CRC-32（IEEE 802.3，以太网/ZIP）*/
+    RING_BUFFER_CRC32C               /**< CRC-32C（Castagnoli，硬件加速）*/
+} ring_buffer_crc_type_t;
+#endif
+
+#if RING_BUFFER_ENABLE_SPINLOCK
+/**
+ * @brief 自旋锁字
+ *
+ * TTAS 只使用 owner（0 = 空闲）；票据锁中 owner 为当前服务号，next 为下一个票号
+ */
+typedef struct {
+    volatile uint16_t owner;
+    volatile uint16_t next;
+} ring_buffer_spin_t;
+#endif
+
+#if RING_BUFFER_ENABLE_MUTEX && RING_BUFFER_MUTEX_COPY_OUTSIDE
+/**
+ * @brief 锁外拷贝的预留记录（互斥锁模式，均在锁内修改）
+ *
+ * 没有未提交的预留时 head 与缓冲区的 head 相同
+ */
+typedef struct {
+    uint16_t head;                          /**< 已预留到的写位置 */
+    uint16_t end[RING_BUFFER_MUTEX_MAX_RESERVE]; /**< 各预留的结束位置 */
+    uint8_t first;                          /**< 最早一条未提交预留的槽号 */
+    uint8_t count;                          /**< 未提交的预留数 */
+    uint8_t done;                           /**< 已拷贝完成的槽位（位图）*/
+} ring_buffer_reserve_t;
+#endif
+
 /* Forward declarations ------------------------------------------------------*/
 struct ring_buffer_ops;
+struct ring_buffer_set;
 
 /**
  * @brief 环形缓冲区控制结构
@@ -64,7 +124,28 @@ typedef struct {
     volatile uint16_t head;                 /**< 写指针（生产者）*/
     volatile uint16_t tail;                 /**< 读指针（消费者）*/
     void *lock;                             /**< 锁句柄（互斥锁模式）*/
+#if RING_BUFFER_ENABLE_SPINLOCK
+    ring_buffer_spin_t spin;                /**< 自旋锁（自旋锁模式）*/
+#endif
+#if RING_BUFFER_ENABLE_MUTEX && RING_BUFFER_MUTEX_COPY_OUTSIDE
+    ring_buffer_reserve_t rsv;              /**< 锁外拷贝的预留记录（互斥锁模式）*/
+#endif
     const struct ring_buffer_ops *ops;      /**< 操作接口指针 */
+    void *ctx;                              /**< 策略私有上下文（分段/压缩/加密缓冲区、自定义策略）*/
+    
+#if RING_BUFFER_ENABLE_RING_SET
+    struct ring_buffer_set *set;            /**< 所属选择器，NULL = 未加入 */
+    uint8_t set_index;                      /**< 在选择器中的位号 */
+#endif
+    
+#if RING_BUFFER_ENABLE_TRACE
+    uint8_t trace_id;                       /**< 追踪编号，0 = 不记录 */
+#endif
+    
+#if RING_BUFFER_ENABLE_SNAPSHOT
+    volatile uint32_t write_seq;            /**< 生产者侧快照序号（奇数 = 修改中）*/
+    volatile uint32_t read_seq;             /**< 消费者侧快照序号（奇数 = 修改中）*/
+#endif
     
 #if RING_BUFFER_ENABLE_STATISTICS
     uint32_t write_count;                   /**< 写入次数 */
@@ -73,6 +154,29 @@ typedef struct {
 #endif
 } ring_buffer_t;
 
+/**
+ * @brief 操作编号（装饰器层与事件追踪使用）
+ */
+typedef enum {
+    RING_BUFFER_OP_WRITE = 0,
+    RING_BUFFER_OP_READ,
+    RING_BUFFER_OP_WRITE_MULTI,
+    RING_BUFFER_OP_READ_MULTI,
+    RING_BUFFER_OP_AVAILABLE,
+    RING_BUFFER_OP_FREE_SPACE,
+    RING_BUFFER_OP_IS_EMPTY,
+    RING_BUFFER_OP_IS_FULL,
+    RING_BUFFER_OP_CLEAR,
+    RING_BUFFER_OP_WRITEV,
+    RING_BUFFER_OP_READV,
+    RING_BUFFER_OP_WRITE_MULTI_CRC,
+    RING_BUFFER_OP_READ_MULTI_CRC,
+    RING_BUFFER_OP_FILL_FROM_FD,
+    RING_BUFFER_OP_DRAIN_TO_FD,
+    RING_BUFFER_OP_RESIZE,
+    RING_BUFFER_OP_COUNT
+} ring_buffer_op_t;
+
 /**
  * @brief 操作接口结构体（策略模式）
  * 
@@ -88,6 +192,26 @@ struct ring_buffer_ops {
     bool (*is_empty)(const ring_buffer_t *rb);
     bool (*is_full)(const ring_buffer_t *rb);
     void (*clear)(ring_buffer_t *rb);
+    uint16_t (*writev)(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt);
+    uint16_t (*readv)(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt);
+    
+#if RING_BUFFER_ENABLE_CRC
+    uint16_t (*write_multi_crc)(ring_buffer_t *rb, const uint8_t *data, uint16_t len,
+                                ring_buffer_crc_type_t type, uint32_t *crc);
+    uint16_t (*read_multi_crc)(ring_buffer_t *rb, uint8_t *data, uint16_t len,
+                               ring_buffer_crc_type_t type, uint32_t *crc);
+#endif
+    
+#if RING_BUFFER_ENABLE_FD_IO
+    ssize_t (*fill_from_fd)(ring_buffer_t *rb, int fd, uint16_t max);
+    ssize_t (*drain_to_fd)(ring_buffer_t *rb, int fd, uint16_t max);
+#endif
+    
+#if RING_BUFFER_ENABLE_RESIZE
+    /* old / old_size 在临界区内取得，并发扩缩容时各调用者拿到的都是自己换下的存储块 */
+    bool (*resize)(ring_buffer_t *rb, uint8_t *buffer, uint16_t size,
+                   uint8_t **old, uint16_t *old_size);
+#endif
 };
 
 /* Exported functions --------------------------------------------------------*/
@@ -163,6 +287,39 @@ uint16_t ring_buffer_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_
  */
 uint16_t ring_buffer_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len);
 
+/**
+ * @brief 分散/聚集写入（全部写入或完全不写）
+ * 
+ * @param rb     缓冲区指针
+ * @param iov    数据段数组（如帧头、负载、帧尾）
+ * @param iovcnt 数据段个数
+ * 
+ * @return 写入的总字节数；剩余空间不足以容纳全部数据段时返回 0
+ * 
+ * @note 
+ * - 只更新一次 head，消费者不会看到半帧
+ * - 空间不足时计入一次溢出统计
+ * 
+ * @code
+ * ring_buffer_iovec_t iov[3] = {
+ *     { &hdr, sizeof(hdr) },
+ *     { payload, payload_len },
+ *     { &crc, sizeof(crc) },
+ * };
+ * ring_buffer_writev(&tx_rb, iov, 3);
+ * @endcode
+ */
+uint16_t ring_buffer_writev(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt);
+
+/**
+ * @brief 分散/聚集读取（全部读出或完全不读）
+ * 
+ * @return 读取的总字节数；可读数据不足以填满全部数据段时返回 0
+ * 
+ * @note 只更新一次 tail
+ */
+uint16_t ring_buffer_readv(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt);
+
 /* ==================== 状态查询 ==================== */
 
 /**
@@ -192,6 +349,873 @@ bool ring_buffer_is_full(const ring_buffer_t *rb);
  */
 void ring_buffer_clear(ring_buffer_t *rb);
 
+#if RING_BUFFER_ENABLE_SNAPSHOT
+
+/**
+ * @brief 缓冲区状态快照
+ *
+ * 各字段取自同一时刻，满足 occupancy == (head - tail) mod size，
+ * 且 write_count - read_count 与 occupancy 的变化同步
+ */
+typedef struct {
+    uint16_t size;                          /**< 缓冲区总大小 */
+    uint16_t head;                          /**< 写指针 */
+    uint16_t tail;                          /**< 读指针 */
+    uint16_t occupancy;                     /**< 可读数据量 */
+#if RING_BUFFER_ENABLE_STATISTICS
+    uint32_t write_count;                   /**< 写入次数 */
+    uint32_t read_count;                    /**< 读取次数 */
+    uint32_t overflow_count;                /**< 溢出次数 */
+#endif
+} ring_buffer_snapshot_t;
+
+/**
+ * @brief 读取一致性快照（不加锁）
+ *
+ * @param rb   缓冲区指针
+ * @param snap 输出快照
+ *
+ * @return true=成功；false=重读 RING_BUFFER_SNAPSHOT_RETRIES 次仍有写者在修改，
+ *         snap 内容无效，稍后再取
+ *
+ * @note
+ * - 任意线程/任务均可调用，不阻塞也不减慢生产者与消费者
+ * - 适用于以 head / tail 存放数据的策略（无锁、关中断、互斥锁、自旋锁、加密、
+ *   压缩；压缩缓冲区的数据量与计数均为存储字节数）；分段缓冲区不使用
+ *   head / tail，快照中只有统计计数有效
+ * - 与 ring_buffer_clear() / ring_buffer_resize() 同时调用时要求同这两个接口：
+ *   期间没有其他读写
+ *
+ * @code
+ * ring_buffer_snapshot_t s;
+ *
+ * if (ring_buffer_snapshot(&uart_rx_rb, &s)) {
+ *     report("rx", s.occupancy, s.size, s.overflow_count);
+ * }
+ * @endcode
+ */
+bool ring_buffer_snapshot(const ring_buffer_t *rb, ring_buffer_snapshot_t *snap);
+
+#endif /* RING_BUFFER_ENABLE_SNAPSHOT */
+
+/* ==================== 带 CRC 的批量读写 ==================== */
+
+#if RING_BUFFER_ENABLE_CRC
+
+/**
+ * @brief 批量写入并计算 CRC（拷贝与校验一次完成）
+ *
+ * @param rb   缓冲区指针
+ * @param data 数据指针
+ * @param len  期望写入长度
+ * @param type CRC 算法
+ * @param crc  [输入/输出] 累计 CRC，初值由 ring_buffer_crc_init() 给出
+ *
+ * @return 实际写入的字节数，CRC 仅覆盖实际写入的部分
+ *
+ * @note 可连续调用累计多段数据，最后用 ring_buffer_crc_final() 得到结果
+ */
+uint16_t ring_buffer_write_multi_crc(ring_buffer_t *rb, const uint8_t *data, uint16_t len,
+                                     ring_buffer_crc_type_t type, uint32_t *crc);
+
+/**
+ * @brief 批量读取并计算 CRC（拷贝与校验一次完成）
+ *
+ * @return 实际读取的字节数，CRC 仅覆盖实际读取的部分
+ *
+ * @code
+ * // Modbus RTU 帧校验
+ * uint8_t frame[64];
+ * uint32_t crc = ring_buffer_crc_init(RING_BUFFER_CRC16_MODBUS);
+ * uint16_t n = ring_buffer_read_multi_crc(&uart_rx_rb, frame, frame_len,
+ *                                         RING_BUFFER_CRC16_MODBUS, &crc);
+ * bool ok = (n == frame_len) &&
+ *           (ring_buffer_crc_final(RING_BUFFER_CRC16_MODBUS, crc) == 0);
+ * @endcode
+ */
+uint16_t ring_buffer_read_multi_crc(ring_buffer_t *rb, uint8_t *data, uint16_t len,
+                                    ring_buffer_crc_type_t type, uint32_t *crc);
+
+/**
+ * @brief 获取 CRC 初值
+ */
+uint32_t ring_buffer_crc_init(ring_buffer_crc_type_t type);
+
+/**
+ * @brief 计算 CRC 最终值（异或输出值）
+ */
+uint32_t ring_buffer_crc_final(ring_buffer_crc_type_t type, uint32_t crc);
+
+#endif /* RING_BUFFER_ENABLE_CRC */
+
+/* ==================== 在线扩缩容 ==================== */
+
+#if RING_BUFFER_ENABLE_RESIZE
+
+/**
+ * @brief 将缓冲区迁移到新的存储块
+ *
+ * @param rb         缓冲区
+ * @param buffer     新存储块（用户分配，可大于或小于原存储块）
+ * @param size       新存储块大小（字节）
+ * @param old_buffer 输出：原存储块，迁移成功后由调用者回收（可为 NULL）
+ *
+ * @return true=成功, false=可读数据放不下或策略不支持
+ *
+ * @note
+ * - 可读数据按顺序拷贝到新存储块起始处（环绕部分自动拼接）
+ * - 互斥锁 / 关中断模式在锁内完成，可与读写并发调用
+ * - 无锁模式须满足静止条件：在消费者上下文调用，且生产者已暂停
+ *   （如关闭对应中断或等待生产者线程停在约定的同步点）
+ *
+ * @code
+ * static uint8_t big_storage[4096];
+ * uint8_t *old;
+ *
+ * if (ring_buffer_resize(&log_rb, big_storage, sizeof(big_storage), &old)) {
+ *     pool_free(old);
+ * }
+ * @endcode
+ */
+bool ring_buffer_resize(ring_buffer_t *rb, uint8_t *buffer, uint16_t size, uint8_t **old_buffer);
+
+#if RING_BUFFER_ENABLE_STATISTICS
+
+/**
+ * @brief 自动扩缩容策略
+ */
+typedef struct {
+    uint16_t min_size;              /**< 缩容下限，0 = 不缩容 */
+    uint16_t max_size;              /**< 扩容上限 */
+    uint16_t grow_overflows;        /**< 两次检查间新增溢出次数达到此值时扩容（翻倍）*/
+    uint8_t shrink_checks;          /**< 连续多少次检查无溢出且使用率低于 1/4 时缩容（减半）*/
+    uint8_t idle_checks;            /**< 内部计数：连续空闲检查次数 */
+    uint32_t last_overflow;         /**< 内部记录：上次检查时的 overflow_count */
+    uint8_t *(*alloc)(uint16_t size, void *arg);            /**< 分配新存储块 */
+    void (*release)(uint8_t *buffer, uint16_t size, void *arg); /**< 回收原存储块 */
+    void *arg;                      /**< alloc / release 的参数 */
+} ring_buffer_resize_policy_t;
+
+/**
+ * @brief 按策略检查并执行扩缩容
+ *
+ * @return true=本次发生了扩缩容
+ *
+ * @note
+ * - 周期性调用（如每 100 ms），调用上下文要求同 ring_buffer_resize()
+ * - policy 的内部记录不加锁，同一 policy 只能在一个上下文中调用
+ */
+bool ring_buffer_auto_resize(ring_buffer_t *rb, ring_buffer_resize_policy_t *policy);
+
+#endif /* RING_BUFFER_ENABLE_STATISTICS */
+
+#endif /* RING_BUFFER_ENABLE_RESIZE */
+
+/* ==================== 掉电/崩溃可恢复缓冲区 ==================== */
+
+#if RING_BUFFER_ENABLE_PERSIST
+
+#include <stddef.h>
+
+#define RING_BUFFER_PERSIST_MAGIC    0x50534252U    /**< "RBSP" */
+#define RING_BUFFER_PERSIST_VERSION  1
+
+/**
+ * @brief 持久区域头部（数据区紧随其后）
+ *
+ * @note 只含索引，不含指针；head / tail 在数据写入/读出完成后才更新
+ */
+typedef struct {
+    uint32_t magic;                 /**< RING_BUFFER_PERSIST_MAGIC */
+    uint16_t version;               /**< RING_BUFFER_PERSIST_VERSION */
+    uint16_t header_size;           /**< sizeof(ring_buffer_persist_hdr_t) */
+    uint16_t size;                  /**< 数据区大小（字节）*/
+    uint16_t size_inv;              /**< ~size，区分上电随机内容 */
+    volatile uint16_t head;         /**< 已提交的写指针 */
+    volatile uint16_t tail;         /**< 已提交的读指针 */
+    uint32_t recover_count;         /**< 成功恢复次数 */
+} ring_buffer_persist_hdr_t;
+
+/**
+ * @brief 数据区为 size 字节时所需的区域大小
+ */
+#define RING_BUFFER_PERSIST_REGION_SIZE(size)  (sizeof(ring_buffer_persist_hdr_t) + (size))
+
+/**
+ * @brief 打开结果
+ */
+typedef enum {
+    RING_BUFFER_PERSIST_ERROR = -1, /**< 参数错误 */
+    RING_BUFFER_PERSIST_NEW = 0,    /**< 区域无有效头部，已初始化为空 */
+    RING_BUFFER_PERSIST_RECOVERED   /**< 已恢复上次的可读区域 */
+} ring_buffer_persist_result_t;
+
+/**
+ * @brief 在持久区域上打开缓冲区（恢复或新建）
+ *
+ * @param rb         缓冲区控制结构（RAM 中，用户分配）
+ * @param region     持久区域起始地址（mmap 文件 / .noinit SRAM）
+ * @param region_len 区域长度，数据区大小为 region_len - 头部大小（最大 65535）
+ *
+ * @return 打开结果
+ *
+ * @note
+ * - 头部校验通过且索引在范围内时恢复 [tail, head) 为可读区域
+ * - 写入先拷贝数据、经写屏障后再更新持久 head，崩溃时可读区域只含完整数据
+ * - 打开后使用普通 ring_buffer_xxx() 接口读写，SPSC 语义同无锁模式
+ *
+ * @code
+ * __attribute__((section(".noinit")))
+ * static uint8_t blackbox_sram[RING_BUFFER_PERSIST_REGION_SIZE(4096)];
+ *
+ * if (ring_buffer_persist_open(&bb_rb, blackbox_sram, sizeof(blackbox_sram))
+ *         == RING_BUFFER_PERSIST_RECOVERED) {
+ *     dump_last_log(&bb_rb);
+ * }
+ * @endcode
+ */
+ring_buffer_persist_result_t ring_buffer_persist_open(ring_buffer_t *rb, void *region,
+                                                      size_t region_len);
+
+/**
+ * @brief 将此前的写入与索引推送到持久介质
+ *
+ * @note
+ * - RING_BUFFER_PERSIST_MSYNC = 0：仅内存屏障
+ * - RING_BUFFER_PERSIST_MSYNC = 1：屏障后 msync(MS_SYNC) 整个区域
+ */
+void ring_buffer_persist_sync(ring_buffer_t *rb);
+
+#endif /* RING_BUFFER_ENABLE_PERSIST */
+
+/* ==================== 分段缓冲区 ==================== */
+
+#if RING_BUFFER_ENABLE_SEGMENTED
+
+/**
+ * @brief 数据块
+ */
+typedef struct ring_buffer_seg_chunk {
+    struct ring_buffer_seg_chunk *next;     /**< 下一块（生产者发布）*/
+    volatile uint16_t wr;                   /**< 块内写偏移（生产者）*/
+    volatile uint16_t rd;                   /**< 块内读偏移（消费者）*/
+    uint8_t data[RING_BUFFER_SEG_CHUNK_SIZE];
+} ring_buffer_seg_chunk_t;
+
+/**
+ * @brief 块池（可由多个分段缓冲区共享）
+ */
+typedef struct {
+    ring_buffer_seg_chunk_t *free_list;     /**< 空闲块链表 */
+    volatile uint16_t free_count;           /**< 空闲块个数 */
+} ring_buffer_seg_pool_t;
+
+/**
+ * @brief 分段缓冲区上下文（由 rb->ctx 指向）
+ */
+typedef struct {
+    ring_buffer_seg_pool_t *pool;           /**< 所用块池 */
+    ring_buffer_seg_chunk_t *rd_chunk;      /**< 最旧的块（消费者）*/
+    ring_buffer_seg_chunk_t *wr_chunk;      /**< 最新的块（生产者）*/
+    volatile uint32_t written;              /**< 累计写入字节数（生产者）*/
+    volatile uint32_t read;                 /**< 累计读出字节数（消费者）*/
+    volatile uint16_t allocated;            /**< 累计取得块数（生产者，回绕计数）*/
+    volatile uint16_t released;             /**< 累计归还块数（消费者，回绕计数）*/
+    uint16_t max_chunks;                    /**< 占用块数上限，0 = 只受块池限制 */
+} ring_buffer_seg_t;
+
+/**
+ * @brief 初始化块池
+ *
+ * @param pool   块池
+ * @param chunks 块数组（用户静态分配）
+ * @param count  块个数
+ */
+void ring_buffer_seg_pool_init(ring_buffer_seg_pool_t *pool, ring_buffer_seg_chunk_t *chunks,
+                               uint16_t count);
+
+/**
+ * @brief 创建分段缓冲区
+ *
+ * @param rb         缓冲区控制结构
+ * @param seg        分段上下文（用户分配）
+ * @param pool       块池
+ * @param max_chunks 最多占用的块数，0 = 只受块池限制
+ *
+ * @return true=成功, false=块池为空
+ *
+ * @note
+ * - 创建后使用普通 ring_buffer_xxx() 接口读写，SPSC 语义同无锁模式
+ * - 不支持 CRC、文件描述符与扩缩容操作
+ *
+ * @code
+ * static ring_buffer_seg_chunk_t chunks[64];
+ * static ring_buffer_seg_pool_t pool;
+ * static ring_buffer_seg_t burst_seg;
+ * static ring_buffer_t burst_rb;
+ *
+ * ring_buffer_seg_pool_init(&pool, chunks, 64);
+ * ring_buffer_seg_create(&burst_rb, &burst_seg, &pool, 32);
+ * ring_buffer_write_multi(&burst_rb, data, len);
+ * @endcode
+ */
+bool ring_buffer_seg_create(ring_buffer_t *rb, ring_buffer_seg_t *seg,
+                            ring_buffer_seg_pool_t *pool, uint16_t max_chunks);
+
+/**
+ * @brief 销毁分段缓冲区并把所有块归还块池
+ */
+void ring_buffer_seg_destroy(ring_buffer_t *rb);
+
+#endif /* RING_BUFFER_ENABLE_SEGMENTED */
+
+/* ==================== 压缩缓冲区 ==================== */
+
+#if RING_BUFFER_ENABLE_LZ
+
+/**
+ * @brief 压缩缓冲区上下文（由 rb->ctx 指向）
+ *
+ * @note 约占 2^HASH_BITS * 2 + 4 * BLOCK_SIZE 字节，生产者与消费者的暂存区互不共享
+ */
+typedef struct {
+    uint16_t hash[1U << RING_BUFFER_LZ_HASH_BITS];  /**< 匹配查找表（生产者）*/
+    uint8_t packed[RING_BUFFER_LZ_BLOCK_SIZE];       /**< 压缩输出（生产者）*/
+    uint8_t gather[RING_BUFFER_LZ_BLOCK_SIZE];       /**< writev 拼接的原始数据（生产者）*/
+    uint8_t frame[RING_BUFFER_LZ_BLOCK_SIZE];        /**< 跨越环绕点的帧负载（消费者）*/
+    uint8_t out[RING_BUFFER_LZ_BLOCK_SIZE];          /**< 已解压未读出的数据（消费者）*/
+    uint16_t out_pos;                       /**< out 中下一个读出位置 */
+    uint16_t out_len;                       /**< out 中有效长度 */
+    volatile uint32_t raw_in;               /**< 累计写入原始字节数（生产者）*/
+    volatile uint32_t raw_out;              /**< 累计读出原始字节数（消费者）*/
+    uint32_t packed_in;                     /**< 累计占用存储区字节数，含帧头（生产者）*/
+} ring_buffer_lz_t;
+
+/**
+ * @brief 创建压缩缓冲区
+ *
+ * @param rb     缓冲区控制结构
+ * @param lz     压缩上下文（用户分配）
+ * @param buffer 存储区（保存压缩后的帧）
+ * @param size   存储区大小
+ *
+ * @return true=成功, false=参数错误
+ *
+ * @note
+ * - 创建后使用普通 ring_buffer_xxx() 接口读写，SPSC 语义同无锁模式
+ * - available() 返回原始字节数，free_space() 返回存储区剩余字节数（压缩前可写入的通常更多）
+ * - 每次写入至少占用一个帧头，单字节 ring_buffer_write() 不会被压缩
+ * - 不支持 writev/readv、CRC、文件描述符与扩缩容操作
+ * - 压缩率统计：lz->raw_in / lz->packed_in
+ * - 统计计数（RING_BUFFER_ENABLE_STATISTICS）按存储字节计，原始字节数见 lz->raw_in / lz->raw_out
+ *
+ * @code
+ * static uint8_t log_storage[2048];
+ * static ring_buffer_lz_t log_lz;
+ * static ring_buffer_t log_rb;
+ *
+ * ring_buffer_lz_create(&log_rb, &log_lz, log_storage, sizeof(log_storage));
+ * ring_buffer_write_multi(&log_rb, line, line_len);
+ * @endcode
+ */
+bool ring_buffer_lz_create(ring_buffer_t *rb, ring_buffer_lz_t *lz, uint8_t *buffer, uint16_t size);
+
+#endif /* RING_BUFFER_ENABLE_LZ */
+
+/* ==================== 加密缓冲区 ==================== */
+
+#if RING_BUFFER_ENABLE_AES
+
+/**
+ * @brief CTR 流状态（生产者、消费者各一份）
+ */
+typedef struct {
+    uint64_t off;                           /**< 流内字节偏移（不随环绕归零）*/
+    uint64_t ks_blk;                        /**< 缓存的密钥流块序号 */
+    uint8_t ks[16];                         /**< 缓存的密钥流块 */
+    bool ks_valid;                          /**< 缓存是否有效 */
+} ring_buffer_aes_stream_t;
+
+/**
+ * @brief AES-CTR 加密缓冲区上下文（由 rb->ctx 指向）
+ */
+typedef struct {
+    uint8_t round_keys[15 * 16];            /**< 轮密钥 */
+    uint8_t rounds;                         /**< 轮数：10 / 12 / 14 */
+    uint64_t iv_hi;                         /**< 初始计数器高 64 位 */
+    uint64_t iv_lo;                         /**< 初始计数器低 64 位 */
+    ring_buffer_aes_stream_t wr;            /**< 写入流（生产者）*/
+    ring_buffer_aes_stream_t rd;            /**< 读出流（消费者）*/
+} ring_buffer_aes_t;
+
+/**
+ * @brief 创建 AES-CTR 加密缓冲区
+ *
+ * @param rb      缓冲区控制结构
+ * @param aes     加密上下文（用户分配）
+ * @param buffer  存储区（只保存密文）
+ * @param size    存储区大小
+ * @param key     密钥
+ * @param key_len 密钥长度：16 / 24 / 32 字节（AES-128 / 192 / 256）
+ * @param iv      16 字节初始计数器块
+ *
+ * @return true=成功, false=参数错误或密钥长度不支持
+ *
+ * @note
+ * - 创建后使用普通 ring_buffer_xxx() 接口读写，SPSC 语义同无锁模式
+ * - 同一密钥下每个缓冲区、每次创建都必须使用不同的 IV
+ * - 不支持 CRC、文件描述符与扩缩容操作
+ *
+ * @code
+ * static uint8_t cred_storage[512];
+ * static ring_buffer_aes_t cred_aes;
+ * static ring_buffer_t cred_rb;
+ *
+ * ring_buffer_aes_create(&cred_rb, &cred_aes, cred_storage, sizeof(cred_storage),
+ *                        key, 32, iv);
+ * ring_buffer_write_multi(&cred_rb, token, token_len);
+ * @endcode
+ */
+bool ring_buffer_aes_create(ring_buffer_t *rb, ring_buffer_aes_t *aes, uint8_t *buffer,
+                            uint16_t size, const uint8_t *key, uint8_t key_len,
+                            const uint8_t iv[16]);
+
+/**
+ * @brief 擦除轮密钥与缓存的密钥流并销毁缓冲区
+ */
+void ring_buffer_aes_destroy(ring_buffer_t *rb);
+
+#endif /* RING_BUFFER_ENABLE_AES */
+
+/* ==================== 合并模式（flat combining） ==================== */
+
+#if RING_BUFFER_ENABLE_COMBINING
+
+/**
+ * @brief 读写请求槽（每个槽独占一个缓存行）
+ *
+ * state：0 = 空闲，1 = 填写中，2 = 待处理，3 = 已完成
+ */
+typedef struct {
+    volatile uint8_t state;                 /**< 请求状态 */
+    uint8_t op;                             /**< RING_BUFFER_OP_xxx */
+    uint16_t len;                           /**< 请求长度（readv/writev 为数据段数）*/
+    uint16_t ret;                           /**< 实际读写的字节数 */
+    const void *data;                       /**< 数据或数据段数组 */
+} __attribute__((aligned(RING_BUFFER_COMBINING_CACHE_LINE))) ring_buffer_combining_slot_t;
+
+/**
+ * @brief 合并模式上下文（由 rb->ctx 指向）
+ */
+typedef struct {
+    ring_buffer_combining_slot_t slot[RING_BUFFER_COMBINING_SLOTS]; /**< 请求槽 */
+    volatile uint8_t lock;                  /**< 合并者锁（0 = 空闲）*/
+    volatile uint8_t active;                /**< 用过的最大槽号 + 1（合并者扫描范围）*/
+    uint32_t batches;                       /**< 累计合并次数 */
+    uint32_t combined;                      /**< 累计处理的请求数 */
+} __attribute__((aligned(RING_BUFFER_COMBINING_CACHE_LINE))) ring_buffer_combining_t;
+
+/**
+ * @brief 创建合并模式缓冲区
+ *
+ * @param rb     缓冲区控制结构
+ * @param fc     合并上下文（用户分配）
+ * @param buffer 存储区
+ * @param size   存储区大小
+ *
+ * @return true=成功, false=参数错误
+ *
+ * @note
+ * - 读写线程把请求填入自己的槽后，由抢到合并者锁的线程一次处理所有槽中的请求，
+ *   其余线程只在自己的槽上等待；head / tail 所在缓存行只在合并者核上修改
+ * - 任意多个生产者、消费者；线程数不宜超过核数（等待为自旋）
+ * - 清空、CRC、文件描述符与扩缩容操作直接持合并者锁执行；状态查询不加锁
+ * - 平均批次大小：fc->combined / fc->batches
+ *
+ * @code
+ * static uint8_t event_storage[4096];
+ * static ring_buffer_combining_t event_fc;
+ * static ring_buffer_t event_rb;
+ *
+ * ring_buffer_combining_create(&event_rb, &event_fc, event_storage, sizeof(event_storage));
+ * ring_buffer_write_multi(&event_rb, event, event_len);    // 任意线程
+ * @endcode
+ */
+bool ring_buffer_combining_create(ring_buffer_t *rb, ring_buffer_combining_t *fc,
+                                  uint8_t *buffer, uint16_t size);
+
+#endif /* RING_BUFFER_ENABLE_COMBINING */
+
+/* ==================== 事件追踪 ==================== */
+
+#if RING_BUFFER_ENABLE_TRACE
+
+#define RING_BUFFER_TRACE_MAGIC    0x52544252u  /**< 导出文件魔数 "RBTR" */
+#define RING_BUFFER_TRACE_VERSION  1
+
+/**
+ * @brief 追踪事件（16 字节）
+ *
+ * len < req 表示写入溢出（丢弃 req - len 字节）或读出时数据不足
+ */
+typedef struct {
+    uint64_t ts;                            /**< 时间戳（RING_BUFFER_TRACE_TIMESTAMP 计数）*/
+    uint8_t ring_id;                        /**< 缓冲区追踪编号 */
+    uint8_t op;                             /**< 操作（ring_buffer_op_t）*/
+    uint16_t req;                           /**< 请求长度 */
+    uint16_t len;                           /**< 实际传输长度 */
+    uint16_t occupancy;                     /**< 操作后的数据量 */
+} ring_buffer_trace_event_t;
+
+/**
+ * @brief 导出文件头
+ *
+ * 之后是 threads 个 [块头][count 个事件]，均为本机字节序
+ */
+typedef struct {
+    uint32_t magic;                         /**< RING_BUFFER_TRACE_MAGIC */
+    uint16_t version;                       /**< RING_BUFFER_TRACE_VERSION */
+    uint16_t event_size;                    /**< sizeof(ring_buffer_trace_event_t) */
+    uint32_t ticks_per_us;                  /**< 时间戳每微秒计数 */
+    uint32_t threads;                       /**< 线程块个数 */
+} ring_buffer_trace_file_hdr_t;
+
+/**
+ * @brief 导出文件中的线程块头
+ */
+typedef struct {
+    uint32_t thread;                        /**< 追踪缓冲区序号（线程退出后由之后的线程复用）*/
+    uint32_t count;                         /**< 本块事件数（按时间先后）*/
+    uint32_t lost;                          /**< 被覆盖的旧事件数 */
+} ring_buffer_trace_block_hdr_t;
+
+/**
+ * @brief 导出数据的输出回调（写文件、串口发送等）
+ */
+typedef void (*ring_buffer_trace_sink_t)(const void *data, size_t len, void *arg);
+
+/**
+ * @brief 设置缓冲区的追踪编号
+ *
+ * @param id 1 ~ 255 开始记录，0 停止记录该缓冲区
+ */
+void ring_buffer_trace_set_id(ring_buffer_t *rb, uint8_t id);
+
+/**
+ * @brief 归还本线程的追踪缓冲区，供之后创建的线程使用
+ *
+ * 频繁创建 / 销毁线程时在线程退出前调用；已记录的事件保留到下次导出，
+ * 之后领取该缓冲区的线程的事件接在其后。未调用时缓冲区一直归该线程所有
+ */
+void ring_buffer_trace_thread_exit(void);
+
+/**
+ * @brief 开始 / 停止记录（全局，默认停止）
+ */
+void ring_buffer_trace_start(void);
+void ring_buffer_trace_stop(void);
+
+/**
+ * @brief 清空所有线程的追踪缓冲区
+ *
+ * @warning 须在停止记录后调用
+ */
+void ring_buffer_trace_reset(void);
+
+/**
+ * @brief 导出所有线程的追踪缓冲区
+ *
+ * @param sink 输出回调，按顺序收到文件头、各线程块头与事件
+ * @param arg  回调参数
+ *
+ * @return 导出的事件总数
+ *
+ * @note 只导出已写完的事件；记录进行中导出时，线程在导出期间写满一圈会覆盖
+ *       最旧的事件，需要完整结果时先停止记录
+ *
+ * @code
+ * static void to_file(const void *data, size_t len, void *arg)
+ * {
+ *     fwrite(data, 1, len, (FILE *)arg);
+ * }
+ *
+ * ring_buffer_trace_set_id(&uart_rx_rb, 1);
+ * ring_buffer_trace_start();
+ * ...
+ * ring_buffer_trace_stop();
+ * ring_buffer_trace_dump(to_file, fp);   // 再用 ring_buffer_trace2json 转换
+ * @endcode
+ */
+uint32_t ring_buffer_trace_dump(ring_buffer_trace_sink_t sink, void *arg);
+
+#endif /* RING_BUFFER_ENABLE_TRACE */
+
+/* ==================== 多缓冲区选择器 ==================== */
+
+#if RING_BUFFER_ENABLE_RING_SET
+
+/**
+ * @brief 就绪缓冲区的取出顺序
+ */
+typedef enum {
+    RING_BUFFER_SET_PRIORITY = 0,   /**< 位号小者优先（先加入的优先级高）*/
+    RING_BUFFER_SET_ROUND_ROBIN     /**< 从上次取出的下一个开始轮询 */
+} ring_buffer_set_order_t;
+
+/**
+ * @brief 多缓冲区选择器
+ *
+ * @note
+ * - 生产者侧只在缓冲区由空变为非空时原子置位，并调用 signal
+ * - 消费者侧只在缓冲区看似为空时才清除位，之后再次确认，不会丢失唤醒
+ */
+typedef struct ring_buffer_set {
+    volatile uint32_t ready;                            /**< 就绪位图 */
+    ring_buffer_t *rings[RING_BUFFER_SET_MAX_RINGS];    /**< 按位号索引 */
+    uint8_t count;                                      /**< 已用位号上限 */
+    uint8_t order;                                      /**< ring_buffer_set_order_t */
+    uint8_t rr_next;                                    /**< 轮询起点 */
+    void (*signal)(void *arg);                          /**< 唤醒消费者（可在 ISR 中调用）*/
+    bool (*wait)(void *arg, uint32_t timeout_ms);       /**< 阻塞等待 signal，超时返回 false */
+    void *arg;                                          /**< signal / wait 的参数 */
+} ring_buffer_set_t;
+
+/**
+ * @brief 初始化选择器
+ */
+void ring_buffer_set_init(ring_buffer_set_t *set, ring_buffer_set_order_t order);
+
+/**
+ * @brief 设置阻塞等待接口（可选）
+ *
+ * @param signal 生产者在缓冲区由空变为非空时调用，须可在 ISR 中使用
+ * @param wait   ring_buffer_set_wait() 中阻塞等待 signal
+ * @param arg    传给 signal / wait 的参数（如二值信号量句柄）
+ *
+ * @code
+ * static void set_signal(void *arg)
+ * {
+ *     BaseType_t woken = pdFALSE;
+ *     xSemaphoreGiveFromISR((SemaphoreHandle_t)arg, &woken);
+ *     portYIELD_FROM_ISR(woken);
+ * }
+ *
+ * static bool set_wait(void *arg, uint32_t timeout_ms)
+ * {
+ *     return xSemaphoreTake((SemaphoreHandle_t)arg, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+ * }
+ * @endcode
+ */
+void ring_buffer_set_waiter(ring_buffer_set_t *set, void (*signal)(void *arg),
+                            bool (*wait)(void *arg, uint32_t timeout_ms), void *arg);
+
+/**
+ * @brief 加入缓冲区
+ *
+ * @return 位号（优先级模式下即优先级，0 最高），失败返回 -1
+ *
+ * @note 须在生产者开始写入前加入；一个缓冲区只能属于一个选择器
+ */
+int ring_buffer_set_add(ring_buffer_set_t *set, ring_buffer_t *rb);
+
+/**
+ * @brief 移出缓冲区
+ */
+void ring_buffer_set_remove(ring_buffer_set_t *set, ring_buffer_t *rb);
+
+/**
+ * @brief 取出一个就绪缓冲区（非阻塞）
+ *
+ * @return 有数据的缓冲区，无则返回 NULL
+ *
+ * @note 消费者可只读出部分数据，剩余数据下次仍会被取到
+ *
+ * @code
+ * ring_buffer_t *rb;
+ * while ((rb = ring_buffer_set_next(&rx_set)) != NULL) {
+ *     n = ring_buffer_read_multi(rb, buf, sizeof(buf));
+ *     dispatch(rb, buf, n);
+ * }
+ * @endcode
+ */
+ring_buffer_t *ring_buffer_set_next(ring_buffer_set_t *set);
+
+/**
+ * @brief 等待任一缓冲区就绪
+ *
+ * @param set        选择器
+ * @param timeout_ms 每次阻塞的超时（未设置 wait 接口时不阻塞）
+ *
+ * @return 有数据的缓冲区，超时返回 NULL
+ */
+ring_buffer_t *ring_buffer_set_wait(ring_buffer_set_t *set, uint32_t timeout_ms);
+
+#endif /* RING_BUFFER_ENABLE_RING_SET */
+
+/* ==================== 优先级缓冲区组 ==================== */
+
+#if RING_BUFFER_ENABLE_GROUP
+
+/**
+ * @brief 组成员
+ */
+typedef struct {
+    ring_buffer_t *rb;              /**< 缓冲区（任意策略）*/
+    uint16_t quota;                 /**< 每轮最多读出字节数，0 = 不限（严格优先）*/
+    uint16_t credit;                /**< 本轮剩余额度 */
+} ring_buffer_group_member_t;
+
+/**
+ * @brief 优先级缓冲区组
+ *
+ * @note
+ * - 成员按加入顺序排列优先级，先加入者优先级高
+ * - 每轮中高优先级成员先用完自己的配额，再轮到低优先级成员
+ * - 所有有数据的成员都用完配额后开始新一轮
+ */
+typedef struct {
+    ring_buffer_group_member_t members[RING_BUFFER_GROUP_MAX_RINGS];
+    uint8_t count;                  /**< 成员个数 */
+} ring_buffer_group_t;
+
+/**
+ * @brief 初始化缓冲区组
+ */
+void ring_buffer_group_init(ring_buffer_group_t *group);
+
+/**
+ * @brief 加入缓冲区（按优先级从高到低依次加入）
+ *
+ * @param group 缓冲区组
+ * @param rb    缓冲区
+ * @param quota 每轮配额（字节），0 = 不限
+ *
+ * @return 成员编号（0 优先级最高），失败返回 -1
+ */
+int ring_buffer_group_add(ring_buffer_group_t *group, ring_buffer_t *rb, uint16_t quota);
+
+/**
+ * @brief 按优先级与配额读取数据
+ *
+ * @param group 缓冲区组
+ * @param data  数据缓冲区
+ * @param len   最大读取长度
+ * @param src   输出：数据来源的成员编号（可为 NULL）
+ *
+ * @return 实际读取字节数，所有成员为空时返回 0
+ *
+ * @note 每次调用只从一个成员读出，不会把不同缓冲区的数据拼在一起
+ *
+ * @code
+ * ring_buffer_group_init(&rx_group);
+ * ring_buffer_group_add(&rx_group, &ctrl_rb, 64);     // 控制消息，每轮 64 字节
+ * ring_buffer_group_add(&rx_group, &telemetry_rb, 16); // 遥测，每轮 16 字节
+ *
+ * int src;
+ * uint16_t n = ring_buffer_group_read(&rx_group, buf, sizeof(buf), &src);
+ * @endcode
+ */
+uint16_t ring_buffer_group_read(ring_buffer_group_t *group, uint8_t *data, uint16_t len, int *src);
+
+#endif /* RING_BUFFER_ENABLE_GROUP */
+
+/* ==================== 分片缓冲区（多生产者单消费者） ==================== */
+
+#if RING_BUFFER_ENABLE_SHARD
+
+/**
+ * @brief 消费者合并顺序
+ */
+typedef enum {
+    RING_BUFFER_SHARD_ROUND_ROBIN = 0,  /**< 从上次读出的分片之后轮询 */
+    RING_BUFFER_SHARD_TIMESTAMP         /**< 取各分片首条记录中时间戳最小者 */
+} ring_buffer_shard_order_t;
+
+/**
+ * @brief 分片（控制结构独占缓存行）
+ */
+typedef struct {
+    ring_buffer_t rb;                       /**< 无锁 SPSC 缓冲区 */
+} __attribute__((aligned(RING_BUFFER_SHARD_CACHE_LINE))) ring_buffer_shard_t;
+
+/**
+ * @brief 分片缓冲区
+ *
+ * @note
+ * - 每条记录为 [负载长度 u16][时间戳 u64][负载]，整条写入或不写
+ * - 同一分片内的记录按写入顺序读出；时间戳顺序只在已写入的记录之间成立，
+ *   之后写入的更早时间戳不会排到已读出的记录之前
+ */
+typedef struct {
+    ring_buffer_shard_t shard[RING_BUFFER_SHARD_MAX]; /**< 分片 */
+    uint8_t count;                          /**< 分片数 */
+    uint8_t next;                           /**< 下一个轮询起点（消费者）*/
+    volatile uint8_t claimed;               /**< 已由 ring_buffer_shard_claim() 分配的分片数 */
+    ring_buffer_shard_order_t order;        /**< 合并顺序 */
+} ring_buffer_sharded_t;
+
+/**
+ * @brief 初始化分片缓冲区
+ *
+ * @param sh         分片缓冲区（用户分配）
+ * @param storage    存储区，依次切分为 count 个 shard_size 字节的分片
+ * @param shard_size 每个分片的存储区大小（建议为缓存行的整数倍）
+ * @param count      分片数（1 ~ RING_BUFFER_SHARD_MAX）
+ * @param order      消费者合并顺序
+ *
+ * @return true=成功, false=参数错误
+ */
+bool ring_buffer_shard_init(ring_buffer_sharded_t *sh, uint8_t *storage, uint16_t shard_size,
+                            uint8_t count, ring_buffer_shard_order_t order);
+
+/**
+ * @brief 为调用线程分配一个分片（线程启动时调用一次）
+ *
+ * @return 分片缓冲区，已全部分配时返回 NULL
+ *
+ * @note 按核号等固定编号选择分片时直接使用 &sh->shard[i].rb
+ */
+ring_buffer_t *ring_buffer_shard_claim(ring_buffer_sharded_t *sh);
+
+/**
+ * @brief 向分片写入一条记录（仅该分片的生产者调用）
+ *
+ * @param shard 分片缓冲区
+ * @param ts    时间戳（同一分片内应单调不减，轮询顺序下可为 0）
+ * @param data  负载
+ * @param len   负载长度（> 0）
+ *
+ * @return true=成功, false=空间不足（不写入任何数据）
+ */
+bool ring_buffer_shard_write(ring_buffer_t *shard, uint64_t ts, const void *data, uint16_t len);
+
+/**
+ * @brief 按合并顺序读出一条记录（单消费者）
+ *
+ * @param sh   分片缓冲区
+ * @param data 负载缓冲区
+ * @param len  缓冲区长度，记录更长时截断，多余部分丢弃
+ * @param src  输出：来源分片编号（可为 NULL）
+ * @param ts   输出：记录时间戳（可为 NULL）
+ *
+ * @return 读出的负载字节数，所有分片为空时返回 0
+ *
+ * @code
+ * ring_buffer_shard_init(&events, storage, 4096, 4, RING_BUFFER_SHARD_TIMESTAMP);
+ *
+ * // 生产者线程
+ * ring_buffer_t *mine = ring_buffer_shard_claim(&events);
+ * ring_buffer_shard_write(mine, now_ns(), &ev, sizeof(ev));
+ *
+ * // 消费者线程
+ * uint16_t n = ring_buffer_shard_read(&events, buf, sizeof(buf), &src, &ts);
+ * @endcode
+ */
+uint16_t ring_buffer_shard_read(ring_buffer_sharded_t *sh, void *data, uint16_t len,
+                                int *src, uint64_t *ts);
+
+#endif /* RING_BUFFER_ENABLE_SHARD */
+
 /* ==================== 扩展机制 ==================== */
 
 /**
@@ -200,10 +1224,12 @@ void ring_buffer_clear(ring_buffer_t *rb);
  * @param type 策略类型（>= RING_BUFFER_TYPE_CUSTOM_BASE）
  * @param ops  操作接口指针
  * 
- * @return true=成功, false=失败
+ * @return true=成功, false=失败（类型超出 RING_BUFFER_MAX_CUSTOM_OPS 范围或已被注册）
  * 
  * @note 
  * - 用于扩展新的线程安全策略
+ * - 注册表按类型直接索引，创建时查找为 O(1)
+ * - 可在多个线程中并发注册，同一类型只有一个调用成功
  * - 详见 README.md "扩展指南"
  * 
  * @code
@@ -214,6 +1240,18 @@ void ring_buffer_clear(ring_buffer_t *rb);
  */
 bool ring_buffer_register_ops(ring_buffer_type_t type, const struct ring_buffer_ops *ops);
 
+/**
+ * @brief 注销自定义策略
+ *
+ * @param type 策略类型
+ *
+ * @return true=成功, false=该类型未注册
+ *
+ * @note 只影响之后的 ring_buffer_create()；已创建的缓冲区仍持有原操作接口，
+ *       在它们销毁前 ops 指向的结构体必须保持有效
+ */
+bool ring_buffer_unregister_ops(ring_buffer_type_t type);
+
 /**
  * @brief 获取操作接口指针（性能关键场景）
  * 
@@ -236,6 +1274,366 @@ static inline const struct ring_buffer_ops* ring_buffer_get_ops(const ring_buffe
     return (rb ? rb->ops : NULL);
 }
 
+/* ==================== 文件描述符 I/O（POSIX） ==================== */
+
+#if RING_BUFFER_ENABLE_FD_IO
+
+/**
+ * @brief 从文件描述符直接读入缓冲区
+ *
+ * @param rb  缓冲区指针
+ * @param fd  文件描述符（socket、管道、文件等）
+ * @param max 最多读入的字节数
+ *
+ * @return 读入的字节数；0 表示对端关闭（EOF）或缓冲区已满；-1 表示出错（见 errno）
+ *
+ * @note
+ * - 对缓冲区中的一段或两段空闲区域执行一次 readv()，按实际读入量推进 head
+ * - 缓冲区已满时不发起系统调用，可用 ring_buffer_is_full() 区分
+ * - 互斥锁模式在系统调用期间持有互斥锁，请使用非阻塞 fd
+ *
+ * @code
+ * // socket → 缓冲区，无需中间栈缓冲区
+ * ssize_t n = ring_buffer_fill_from_fd(&bridge_rb, sock, 0xFFFF);
+ * @endcode
+ */
+ssize_t ring_buffer_fill_from_fd(ring_buffer_t *rb, int fd, uint16_t max);
+
+/**
+ * @brief 将缓冲区数据直接写到文件描述符
+ *
+ * @return 写出的字节数；0 表示缓冲区为空；-1 表示出错（见 errno）
+ *
+ * @note 对一段或两段可读区域执行一次 writev()，按实际写出量推进 tail
+ */
+ssize_t ring_buffer_drain_to_fd(ring_buffer_t *rb, int fd, uint16_t max);
+
+#endif /* RING_BUFFER_ENABLE_FD_IO */
+
+/* ==================== 零拷贝发送（Linux） ==================== */
+
+#if RING_BUFFER_ENABLE_ZEROCOPY
+
+#include <sys/types.h>
+
+/**
+ * @brief 零拷贝发送上下文
+ *
+ * @note
+ * - 每个 socket 一个，由 ring_buffer_zc_init() 初始化
+ * - 该 socket 上的所有 MSG_ZEROCOPY 发送都必须经由本上下文，
+ *   否则内核通知序号与在途记录无法对应
+ */
+typedef struct {
+    int fd;                                         /**< socket 描述符 */
+    uint32_t done_id;                               /**< 最早未确认发送的通知序号 */
+    uint16_t sent;                                  /**< 已发送未确认的字节数（位于 tail 之后）*/
+    uint8_t inflight;                               /**< 在途发送次数 */
+    uint8_t first;                                  /**< 在途队列头 */
+    uint16_t lens[RING_BUFFER_ZC_MAX_INFLIGHT];     /**< 各次在途发送的字节数 */
+} ring_buffer_zc_t;
+
+/**
+ * @brief 初始化零拷贝上下文并为 socket 开启 SO_ZEROCOPY
+ *
+ * @return true=成功, false=内核或协议不支持
+ */
+bool ring_buffer_zc_init(ring_buffer_zc_t *zc, int sockfd);
+
+/**
+ * @brief 零拷贝发送可读数据（不推进 tail）
+ *
+ * @param rb  缓冲区指针（无锁模式，调用者为唯一消费者）
+ * @param zc  零拷贝上下文
+ * @param max 最多发送的字节数
+ *
+ * @return 提交给内核的字节数；0 表示无新数据或在途次数已满；-1 表示出错（见 errno）
+ *
+ * @note 已发送的数据仍占用缓冲区空间，直到 ring_buffer_zc_reap() 确认
+ */
+ssize_t ring_buffer_zc_send(ring_buffer_t *rb, ring_buffer_zc_t *zc, uint16_t max);
+
+/**
+ * @brief 回收内核完成通知，推进 tail
+ *
+ * @return 本次释放的字节数
+ *
+ * @note 非阻塞；可在 poll() 报告 POLLERR 后调用，或在每轮发送前调用
+ *
+ * @code
+ * for (;;) {
+ *     ring_buffer_zc_reap(&tx_rb, &tx_zc);
+ *     ring_buffer_zc_send(&tx_rb, &tx_zc, 0xFFFF);
+ *     poll(&pfd, 1, -1);
+ * }
+ * @endcode
+ */
+uint16_t ring_buffer_zc_reap(ring_buffer_t *rb, ring_buffer_zc_t *zc);
+
+#endif /* RING_BUFFER_ENABLE_ZEROCOPY */
+
+/* ==================== io_uring 异步引擎（Linux） ==================== */
+
+#if RING_BUFFER_ENABLE_IO_URING
+
+#include <stddef.h>
+#include <sys/uio.h>
+
+/**
+ * @brief 数据搬运方向
+ */
+typedef enum {
+    RING_BUFFER_URING_FILL = 0,     /**< fd → 缓冲区（引擎为生产者）*/
+    RING_BUFFER_URING_DRAIN         /**< 缓冲区 → fd（引擎为消费者）*/
+} ring_buffer_uring_dir_t;
+
+/**
+ * @brief 引擎中的一个缓冲区
+ */
+typedef struct {
+    ring_buffer_t *rb;              /**< 缓冲区（无锁模式）*/
+    int fd;                         /**< 文件、管道或 socket */
+    uint8_t dir;                    /**< ring_buffer_uring_dir_t */
+    bool busy;                      /**< 有在途请求 */
+    bool eof;                       /**< FILL 方向读到文件末尾 / 对端关闭 */
+    int err;                        /**< 最近一次错误（负 errno），0 = 无 */
+    struct iovec iov[2];            /**< 在途请求的区段，完成前须保持有效 */
+} ring_buffer_uring_slot_t;
+
+/**
+ * @brief io_uring 引擎
+ *
+ * @note 字段由引擎内部维护，用户只需静态分配
+ */
+typedef struct {
+    int ring_fd;                    /**< io_uring 实例描述符 */
+    unsigned sq_entries;            /**< 提交队列深度 */
+    unsigned *sq_head;              /**< 以下为内核共享队列映射 */
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    void *sqes;
+    void *cqes;
+    void *sq_map;
+    void *cq_map;
+    size_t sq_map_len;
+    size_t cq_map_len;
+    size_t sqes_len;
+    uint8_t slot_count;             /**< 已加入的缓冲区个数 */
+    uint8_t inflight;               /**< 在途请求数 */
+    ring_buffer_uring_slot_t slots[RING_BUFFER_URING_MAX_RINGS];
+} ring_buffer_uring_t;
+
+/**
+ * @brief 初始化 io_uring 引擎
+ *
+ * @param eng     引擎（用户分配）
+ * @param entries 队列深度，建议 >= 缓冲区个数
+ *
+ * @return true=成功, false=内核不支持或资源不足
+ */
+bool ring_buffer_uring_init(ring_buffer_uring_t *eng, unsigned entries);
+
+/**
+ * @brief 加入一个缓冲区
+ *
+ * @param eng 引擎
+ * @param rb  缓冲区（无锁模式；引擎占据 FILL 的生产者侧或 DRAIN 的消费者侧）
+ * @param fd  文件描述符（文件从当前偏移读写）
+ * @param dir 搬运方向
+ *
+ * @return 槽位编号，失败返回 -1
+ */
+int ring_buffer_uring_add(ring_buffer_uring_t *eng, ring_buffer_t *rb, int fd,
+                          ring_buffer_uring_dir_t dir);
+
+/**
+ * @brief 运行一轮：为所有有事可做的缓冲区提交请求并回收完成结果
+ *
+ * @param eng  引擎
+ * @param wait true=无完成结果时阻塞等待至少一个
+ *
+ * @return 本轮处理的完成数，出错返回 -1
+ *
+ * @note 每轮只有一次 io_uring_enter() 系统调用，与缓冲区个数无关
+ *
+ * @code
+ * while (running) {
+ *     ring_buffer_uring_run(&eng, true);
+ * }
+ * @endcode
+ */
+int ring_buffer_uring_run(ring_buffer_uring_t *eng, bool wait);
+
+/**
+ * @brief 释放引擎
+ *
+ * @note 须在无在途请求时调用（如 ring_buffer_uring_run() 直至 inflight == 0）
+ */
+void ring_buffer_uring_deinit(ring_buffer_uring_t *eng);
+
+#endif /* RING_BUFFER_ENABLE_IO_URING */
+
+/* ==================== 共享内存进程间缓冲区（Linux） ==================== */
+
+#if RING_BUFFER_ENABLE_SHM
+
+#include <stddef.h>
+
+#define RING_BUFFER_SHM_MAGIC    0x48534252U    /**< "RBSH" */
+#define RING_BUFFER_SHM_VERSION  1
+
+/**
+ * @brief 共享内存头部（位于映射起始处）
+ *
+ * @note
+ * - 只保存偏移量与索引，不含任何指针，各进程映射地址可以不同
+ * - head 仅由生产者写，tail 仅由消费者写，两者分处不同缓存行
+ * - magic 最后写入，attach 看到 magic 即表示头部已初始化完成
+ */
+typedef struct {
+    uint32_t magic;             /**< RING_BUFFER_SHM_MAGIC */
+    uint16_t version;           /**< RING_BUFFER_SHM_VERSION */
+    uint16_t header_size;       /**< sizeof(ring_buffer_shm_hdr_t) */
+    uint32_t size;              /**< 数据区大小（字节），可用容量为 size - 1 */
+    uint32_t data_offset;       /**< 数据区相对头部的偏移 */
+    uint8_t pad0[RING_BUFFER_SHM_CACHE_LINE - 16];
+    uint32_t head;              /**< 写指针（生产者）*/
+    uint8_t pad1[RING_BUFFER_SHM_CACHE_LINE - 4];
+    uint32_t tail;              /**< 读指针（消费者）*/
+    uint8_t pad2[RING_BUFFER_SHM_CACHE_LINE - 4];
+} ring_buffer_shm_hdr_t;
+
+/**
+ * @brief 进程内句柄（每个进程各自持有）
+ */
+typedef struct {
+    ring_buffer_shm_hdr_t *hdr; /**< 映射起始地址 */
+    uint8_t *data;              /**< 本进程中的数据区地址 */
+    uint32_t size;              /**< 数据区大小（attach 时校验后缓存）*/
+    uint32_t cached_head;       /**< 消费者缓存的对端 head */
+    uint32_t cached_tail;       /**< 生产者缓存的对端 tail */
+    size_t map_len;             /**< 映射长度 */
+} ring_buffer_shm_t;
+
+/**
+ * @brief 在共享内存对象上创建缓冲区
+ *
+ * @param shm  句柄（用户分配）
+ * @param fd   shm_open() / memfd_create() 返回的描述符
+ * @param size 数据区大小（字节）
+ *
+ * @return true=成功, false=失败
+ *
+ * @note 会将 fd 截断为头部 + 数据区大小，原有内容丢弃
+ *
+ * @code
+ * int fd = shm_open("/uart_rx", O_CREAT | O_RDWR, 0600);
+ * ring_buffer_shm_create(&rx_shm, fd, 1 << 20);
+ * @endcode
+ */
+bool ring_buffer_shm_create(ring_buffer_shm_t *shm, int fd, uint32_t size);
+
+/**
+ * @brief 连接已创建的缓冲区
+ *
+ * @return true=成功, false=映射失败或 magic / 版本 / 大小校验不通过
+ */
+bool ring_buffer_shm_attach(ring_buffer_shm_t *shm, int fd);
+
+/**
+ * @brief 解除本进程映射（不影响其他进程）
+ */
+void ring_buffer_shm_detach(ring_buffer_shm_t *shm);
+
+/**
+ * @brief 写入数据（生产者进程）
+ *
+ * @return 实际写入字节数
+ */
+uint32_t ring_buffer_shm_write(ring_buffer_shm_t *shm, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief 读取数据（消费者进程）
+ *
+ * @return 实际读取字节数
+ */
+uint32_t ring_buffer_shm_read(ring_buffer_shm_t *shm, uint8_t *data, uint32_t len);
+
+/**
+ * @brief 获取可读数据量
+ */
+uint32_t ring_buffer_shm_available(const ring_buffer_shm_t *shm);
+
+/**
+ * @brief 获取剩余空间
+ */
+uint32_t ring_buffer_shm_free_space(const ring_buffer_shm_t *shm);
+
+#endif /* RING_BUFFER_ENABLE_SHM */
+
+/* ==================== 存储分配（Linux） ==================== */
+
+#if RING_BUFFER_ENABLE_LINUX_STORAGE
+
+#include <stddef.h>
+
+/**
+ * @brief 存储分配标志
+ */
+#define RING_BUFFER_STORAGE_HUGETLB   (1U << 0)  /**< 优先使用大页，失败时回退普通页 */
+#define RING_BUFFER_STORAGE_PREFAULT  (1U << 1)  /**< 创建时预先触发缺页 */
+
+/**
+ * @brief 存储描述符
+ *
+ * @note 由 ring_buffer_storage_alloc() 填写，释放时原样传回
+ */
+typedef struct {
+    uint8_t *buffer;    /**< 数据存储空间（传给 ring_buffer_create）*/
+    uint16_t size;      /**< 请求的缓冲区大小（字节）*/
+    size_t map_len;     /**< 实际映射长度（字节）*/
+    uint32_t flags;     /**< 实际生效的分配标志 */
+} ring_buffer_storage_t;
+
+/**
+ * @brief 分配缓冲区存储空间（Linux 主机）
+ *
+ * @param st        存储描述符（用户分配）
+ * @param size      缓冲区大小（字节）
+ * @param numa_node NUMA 节点号，-1 表示不绑定
+ * @param flags     RING_BUFFER_STORAGE_xxx 组合
+ *
+ * @return true=成功, false=失败
+ *
+ * @note
+ * - 大页不可用时自动回退普通页，st->flags 反映实际结果
+ * - NUMA 绑定在预缺页之前完成，保证物理页落在目标节点
+ *
+ * @code
+ * static ring_buffer_storage_t cap_st;
+ * static ring_buffer_t cap_rb;
+ *
+ * ring_buffer_storage_alloc(&cap_st, 65535, 1,
+ *                           RING_BUFFER_STORAGE_HUGETLB | RING_BUFFER_STORAGE_PREFAULT);
+ * ring_buffer_create(&cap_rb, cap_st.buffer, cap_st.size, RING_BUFFER_TYPE_LOCKFREE);
+ * @endcode
+ */
+bool ring_buffer_storage_alloc(ring_buffer_storage_t *st, uint16_t size,
+                               int numa_node, uint32_t flags);
+
+/**
+ * @brief 释放缓冲区存储空间
+ *
+ * @note 须先 ring_buffer_destroy() 再释放
+ */
+void ring_buffer_storage_free(ring_buffer_storage_t *st);
+
+#endif /* RING_BUFFER_ENABLE_LINUX_STORAGE */
+
 #ifdef __cplusplus
 }
 #endif
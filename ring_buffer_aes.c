@@ -0,0 +1,607 @@
+/**
+ * @file    ring_buffer_aes.c
+ * @brief   环形缓冲区 AES-CTR 加密实现
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 缓冲区保存凭据、密钥协商报文等敏感数据，存储区可能被其他进程/调试器读取
+ * - 存储区中只有密文，明文只出现在调用者的缓冲区中
+ *
+ * 实现方式：
+ * - AES-128/192/256 CTR 模式，计数器块 = IV + 块序号（128 位大端加法）
+ * - 块序号取自写入/读出流的绝对字节偏移，环绕后计数器继续递增，不会重用密钥流
+ * - 拷贝与异或融合：写入时明文异或密钥流后直接写入存储区，读出时反之
+ * - 生产者与消费者各自缓存当前不完整块的密钥流，单字节读写不重复加密
+ *
+ * 硬件加速（编译期选择）：
+ * - x86 AES-NI（-maes）：4 个计数器块交错加密
+ * - ARMv8 Crypto 扩展（-march=armv8-a+crypto）
+ * - 其他平台使用查表实现（S 盒 256 字节 + 轮函数表 1 KB）
+ *
+ * @warning SPSC 语义同无锁模式；同一密钥下 IV 不得重复使用（包括重启后）
+ */
+
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_AES
+
+#if defined(__AES__) && defined(__SSE2__)
+#include <wmmintrin.h>
+#define AES_HW_NI     1
+#elif defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO)
+#include <arm_neon.h>
+#define AES_HW_ARMV8  1
+#endif
+
+/* 复用无锁实现的内部逻辑 */
+extern const struct ring_buffer_ops ring_buffer_lockfree_ops;
+
+/* Private defines -----------------------------------------------------------*/
+
+#define AES_BLOCK    16
+#define AES_BATCH    8      /**< 一次生成的密钥流块数 */
+
+/* Private constants ---------------------------------------------------------*/
+
+static const uint8_t aes_sbox[256] = {
+    0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+    0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+    0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+    0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+    0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+    0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+    0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+    0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+    0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+    0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+    0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+    0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+    0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+    0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+    0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+    0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16,
+};
+
+#if !defined(AES_HW_NI) && !defined(AES_HW_ARMV8)
+/**
+ * @brief 轮函数查找表：SubBytes + MixColumns 的第 0 行贡献（小端打包的列）
+ *
+ * 第 1~3 行的贡献为该值循环左移 8 / 16 / 24 位，共 1 KB
+ */
+static const uint32_t aes_te0[256] = {
+    0xA56363C6, 0x847C7CF8, 0x997777EE, 0x8D7B7BF6, 0x0DF2F2FF, 0xBD6B6BD6, 0xB16F6FDE, 0x54C5C591,
+    0x50303060, 0x03010102, 0xA96767CE, 0x7D2B2B56, 0x19FEFEE7, 0x62D7D7B5, 0xE6ABAB4D, 0x9A7676EC,
+    0x45CACA8F, 0x9D82821F, 0x40C9C989, 0x877D7DFA, 0x15FAFAEF, 0xEB5959B2, 0xC947478E, 0x0BF0F0FB,
+    0xECADAD41, 0x67D4D4B3, 0xFDA2A25F, 0xEAAFAF45, 0xBF9C9C23, 0xF7A4A453, 0x967272E4, 0x5BC0C09B,
+    0xC2B7B775, 0x1CFDFDE1, 0xAE93933D, 0x6A26264C, 0x5A36366C, 0x413F3F7E, 0x02F7F7F5, 0x4FCCCC83,
+    0x5C343468, 0xF4A5A551, 0x34E5E5D1, 0x08F1F1F9, 0x937171E2, 0x73D8D8AB, 0x53313162, 0x3F15152A,
+    0x0C040408, 0x52C7C795, 0x65232346, 0x5EC3C39D, 0x28181830, 0xA1969637, 0x0F05050A, 0xB59A9A2F,
+    0x0907070E, 0x36121224, 0x9B80801B, 0x3DE2E2DF, 0x26EBEBCD, 0x6927274E, 0xCDB2B27F, 0x9F7575EA,
+    0x1B090912, 0x9E83831D, 0x742C2C58, 0x2E1A1A34, 0x2D1B1B36, 0xB26E6EDC, 0xEE5A5AB4, 0xFBA0A05B,
+    0xF65252A4, 0x4D3B3B76, 0x61D6D6B7, 0xCEB3B37D, 0x7B292952, 0x3EE3E3DD, 0x712F2F5E, 0x97848413,
+    0xF55353A6, 0x68D1D1B9, 0x00000000, 0x2CEDEDC1, 0x60202040, 0x1FFCFCE3, 0xC8B1B179, 0xED5B5BB6,
+    0xBE6A6AD4, 0x46CBCB8D, 0xD9BEBE67, 0x4B393972, 0xDE4A4A94, 0xD44C4C98, 0xE85858B0, 0x4ACFCF85,
+    0x6BD0D0BB, 0x2AEFEFC5, 0xE5AAAA4F, 0x16FBFBED, 0xC5434386, 0xD74D4D9A, 0x55333366, 0x94858511,
+    0xCF45458A, 0x10F9F9E9, 0x06020204, 0x817F7FFE, 0xF05050A0, 0x443C3C78, 0xBA9F9F25, 0xE3A8A84B,
+    0xF35151A2, 0xFEA3A35D, 0xC0404080, 0x8A8F8F05, 0xAD92923F, 0xBC9D9D21, 0x48383870, 0x04F5F5F1,
+    0xDFBCBC63, 0xC1B6B677, 0x75DADAAF, 0x63212142, 0x30101020, 0x1AFFFFE5, 0x0EF3F3FD, 0x6DD2D2BF,
+    0x4CCDCD81, 0x140C0C18, 0x35131326, 0x2FECECC3, 0xE15F5FBE, 0xA2979735, 0xCC444488, 0x3917172E,
+    0x57C4C493, 0xF2A7A755, 0x827E7EFC, 0x473D3D7A, 0xAC6464C8, 0xE75D5DBA, 0x2B191932, 0x957373E6,
+    0xA06060C0, 0x98818119, 0xD14F4F9E, 0x7FDCDCA3, 0x66222244, 0x7E2A2A54, 0xAB90903B, 0x8388880B,
+    0xCA46468C, 0x29EEEEC7, 0xD3B8B86B, 0x3C141428, 0x79DEDEA7, 0xE25E5EBC, 0x1D0B0B16, 0x76DBDBAD,
+    0x3BE0E0DB, 0x56323264, 0x4E3A3A74, 0x1E0A0A14, 0xDB494992, 0x0A06060C, 0x6C242448, 0xE45C5CB8,
+    0x5DC2C29F, 0x6ED3D3BD, 0xEFACAC43, 0xA66262C4, 0xA8919139, 0xA4959531, 0x37E4E4D3, 0x8B7979F2,
+    0x32E7E7D5, 0x43C8C88B, 0x5937376E, 0xB76D6DDA, 0x8C8D8D01, 0x64D5D5B1, 0xD24E4E9C, 0xE0A9A949,
+    0xB46C6CD8, 0xFA5656AC, 0x07F4F4F3, 0x25EAEACF, 0xAF6565CA, 0x8E7A7AF4, 0xE9AEAE47, 0x18080810,
+    0xD5BABA6F, 0x887878F0, 0x6F25254A, 0x722E2E5C, 0x241C1C38, 0xF1A6A657, 0xC7B4B473, 0x51C6C697,
+    0x23E8E8CB, 0x7CDDDDA1, 0x9C7474E8, 0x211F1F3E, 0xDD4B4B96, 0xDCBDBD61, 0x868B8B0D, 0x858A8A0F,
+    0x907070E0, 0x423E3E7C, 0xC4B5B571, 0xAA6666CC, 0xD8484890, 0x05030306, 0x01F6F6F7, 0x120E0E1C,
+    0xA36161C2, 0x5F35356A, 0xF95757AE, 0xD0B9B969, 0x91868617, 0x58C1C199, 0x271D1D3A, 0xB99E9E27,
+    0x38E1E1D9, 0x13F8F8EB, 0xB398982B, 0x33111122, 0xBB6969D2, 0x70D9D9A9, 0x898E8E07, 0xA7949433,
+    0xB69B9B2D, 0x221E1E3C, 0x92878715, 0x20E9E9C9, 0x49CECE87, 0xFF5555AA, 0x78282850, 0x7ADFDFA5,
+    0x8F8C8C03, 0xF8A1A159, 0x80898909, 0x170D0D1A, 0xDABFBF65, 0x31E6E6D7, 0xC6424284, 0xB86868D0,
+    0xC3414182, 0xB0999929, 0x772D2D5A, 0x110F0F1E, 0xCBB0B07B, 0xFC5454A8, 0xD6BBBB6D, 0x3A16162C,
+};
+#endif
+
+/* Private functions ---------------------------------------------------------*/
+
+static inline uint8_t aes_xtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1B : 0x00));
+}
+
+/**
+ * @brief 密钥扩展（FIPS-197 5.2）
+ *
+ * @param nk 密钥字数（4 / 6 / 8）
+ */
+static void aes_expand_key(uint8_t *rk, const uint8_t *key, uint8_t nk, uint8_t rounds)
+{
+    uint8_t rcon = 0x01;
+
+    memcpy(rk, key, nk * 4U);
+
+    for (unsigned i = nk; i < 4U * (rounds + 1U); i++) {
+        uint8_t t[4];
+
+        memcpy(t, &rk[(i - 1) * 4], 4);
+
+        if (i % nk == 0) {
+            uint8_t t0 = t[0];
+            t[0] = (uint8_t)(aes_sbox[t[1]] ^ rcon);
+            t[1] = aes_sbox[t[2]];
+            t[2] = aes_sbox[t[3]];
+            t[3] = aes_sbox[t0];
+            rcon = aes_xtime(rcon);
+        } else if (nk > 6 && i % nk == 4) {
+            for (unsigned j = 0; j < 4; j++) {
+                t[j] = aes_sbox[t[j]];
+            }
+        }
+
+        for (unsigned j = 0; j < 4; j++) {
+            rk[i * 4 + j] = rk[(i - nk) * 4 + j] ^ t[j];
+        }
+    }
+}
+
+#if !defined(AES_HW_NI) && !defined(AES_HW_ARMV8)
+static inline uint32_t aes_load_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void aes_store_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t aes_rotl(uint32_t v, unsigned n)
+{
+    return (v << n) | (v >> (32 - n));
+}
+
+/**
+ * @brief 加密一个块（查表实现）
+ *
+ * 状态按列存放为 4 个 32 位字，ShiftRows 体现在取字节时的列偏移上
+ */
+static void aes_encrypt_block(const uint8_t *rk, uint8_t rounds, uint8_t *block)
+{
+    uint32_t s[4];
+    uint32_t t[4];
+
+    for (unsigned c = 0; c < 4; c++) {
+        s[c] = aes_load_le32(&block[c * 4]) ^ aes_load_le32(&rk[c * 4]);
+    }
+
+    for (unsigned r = 1; r < rounds; r++) {
+        for (unsigned c = 0; c < 4; c++) {
+            t[c] = aes_te0[s[c] & 0xFF] ^
+                   aes_rotl(aes_te0[(s[(c + 1) & 3] >> 8) & 0xFF], 8) ^
+                   aes_rotl(aes_te0[(s[(c + 2) & 3] >> 16) & 0xFF], 16) ^
+                   aes_rotl(aes_te0[s[(c + 3) & 3] >> 24], 24) ^
+                   aes_load_le32(&rk[r * AES_BLOCK + c * 4]);
+        }
+        memcpy(s, t, sizeof(s));
+    }
+
+    /* 最后一轮没有 MixColumns */
+    for (unsigned c = 0; c < 4; c++) {
+        t[c] = (uint32_t)aes_sbox[s[c] & 0xFF] |
+               ((uint32_t)aes_sbox[(s[(c + 1) & 3] >> 8) & 0xFF] << 8) |
+               ((uint32_t)aes_sbox[(s[(c + 2) & 3] >> 16) & 0xFF] << 16) |
+               ((uint32_t)aes_sbox[s[(c + 3) & 3] >> 24] << 24);
+        aes_store_le32(&block[c * 4], t[c] ^ aes_load_le32(&rk[rounds * AES_BLOCK + c * 4]));
+    }
+}
+#endif
+
+#if defined(AES_HW_NI)
+/**
+ * @brief 原地加密 4 个块，4 路交错隐藏 aesenc 延迟（显式展开，保证状态留在寄存器中）
+ */
+static void aes_ni_encrypt4(const ring_buffer_aes_t *aes, uint8_t *out)
+{
+    const __m128i *rk = (const __m128i *)aes->round_keys;
+    __m128i *p = (__m128i *)out;
+    __m128i k = _mm_loadu_si128(&rk[0]);
+    __m128i s0 = _mm_xor_si128(_mm_loadu_si128(&p[0]), k);
+    __m128i s1 = _mm_xor_si128(_mm_loadu_si128(&p[1]), k);
+    __m128i s2 = _mm_xor_si128(_mm_loadu_si128(&p[2]), k);
+    __m128i s3 = _mm_xor_si128(_mm_loadu_si128(&p[3]), k);
+
+    for (unsigned r = 1; r < aes->rounds; r++) {
+        k = _mm_loadu_si128(&rk[r]);
+        s0 = _mm_aesenc_si128(s0, k);
+        s1 = _mm_aesenc_si128(s1, k);
+        s2 = _mm_aesenc_si128(s2, k);
+        s3 = _mm_aesenc_si128(s3, k);
+    }
+
+    k = _mm_loadu_si128(&rk[aes->rounds]);
+    _mm_storeu_si128(&p[0], _mm_aesenclast_si128(s0, k));
+    _mm_storeu_si128(&p[1], _mm_aesenclast_si128(s1, k));
+    _mm_storeu_si128(&p[2], _mm_aesenclast_si128(s2, k));
+    _mm_storeu_si128(&p[3], _mm_aesenclast_si128(s3, k));
+}
+
+static void aes_ni_encrypt1(const ring_buffer_aes_t *aes, uint8_t *out)
+{
+    const __m128i *rk = (const __m128i *)aes->round_keys;
+    __m128i s = _mm_xor_si128(_mm_loadu_si128((const __m128i *)out), _mm_loadu_si128(&rk[0]));
+
+    for (unsigned r = 1; r < aes->rounds; r++) {
+        s = _mm_aesenc_si128(s, _mm_loadu_si128(&rk[r]));
+    }
+    _mm_storeu_si128((__m128i *)out, _mm_aesenclast_si128(s, _mm_loadu_si128(&rk[aes->rounds])));
+}
+#endif
+
+static inline void aes_store_be64(uint8_t *p, uint64_t v)
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    v = __builtin_bswap64(v);
+    memcpy(p, &v, 8);
+#else
+    for (unsigned i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (56 - 8 * i));
+    }
+#endif
+}
+
+/**
+ * @brief 生成 nb 个连续块的密钥流（计数器 = IV + blk ... IV + blk + nb - 1）
+ */
+static void aes_keystream(const ring_buffer_aes_t *aes, uint64_t blk, uint8_t *out, unsigned nb)
+{
+    for (unsigned b = 0; b < nb; b++) {
+        uint64_t lo = aes->iv_lo + blk + b;
+        uint64_t hi = aes->iv_hi + (lo < aes->iv_lo);
+
+        aes_store_be64(&out[b * AES_BLOCK], hi);
+        aes_store_be64(&out[b * AES_BLOCK + 8], lo);
+    }
+
+#if defined(AES_HW_NI)
+    unsigned b = 0;
+
+    for (; b + 4 <= nb; b += 4) {
+        aes_ni_encrypt4(aes, &out[b * AES_BLOCK]);
+    }
+    for (; b < nb; b++) {
+        aes_ni_encrypt1(aes, &out[b * AES_BLOCK]);
+    }
+#elif defined(AES_HW_ARMV8)
+    for (unsigned b = 0; b < nb; b++) {
+        uint8x16_t s = vld1q_u8(&out[b * AES_BLOCK]);
+        unsigned r;
+
+        for (r = 0; r + 1 < aes->rounds; r++) {
+            s = vaesmcq_u8(vaeseq_u8(s, vld1q_u8(&aes->round_keys[r * AES_BLOCK])));
+        }
+        s = vaeseq_u8(s, vld1q_u8(&aes->round_keys[r * AES_BLOCK]));
+        s = veorq_u8(s, vld1q_u8(&aes->round_keys[(r + 1) * AES_BLOCK]));
+        vst1q_u8(&out[b * AES_BLOCK], s);
+    }
+#else
+    for (unsigned b = 0; b < nb; b++) {
+        aes_encrypt_block(aes->round_keys, aes->rounds, &out[b * AES_BLOCK]);
+    }
+#endif
+}
+
+static inline void aes_xor(uint8_t *dst, const uint8_t *src, const uint8_t *ks, uint16_t len)
+{
+    uint16_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        uint64_t a, k;
+        memcpy(&a, &src[i], 8);
+        memcpy(&k, &ks[i], 8);
+        a ^= k;
+        memcpy(&dst[i], &a, 8);
+    }
+    for (; i < len; i++) {
+        dst[i] = src[i] ^ ks[i];
+    }
+}
+
+/**
+ * @brief 在流偏移 st->off 处加/解密 len 字节（dst 可与 src 相同）
+ */
+static void aes_ctr_xor(const ring_buffer_aes_t *aes, ring_buffer_aes_stream_t *st,
+                        uint8_t *dst, const uint8_t *src, uint16_t len)
+{
+    while (len > 0) {
+        uint64_t blk = st->off / AES_BLOCK;
+        uint16_t skip = (uint16_t)(st->off % AES_BLOCK);
+        uint16_t n;
+
+        if (skip != 0 || len < AES_BLOCK) {
+            /* 不完整块：使用（或填充）本侧缓存 */
+            if (!st->ks_valid || st->ks_blk != blk) {
+                aes_keystream(aes, blk, st->ks, 1);
+                st->ks_blk = blk;
+                st->ks_valid = true;
+            }
+            n = AES_BLOCK - skip;
+            if (n > len) {
+                n = len;
+            }
+            aes_xor(dst, src, &st->ks[skip], n);
+        } else {
+            uint8_t ks[AES_BATCH * AES_BLOCK];
+            unsigned nb = len / AES_BLOCK;
+
+            if (nb > AES_BATCH) {
+                nb = AES_BATCH;
+            }
+            aes_keystream(aes, blk, ks, nb);
+            n = (uint16_t)(nb * AES_BLOCK);
+            aes_xor(dst, src, ks, n);
+        }
+
+        st->off += n;
+        dst += n;
+        src += n;
+        len -= n;
+    }
+}
+
+/**
+ * @brief 加密写入区段内偏移 off 处（跨越两段时自动拆分）
+ */
+static void aes_spans_xor_in(ring_buffer_aes_t *aes, const rb_spans_t *sp, uint16_t off,
+                             const uint8_t *src, uint16_t len)
+{
+    if (off < sp->len[0]) {
+        uint16_t n = sp->len[0] - off;
+        if (n > len) n = len;
+        aes_ctr_xor(aes, &aes->wr, sp->ptr[0] + off, src, n);
+        src += n;
+        len -= n;
+        off = 0;
+    } else {
+        off -= sp->len[0];
+    }
+    aes_ctr_xor(aes, &aes->wr, sp->ptr[1] + off, src, len);
+}
+
+/**
+ * @brief 从区段内偏移 off 处解密读出（跨越两段时自动拆分）
+ */
+static void aes_spans_xor_out(ring_buffer_aes_t *aes, const rb_spans_t *sp, uint16_t off,
+                              uint8_t *dst, uint16_t len)
+{
+    if (off < sp->len[0]) {
+        uint16_t n = sp->len[0] - off;
+        if (n > len) n = len;
+        aes_ctr_xor(aes, &aes->rd, dst, sp->ptr[0] + off, n);
+        dst += n;
+        len -= n;
+        off = 0;
+    } else {
+        off -= sp->len[0];
+    }
+    aes_ctr_xor(aes, &aes->rd, dst, sp->ptr[1] + off, len);
+}
+
+/* Exported functions (Implementation) ---------------------------------------*/
+
+static uint16_t aes_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
+{
+    ring_buffer_aes_t *aes = (ring_buffer_aes_t *)rb->ctx;
+    rb_spans_t sp;
+    uint16_t to_write = rb_write_spans(rb, len, &sp);
+
+    if (to_write > 0) {
+        aes_spans_xor_in(aes, &sp, 0, data, to_write);
+        rb_commit_write(rb, to_write);
+    }
+
+#if RING_BUFFER_ENABLE_STATISTICS
+    if (to_write < len) rb_stat_overflow(rb);
+#endif
+
+    return to_write;
+}
+
+static uint16_t aes_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
+{
+    ring_buffer_aes_t *aes = (ring_buffer_aes_t *)rb->ctx;
+    rb_spans_t sp;
+    uint16_t to_read = rb_read_spans(rb, len, &sp);
+
+    if (to_read > 0) {
+        aes_spans_xor_out(aes, &sp, 0, data, to_read);
+        rb_commit_read(rb, to_read);
+    }
+
+    return to_read;
+}
+
+static bool aes_write(ring_buffer_t *rb, uint8_t data)
+{
+    return aes_write_multi(rb, &data, 1) == 1;
+}
+
+static bool aes_read(ring_buffer_t *rb, uint8_t *data)
+{
+    return aes_read_multi(rb, data, 1) == 1;
+}
+
+static uint16_t aes_writev(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    ring_buffer_aes_t *aes = (ring_buffer_aes_t *)rb->ctx;
+    uint32_t total = 0;
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    /* 全部写入或完全不写，避免消费者看到半帧 */
+    if (total > rb_free_space(rb)) {
+#if RING_BUFFER_ENABLE_STATISTICS
+        rb_stat_overflow(rb);
+#endif
+        return 0;
+    }
+
+    rb_spans_t sp;
+    uint16_t off = 0;
+
+    rb_write_spans(rb, (uint16_t)total, &sp);
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        aes_spans_xor_in(aes, &sp, off, (const uint8_t *)iov[i].base, iov[i].len);
+        off += iov[i].len;
+    }
+
+    rb_commit_write(rb, (uint16_t)total);
+
+    return (uint16_t)total;
+}
+
+static uint16_t aes_readv(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    ring_buffer_aes_t *aes = (ring_buffer_aes_t *)rb->ctx;
+    uint32_t total = 0;
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+
+    if (total == 0 || total > rb_available(rb)) {
+        return 0;
+    }
+
+    rb_spans_t sp;
+    uint16_t off = 0;
+
+    rb_read_spans(rb, (uint16_t)total, &sp);
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        aes_spans_xor_out(aes, &sp, off, (uint8_t *)iov[i].base, iov[i].len);
+        off += iov[i].len;
+    }
+
+    rb_commit_read(rb, (uint16_t)total);
+
+    return (uint16_t)total;
+}
+
+static uint16_t aes_available(const ring_buffer_t *rb)
+{
+    return rb_available(rb);
+}
+
+static uint16_t aes_free_space(const ring_buffer_t *rb)
+{
+    return rb_free_space(rb);
+}
+
+static bool aes_is_empty(const ring_buffer_t *rb)
+{
+    return (rb->head == rb->tail);
+}
+
+static bool aes_is_full(const ring_buffer_t *rb)
+{
+    return ((rb->head + 1) % rb->size == rb->tail);
+}
+
+static void aes_clear(ring_buffer_t *rb)
+{
+    ring_buffer_aes_t *aes = (ring_buffer_aes_t *)rb->ctx;
+
+    /* 丢弃的密文也要计入读出流偏移，保持与生产者同步 */
+    aes->rd.off += rb_available(rb);
+    ring_buffer_lockfree_ops.clear(rb);
+}
+
+/* Private constant ----------------------------------------------------------*/
+
+static const struct ring_buffer_ops ring_buffer_aes_ops = {
+    .write       = aes_write,
+    .read        = aes_read,
+    .write_multi = aes_write_multi,
+    .read_multi  = aes_read_multi,
+    .available   = aes_available,
+    .free_space  = aes_free_space,
+    .is_empty    = aes_is_empty,
+    .is_full     = aes_is_full,
+    .clear       = aes_clear,
+    .writev      = aes_writev,
+    .readv       = aes_readv,
+};
+
+/* Exported functions --------------------------------------------------------*/
+
+bool ring_buffer_aes_create(ring_buffer_t *rb, ring_buffer_aes_t *aes, uint8_t *buffer,
+                            uint16_t size, const uint8_t *key, uint8_t key_len,
+                            const uint8_t iv[16])
+{
+    uint8_t nk;
+
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (rb == NULL || aes == NULL || key == NULL || iv == NULL) {
+        return false;
+    }
+#endif
+
+    switch (key_len) {
+        case 16: nk = 4; break;
+        case 24: nk = 6; break;
+        case 32: nk = 8; break;
+        default: return false;
+    }
+
+    if (!ring_buffer_create(rb, buffer, size, RING_BUFFER_TYPE_LOCKFREE)) {
+        return false;
+    }
+
+    memset(aes, 0, sizeof(*aes));
+    aes->rounds = nk + 6;
+    aes_expand_key(aes->round_keys, key, nk, aes->rounds);
+
+    for (unsigned i = 0; i < 8; i++) {
+        aes->iv_hi = (aes->iv_hi << 8) | iv[i];
+        aes->iv_lo = (aes->iv_lo << 8) | iv[8 + i];
+    }
+
+    rb->ctx = aes;
+    rb->ops = &ring_buffer_aes_ops;
+    return true;
+}
+
+void ring_buffer_aes_destroy(ring_buffer_t *rb)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (rb == NULL || rb->ops != &ring_buffer_aes_ops) {
+        return;
+    }
+#endif
+
+    volatile uint8_t *p = (volatile uint8_t *)rb->ctx;
+
+    /* 擦除轮密钥与缓存的密钥流（volatile 防止被优化掉）*/
+    for (size_t i = 0; i < sizeof(ring_buffer_aes_t); i++) {
+        p[i] = 0;
+    }
+
+    ring_buffer_destroy(rb);
+}
+
+#endif /* RING_BUFFER_ENABLE_AES */
@@ -0,0 +1,826 @@
+/**
+ * @file    ring_buffer_bench.c
+ * @brief   环形缓冲区性能基准（PC 主机）
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 测量批量读写路径的吞吐量，用于验证性能优化效果
+ *
+ * 编译方式（Linux/macOS）：
+ * gcc -O2 -o bench ring_buffer_bench.c ring_buffer.c ring_buffer_lockfree.c \
+ *     ring_buffer_disable_irq.c ring_buffer_mutex.c ring_buffer_lz.c ring_buffer_aes.c \
+ *     ring_buffer_trace.c ring_buffer_spinlock.c ring_buffer_combining.c ring_buffer_shard.c \
+ *     -I. -lpthread
+ *
+ * 运行：
+ * ./bench
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ring_buffer_internal.h"
+#include "ring_buffer_decorator.h"
+
+#if RING_BUFFER_ENABLE_SPINLOCK || RING_BUFFER_ENABLE_MUTEX || RING_BUFFER_ENABLE_COMBINING || \
+    RING_BUFFER_ENABLE_SHARD
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/* 基准用宏 */
+#define BENCH_BYTES  (64UL * 1024 * 1024)  /**< 每项测试搬运的总字节数 */
+
+/* 基准缓冲区（奇数大小，保证频繁环绕） */
+static uint8_t bench_buffer[4093];
+static ring_buffer_t bench_rb;
+
+static uint8_t src_block[4096];
+static uint8_t dst_block[4096];
+
+/* ==================== 工具函数 ==================== */
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double mb_per_sec(unsigned long bytes, double sec)
+{
+    return (bytes / (1024.0 * 1024.0)) / sec;
+}
+
+/* 防止编译器把结果优化掉 */
+static volatile uint8_t bench_sink;
+
+/* ==================== 拷贝内核基准 ==================== */
+
+/**
+ * @brief 对比 rb_copy 与 libc memcpy（含环绕双段拷贝）
+ *
+ * @note 长度为运行期变量，libc memcpy 无法被编译器内联为定长拷贝
+ */
+static void bench_copy_kernel(volatile uint16_t len)
+{
+    const uint16_t size = sizeof(bench_buffer);
+    unsigned long loops = BENCH_BYTES / len;
+    uint16_t pos = 0;
+    double t0, t_rb, t_libc;
+
+    t0 = now_sec();
+    for (unsigned long i = 0; i < loops; i++) {
+        uint16_t first = (pos + len <= size) ? len : (uint16_t)(size - pos);
+        rb_copy(&bench_buffer[pos], src_block, first);
+        rb_copy(&bench_buffer[0], &src_block[first], len - first);
+        pos = (pos + len) % size;
+    }
+    t_rb = now_sec() - t0;
+
+    pos = 0;
+    t0 = now_sec();
+    for (unsigned long i = 0; i < loops; i++) {
+        uint16_t first = (pos + len <= size) ? len : (uint16_t)(size - pos);
+        memcpy(&bench_buffer[pos], src_block, first);
+        memcpy(&bench_buffer[0], &src_block[first], len - first);
+        pos = (pos + len) % size;
+    }
+    t_libc = now_sec() - t0;
+
+    bench_sink = bench_buffer[pos];
+
+    printf("  %5u B | rb_copy %8.1f MB/s | memcpy %8.1f MB/s | x%.2f\n",
+           len, mb_per_sec(loops * len, t_rb), mb_per_sec(loops * len, t_libc),
+           t_libc / t_rb);
+}
+
+/* ==================== 端到端基准 ==================== */
+
+/**
+ * @brief 无锁策略 write_multi + read_multi 往返吞吐
+ */
+static void bench_lockfree_roundtrip(uint16_t len)
+{
+    unsigned long loops = BENCH_BYTES / len;
+    double t0, t;
+
+    ring_buffer_create(&bench_rb, bench_buffer, sizeof(bench_buffer),
+                       RING_BUFFER_TYPE_LOCKFREE);
+
+    t0 = now_sec();
+    for (unsigned long i = 0; i < loops; i++) {
+        ring_buffer_write_multi(&bench_rb, src_block, len);
+        ring_buffer_read_multi(&bench_rb, dst_block, len);
+    }
+    t = now_sec() - t0;
+
+    bench_sink = dst_block[0];
+    ring_buffer_destroy(&bench_rb);
+
+    printf("  %5u B | write+read %8.1f MB/s\n", len, mb_per_sec(loops * len, t));
+}
+
+/* ==================== 大块流式基准 ==================== */
+
+static uint8_t bulk_buffer[65535];
+static uint8_t bulk_block[4096];
+static uint8_t working_set[32 * 1024];
+
+/**
+ * @brief 大块写入对消费者工作集的影响
+ *
+ * @details
+ * 每写入一块后扫描 32 KB 工作集，模拟消费者的热点数据；
+ * 缓冲区写满后一次性读出。启用 RING_BUFFER_STREAM_THRESHOLD 后，
+ * 写入绕过缓存，工作集扫描时间应明显下降
+ */
+static void bench_bulk_stream(uint16_t len)
+{
+    unsigned long loops = BENCH_BYTES / len;
+    unsigned long scan_sum = 0;
+    double t0, t;
+
+    ring_buffer_create(&bench_rb, bulk_buffer, sizeof(bulk_buffer),
+                       RING_BUFFER_TYPE_LOCKFREE);
+
+    t0 = now_sec();
+    for (unsigned long i = 0; i < loops; i++) {
+        if (ring_buffer_write_multi(&bench_rb, bulk_block, len) < len) {
+            while (ring_buffer_read_multi(&bench_rb, bulk_block, len) > 0) {
+            }
+            ring_buffer_write_multi(&bench_rb, bulk_block, len);
+        }
+        for (unsigned j = 0; j < sizeof(working_set); j += 64) {
+            scan_sum += working_set[j];
+        }
+    }
+    t = now_sec() - t0;
+
+    bench_sink = (uint8_t)scan_sum;
+    ring_buffer_destroy(&bench_rb);
+
+    printf("  %5u B | write+scan %8.1f MB/s (stream threshold = %u)\n",
+           len, mb_per_sec(loops * len, t), (unsigned)RING_BUFFER_STREAM_THRESHOLD);
+}
+
+#if RING_BUFFER_ENABLE_LZ
+
+/* ==================== 压缩缓冲区基准 ==================== */
+
+static ring_buffer_lz_t bench_lz;
+static uint8_t telemetry[4096];
+static uint8_t noise[4096];
+
+/**
+ * @brief 压缩缓冲区写满再读空，分别统计压缩与解压吞吐
+ */
+static void bench_lz_roundtrip(const char *name, const uint8_t *src, uint16_t len)
+{
+    unsigned long bytes = 0;
+    double t0, t_wr = 0, t_rd = 0;
+
+    ring_buffer_lz_create(&bench_rb, &bench_lz, bench_buffer, sizeof(bench_buffer));
+
+    while (bytes < BENCH_BYTES / 8) {
+        t0 = now_sec();
+        while (ring_buffer_write_multi(&bench_rb, src, len) == len) {
+            bytes += len;
+        }
+        t_wr += now_sec() - t0;
+
+        t0 = now_sec();
+        while (ring_buffer_read_multi(&bench_rb, dst_block, len) > 0) {
+        }
+        t_rd += now_sec() - t0;
+    }
+
+    bench_sink = dst_block[0];
+
+    printf("  %-9s %5u B | ratio %5.2f | compress %7.1f MB/s | decompress %7.1f MB/s\n",
+           name, len, (double)bench_lz.raw_in / bench_lz.packed_in,
+           mb_per_sec(bytes, t_wr), mb_per_sec(bytes, t_rd));
+
+    ring_buffer_destroy(&bench_rb);
+}
+
+static void bench_lz_setup(void)
+{
+    uint32_t seed = 12345;
+    int pos = 0;
+
+    /* 固定格式的遥测文本，数值缓慢变化 */
+    for (unsigned seq = 0; pos < (int)sizeof(telemetry) - 64; seq++) {
+        pos += snprintf((char *)&telemetry[pos], sizeof(telemetry) - pos,
+                        "seq=%05u temp=23.%u hum=41 state=OK\n", seq, (seq / 8) % 10);
+    }
+
+    for (unsigned i = 0; i < sizeof(noise); i++) {
+        seed = seed * 1103515245U + 12345U;
+        noise[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+#endif /* RING_BUFFER_ENABLE_LZ */
+
+#if RING_BUFFER_ENABLE_AES
+
+/* ==================== 加密缓冲区基准 ==================== */
+
+static ring_buffer_aes_t bench_aes;
+
+/**
+ * @brief AES-CTR 加密缓冲区 write_multi + read_multi 往返吞吐
+ */
+static void bench_aes_roundtrip(uint16_t len, uint8_t key_len)
+{
+    static const uint8_t key[32] = {1, 2, 3, 4, 5, 6, 7, 8};
+    static const uint8_t iv[16] = {9};
+    unsigned long loops = BENCH_BYTES / 4 / len;
+    double t0, t;
+
+    ring_buffer_aes_create(&bench_rb, &bench_aes, bench_buffer, sizeof(bench_buffer),
+                           key, key_len, iv);
+
+    t0 = now_sec();
+    for (unsigned long i = 0; i < loops; i++) {
+        ring_buffer_write_multi(&bench_rb, src_block, len);
+        ring_buffer_read_multi(&bench_rb, dst_block, len);
+    }
+    t = now_sec() - t0;
+
+    bench_sink = dst_block[0];
+    ring_buffer_aes_destroy(&bench_rb);
+
+    printf("  AES-%u %5u B | encrypt+decrypt %8.1f MB/s\n",
+           key_len * 8U, len, mb_per_sec(loops * len, t));
+}
+
+#endif /* RING_BUFFER_ENABLE_AES */
+
+#if RING_BUFFER_ENABLE_TRACE
+
+/* ==================== 事件追踪开销 ==================== */
+
+/**
+ * @brief 对比同一往返在不记录 / 记录事件时每次操作的耗时
+ */
+static void bench_trace_overhead(uint16_t len)
+{
+    unsigned long loops = BENCH_BYTES / 4 / len;
+    double t0, t_off, t_on;
+
+    ring_buffer_create(&bench_rb, bench_buffer, sizeof(bench_buffer),
+                       RING_BUFFER_TYPE_LOCKFREE);
+
+    t0 = now_sec();
+    for (unsigned long i = 0; i < loops; i++) {
+        ring_buffer_write_multi(&bench_rb, src_block, len);
+        ring_buffer_read_multi(&bench_rb, dst_block, len);
+    }
+    t_off = now_sec() - t0;
+
+    ring_buffer_trace_set_id(&bench_rb, 1);
+    ring_buffer_trace_start();
+    t0 = now_sec();
+    for (unsigned long i = 0; i < loops; i++) {
+        ring_buffer_write_multi(&bench_rb, src_block, len);
+        ring_buffer_read_multi(&bench_rb, dst_block, len);
+    }
+    t_on = now_sec() - t0;
+    ring_buffer_trace_stop();
+    ring_buffer_trace_reset();
+
+    bench_sink = dst_block[0];
+    ring_buffer_destroy(&bench_rb);
+
+    printf("  %5u B | untraced %6.1f ns/op | traced %6.1f ns/op | +%5.1f ns/event\n",
+           len, t_off * 1e9 / (loops * 2), t_on * 1e9 / (loops * 2),
+           (t_on - t_off) * 1e9 / (loops * 2));
+}
+
+#endif /* RING_BUFFER_ENABLE_TRACE */
+
+#if RING_BUFFER_ENABLE_SNAPSHOT
+
+/* ==================== 一致性快照 ==================== */
+
+/**
+ * @brief 快照读取开销；数据路径的额外开销见启用前后的往返基准对比
+ */
+static void bench_snapshot(void)
+{
+    unsigned long loops = BENCH_BYTES / 16;
+    unsigned long ok = 0;
+    ring_buffer_snapshot_t snap;
+    double t0, t;
+
+    ring_buffer_create(&bench_rb, bench_buffer, sizeof(bench_buffer),
+                       RING_BUFFER_TYPE_LOCKFREE);
+    ring_buffer_write_multi(&bench_rb, src_block, 100);
+
+    t0 = now_sec();
+    for (unsigned long i = 0; i < loops; i++) {
+        ok += ring_buffer_snapshot(&bench_rb, &snap);
+    }
+    t = now_sec() - t0;
+
+    bench_sink = (uint8_t)(ok + snap.occupancy);
+    ring_buffer_destroy(&bench_rb);
+
+    printf("  snapshot %6.1f ns/call\n", t * 1e9 / loops);
+}
+
+#endif /* RING_BUFFER_ENABLE_SNAPSHOT */
+
+#if RING_BUFFER_ENABLE_SPINLOCK || RING_BUFFER_ENABLE_MUTEX || RING_BUFFER_ENABLE_COMBINING
+
+/* ==================== 多线程争用基准 ==================== */
+
+#define CONTEND_OPS  200000UL   /**< 所有线程合计的往返次数 */
+
+static pthread_barrier_t contend_barrier;
+static unsigned long contend_loops;
+
+static void *contend_worker(void *arg)
+{
+    uint8_t out[16];
+
+    (void)arg;
+    pthread_barrier_wait(&contend_barrier);
+    for (unsigned long i = 0; i < contend_loops; i++) {
+        ring_buffer_write_multi(&bench_rb, src_block, sizeof(out));
+        ring_buffer_read_multi(&bench_rb, out, sizeof(out));
+    }
+    bench_sink = out[0];
+    return NULL;
+}
+
+/**
+ * @brief 多个线程争用已创建的 bench_rb，每个线程 16 字节写入 + 读出往返
+ *
+ * @return 每秒完成的往返次数（百万）
+ */
+static double bench_contend_run(unsigned threads)
+{
+    pthread_t th[16];
+    double t0, t;
+
+    contend_loops = CONTEND_OPS / threads;
+    pthread_barrier_init(&contend_barrier, NULL, threads + 1);
+    for (unsigned i = 0; i < threads; i++) {
+        pthread_create(&th[i], NULL, contend_worker, NULL);
+    }
+
+    t0 = now_sec();
+    pthread_barrier_wait(&contend_barrier);
+    for (unsigned i = 0; i < threads; i++) {
+        pthread_join(th[i], NULL);
+    }
+    t = now_sec() - t0;
+
+    pthread_barrier_destroy(&contend_barrier);
+    ring_buffer_destroy(&bench_rb);
+
+    return (contend_loops * threads) / t / 1e6;
+}
+
+#endif /* RING_BUFFER_ENABLE_SPINLOCK || RING_BUFFER_ENABLE_MUTEX || RING_BUFFER_ENABLE_COMBINING */
+
+#if RING_BUFFER_ENABLE_SPINLOCK || RING_BUFFER_ENABLE_MUTEX
+
+/**
+ * @brief 多个线程争用同一缓冲区（按策略类型创建）
+ */
+static double bench_contended(ring_buffer_type_t type, unsigned threads)
+{
+    if (!ring_buffer_create(&bench_rb, bench_buffer, sizeof(bench_buffer), type)) {
+        return 0;
+    }
+    return bench_contend_run(threads);
+}
+
+#endif /* RING_BUFFER_ENABLE_SPINLOCK || RING_BUFFER_ENABLE_MUTEX */
+
+#if RING_BUFFER_ENABLE_COMBINING
+
+static ring_buffer_combining_t bench_fc;
+
+/**
+ * @brief 多个线程争用同一合并模式缓冲区
+ *
+ * @param batch 输出：平均每次合并处理的请求数
+ */
+static double bench_combining(unsigned threads, double *batch)
+{
+    double rt;
+
+    ring_buffer_combining_create(&bench_rb, &bench_fc, bench_buffer, sizeof(bench_buffer));
+    rt = bench_contend_run(threads);
+    *batch = bench_fc.batches ? (double)bench_fc.combined / bench_fc.batches : 0;
+    return rt;
+}
+
+#endif /* RING_BUFFER_ENABLE_COMBINING */
+
+#if RING_BUFFER_ENABLE_MUTEX
+
+/* ==================== 互斥锁模式：水位轮询 ==================== */
+
+#define POLL_WORKERS  2
+
+extern const struct ring_buffer_ops ring_buffer_mutex_ops;
+
+/* 对照组：查询也加锁（改为不加锁之前的互斥锁策略） */
+RING_BUFFER_DECORATE_QUERIES(locked, rb_lockfree, RB_LAYER_MUTEX_ENTER, RB_LAYER_MUTEX_EXIT)
+
+static struct ring_buffer_ops locked_query_ops;
+static volatile bool poll_stop;
+static unsigned long poll_count[16];
+
+static void *poll_worker(void *arg)
+{
+    unsigned long *count = (unsigned long *)arg;
+    unsigned long n = 0;
+    uint32_t sink = 0;
+
+    pthread_barrier_wait(&contend_barrier);
+    while (!poll_stop) {
+        sink += ring_buffer_available(&bench_rb);
+        n++;
+    }
+    *count = n;
+    bench_sink = (uint8_t)sink;
+    return NULL;
+}
+
+/**
+ * @brief 两个线程读写往返，同时 pollers 个线程不停查询数据量
+ *
+ * @param locked 查询是否加锁
+ * @param polls  输出：所有轮询线程合计每秒查询次数（百万）
+ *
+ * @return 读写线程每秒完成的往返次数（百万）
+ */
+static double bench_polled(bool locked, unsigned pollers, double *polls)
+{
+    pthread_t th[POLL_WORKERS + 16];
+    unsigned long total = 0;
+    double t0, t;
+
+    ring_buffer_create(&bench_rb, bench_buffer, sizeof(bench_buffer), RING_BUFFER_TYPE_MUTEX);
+    if (locked) {
+        locked_query_ops = ring_buffer_mutex_ops;
+        locked_query_ops.available = locked_available;
+        locked_query_ops.free_space = locked_free_space;
+        locked_query_ops.is_empty = locked_is_empty;
+        locked_query_ops.is_full = locked_is_full;
+        bench_rb.ops = &locked_query_ops;
+    }
+
+    poll_stop = false;
+    contend_loops = CONTEND_OPS / POLL_WORKERS;
+    pthread_barrier_init(&contend_barrier, NULL, POLL_WORKERS + pollers + 1);
+    for (unsigned i = 0; i < POLL_WORKERS; i++) {
+        pthread_create(&th[i], NULL, contend_worker, NULL);
+    }
+    for (unsigned i = 0; i < pollers; i++) {
+        pthread_create(&th[POLL_WORKERS + i], NULL, poll_worker, &poll_count[i]);
+    }
+
+    t0 = now_sec();
+    pthread_barrier_wait(&contend_barrier);
+    for (unsigned i = 0; i < POLL_WORKERS; i++) {
+        pthread_join(th[i], NULL);
+    }
+    t = now_sec() - t0;
+
+    poll_stop = true;
+    for (unsigned i = 0; i < pollers; i++) {
+        pthread_join(th[POLL_WORKERS + i], NULL);
+        total += poll_count[i];
+    }
+
+    pthread_barrier_destroy(&contend_barrier);
+    ring_buffer_destroy(&bench_rb);
+
+    *polls = total / t / 1e6;
+    return (contend_loops * POLL_WORKERS) / t / 1e6;
+}
+
+
+#if RING_BUFFER_MUTEX_COPY_OUTSIDE
+
+/* ==================== 互斥锁模式：锁外拷贝 ==================== */
+
+/* 对照组：整个拷贝都在锁内（RING_BUFFER_MUTEX_COPY_OUTSIDE = 0 时的写入） */
+RB_DECORATE_FN(inlock, rb_lockfree, RB_LAYER_MUTEX_ENTER, RB_LAYER_MUTEX_EXIT,
+               RING_BUFFER_OP_WRITE_MULTI, uint16_t, write_multi,
+               (ring_buffer_t *rb, const uint8_t *data, uint16_t len), (rb, data, len))
+
+static struct ring_buffer_ops inlock_write_ops;
+static unsigned long produce_bytes;
+
+static void *produce_worker(void *arg)
+{
+    unsigned long sent = 0;
+
+    (void)arg;
+    pthread_barrier_wait(&contend_barrier);
+    while (sent < produce_bytes) {
+        uint16_t n = ring_buffer_write_multi(&bench_rb, bulk_block, sizeof(bulk_block));
+
+        if (n == 0) {
+            sched_yield();
+        }
+        sent += n;
+    }
+    return NULL;
+}
+
+/**
+ * @brief producers 个线程各写 4 KB 块，本线程读出
+ *
+ * @param inlock 拷贝是否在锁内
+ *
+ * @return 吞吐量（MB/s）
+ */
+static double bench_reserve(bool inlock, unsigned producers)
+{
+    pthread_t th[16];
+    unsigned long got = 0;
+    double t0;
+
+    ring_buffer_create(&bench_rb, bulk_buffer, sizeof(bulk_buffer), RING_BUFFER_TYPE_MUTEX);
+    if (inlock) {
+        inlock_write_ops = ring_buffer_mutex_ops;
+        inlock_write_ops.write_multi = inlock_write_multi;
+        bench_rb.ops = &inlock_write_ops;
+    }
+
+    produce_bytes = BENCH_BYTES / 4 / producers;
+    pthread_barrier_init(&contend_barrier, NULL, producers + 1);
+    for (unsigned i = 0; i < producers; i++) {
+        pthread_create(&th[i], NULL, produce_worker, NULL);
+    }
+
+    t0 = now_sec();
+    pthread_barrier_wait(&contend_barrier);
+    while (got < produce_bytes * producers) {
+        uint16_t n = ring_buffer_read_multi(&bench_rb, dst_block, sizeof(dst_block));
+
+        if (n == 0) {
+            sched_yield();  /* 单核主机上让生产者运行 */
+        }
+        got += n;
+    }
+    for (unsigned i = 0; i < producers; i++) {
+        pthread_join(th[i], NULL);
+    }
+
+    pthread_barrier_destroy(&contend_barrier);
+    ring_buffer_destroy(&bench_rb);
+
+    return mb_per_sec(got, now_sec() - t0);
+}
+
+#endif /* RING_BUFFER_MUTEX_COPY_OUTSIDE */
+
+#endif /* RING_BUFFER_ENABLE_MUTEX */
+
+#if RING_BUFFER_ENABLE_SHARD
+
+/* ==================== 分片缓冲区：多生产者汇聚 ==================== */
+
+#define SHARD_BENCH_RECORDS  2000000UL  /**< 所有生产者合计的记录数 */
+#define SHARD_BENCH_LEN      16         /**< 记录负载长度 */
+
+static ring_buffer_sharded_t bench_shards;
+static pthread_barrier_t shard_barrier;
+static unsigned long shard_quota;
+
+static void *shard_bench_producer(void *arg)
+{
+    ring_buffer_t *mine = ring_buffer_shard_claim(&bench_shards);
+    uint64_t ts = 0;
+
+    (void)arg;
+    pthread_barrier_wait(&shard_barrier);
+    for (unsigned long i = 0; i < shard_quota; ) {
+        if (ring_buffer_shard_write(mine, ts, src_block, SHARD_BENCH_LEN)) {
+            ts++;
+            i++;
+        } else {
+            sched_yield();  /* 单核主机上让消费者运行 */
+        }
+    }
+    return NULL;
+}
+
+#if RING_BUFFER_ENABLE_SPINLOCK
+/* 对照组：所有生产者写同一个自旋锁缓冲区，记录大小与分片帧相同 */
+static void *shared_bench_producer(void *arg)
+{
+    uint8_t hdr[10] = {SHARD_BENCH_LEN};
+    ring_buffer_iovec_t iov[2] = { { hdr, sizeof(hdr) }, { src_block, SHARD_BENCH_LEN } };
+
+    (void)arg;
+    pthread_barrier_wait(&shard_barrier);
+    for (unsigned long i = 0; i < shard_quota; ) {
+        if (ring_buffer_writev(&bench_rb, iov, 2)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+#endif
+
+/**
+ * @brief producers 个生产者各写 16 字节记录，本线程汇聚读出
+ *
+ * @param shared true = 共享一个自旋锁缓冲区（对照组）
+ *
+ * @return 每秒汇聚的记录数（百万）
+ */
+static double bench_shard(bool shared, ring_buffer_shard_order_t order, unsigned producers)
+{
+    pthread_t th[RING_BUFFER_SHARD_MAX];
+    unsigned long got = 0;
+    double t0;
+
+    shard_quota = SHARD_BENCH_RECORDS / producers;
+    pthread_barrier_init(&shard_barrier, NULL, producers + 1);
+
+#if RING_BUFFER_ENABLE_SPINLOCK
+    if (shared) {
+        ring_buffer_create(&bench_rb, bench_buffer, sizeof(bench_buffer), RING_BUFFER_TYPE_SPINLOCK);
+        for (unsigned i = 0; i < producers; i++) {
+            pthread_create(&th[i], NULL, shared_bench_producer, NULL);
+        }
+    } else
+#endif
+    {
+        (void)shared;
+        ring_buffer_shard_init(&bench_shards, bulk_buffer, 4096, (uint8_t)producers, order);
+        for (unsigned i = 0; i < producers; i++) {
+            pthread_create(&th[i], NULL, shard_bench_producer, NULL);
+        }
+    }
+
+    t0 = now_sec();
+    pthread_barrier_wait(&shard_barrier);
+    while (got < shard_quota * producers) {
+        bool ok;
+
+#if RING_BUFFER_ENABLE_SPINLOCK
+        if (shared) {
+            ok = ring_buffer_read_multi(&bench_rb, dst_block, 10 + SHARD_BENCH_LEN) != 0;
+        } else
+#endif
+        {
+            ok = ring_buffer_shard_read(&bench_shards, dst_block, sizeof(dst_block), NULL, NULL) != 0;
+        }
+        if (ok) {
+            got++;
+        } else {
+            sched_yield();
+        }
+    }
+    for (unsigned i = 0; i < producers; i++) {
+        pthread_join(th[i], NULL);
+    }
+    pthread_barrier_destroy(&shard_barrier);
+#if RING_BUFFER_ENABLE_SPINLOCK
+    if (shared) {
+        ring_buffer_destroy(&bench_rb);
+    }
+#endif
+
+    return got / (now_sec() - t0) / 1e6;
+}
+
+#endif /* RING_BUFFER_ENABLE_SHARD */
+
+/* ==================== 主函数 ==================== */
+
+int main(void)
+{
+    static const uint16_t sizes[] = {8, 16, 32, 48, 64, 256, 1024};
+
+    for (unsigned i = 0; i < sizeof(src_block); i++) {
+        src_block[i] = (uint8_t)i;
+    }
+
+    printf("\n========== Ring Buffer Benchmarks ==========\n\n");
+
+    printf("[Copy kernel vs libc memcpy, wrap included]\n");
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_copy_kernel(sizes[i]);
+    }
+
+    printf("\n[Lockfree write_multi + read_multi]\n");
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_lockfree_roundtrip(sizes[i]);
+    }
+
+    printf("\n[Bulk write vs consumer working set]\n");
+    bench_bulk_stream(2048);
+    bench_bulk_stream(4096);
+
+#if RING_BUFFER_ENABLE_LZ
+    printf("\n[LZ compressed ring, storage %u B]\n", (unsigned)sizeof(bench_buffer));
+    bench_lz_setup();
+    bench_lz_roundtrip("telemetry", telemetry, 256);
+    bench_lz_roundtrip("telemetry", telemetry, 2048);
+    bench_lz_roundtrip("random", noise, 256);
+    bench_lz_roundtrip("random", noise, 2048);
+#endif
+
+#if RING_BUFFER_ENABLE_AES
+#if defined(__AES__)
+    printf("\n[AES-CTR encrypted ring, AES-NI]\n");
+#elif defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO)
+    printf("\n[AES-CTR encrypted ring, ARMv8 Crypto]\n");
+#else
+    printf("\n[AES-CTR encrypted ring, software]\n");
+#endif
+    bench_aes_roundtrip(16, 16);
+    bench_aes_roundtrip(256, 16);
+    bench_aes_roundtrip(1024, 16);
+    bench_aes_roundtrip(1024, 32);
+#endif
+
+#if RING_BUFFER_ENABLE_TRACE
+    printf("\n[Event trace overhead, write_multi + read_multi]\n");
+    bench_trace_overhead(16);
+    bench_trace_overhead(256);
+#endif
+
+#if RING_BUFFER_ENABLE_SNAPSHOT
+    printf("\n[Consistent snapshot]\n");
+    bench_snapshot();
+#endif
+
+#if RING_BUFFER_ENABLE_SPINLOCK || RING_BUFFER_ENABLE_MUTEX || RING_BUFFER_ENABLE_COMBINING
+    printf("\n[Contended write_multi + read_multi, 16 B, M round trips/s]\n");
+    for (unsigned n = 1; n <= 16; n *= 2) {
+        printf("  %2u threads |", n);
+#if RING_BUFFER_ENABLE_SPINLOCK
+        printf(" spinlock %6.2f |", bench_contended(RING_BUFFER_TYPE_SPINLOCK, n));
+#endif
+#if RING_BUFFER_ENABLE_MUTEX
+        printf(" mutex %6.2f |", bench_contended(RING_BUFFER_TYPE_MUTEX, n));
+#endif
+#if RING_BUFFER_ENABLE_COMBINING
+        double batch;
+        double rt = bench_combining(n, &batch);
+
+        printf(" combining %6.2f (batch %4.2f) |", rt, batch);
+#endif
+        printf("\n");
+    }
+#endif
+
+#if RING_BUFFER_ENABLE_MUTEX
+    printf("\n[Mutex ring polled by monitor threads, %u workers, M round trips/s | M polls/s]\n",
+           POLL_WORKERS);
+    for (unsigned n = 1; n <= 8; n *= 2) {
+        double polls_locked, polls_free;
+        double rt_locked = bench_polled(true, n, &polls_locked);
+        double rt_free = bench_polled(false, n, &polls_free);
+
+        printf("  %u pollers | locked queries %6.2f | %7.2f | lock-free queries %6.2f | %7.2f\n",
+               n, rt_locked, polls_locked, rt_free, polls_free);
+    }
+#if RING_BUFFER_MUTEX_COPY_OUTSIDE
+    printf("\n[Mutex ring, 4 KB writes by N producers, 1 consumer, MB/s]\n");
+    for (unsigned n = 1; n <= 8; n *= 2) {
+        printf("  %u producers | copy in lock %8.1f | copy outside lock %8.1f\n",
+               n, bench_reserve(true, n), bench_reserve(false, n));
+    }
+#endif
+#endif
+
+#if RING_BUFFER_ENABLE_SHARD
+    printf("\n[Sharded MPSC, %u B records, M records/s]\n", SHARD_BENCH_LEN);
+    for (unsigned n = 1; n <= 8 && n <= RING_BUFFER_SHARD_MAX; n *= 2) {
+        printf("  %u producers |", n);
+#if RING_BUFFER_ENABLE_SPINLOCK
+        printf(" shared spinlock ring %6.2f |", bench_shard(true, RING_BUFFER_SHARD_ROUND_ROBIN, n));
+#endif
+        printf(" shards round-robin %6.2f | shards timestamp %6.2f\n",
+               bench_shard(false, RING_BUFFER_SHARD_ROUND_ROBIN, n),
+               bench_shard(false, RING_BUFFER_SHARD_TIMESTAMP, n));
+    }
+#endif
+
+    printf("\n========== Benchmarks Done ==========\n\n");
+
+    return 0;
+}
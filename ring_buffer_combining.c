@@ -0,0 +1,305 @@
+/**
+ * @file    ring_buffer_combining.c
+ * @brief   环形缓冲区合并模式实现（flat combining）
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 多核主机上大量线程争用同一缓冲区（多生产者事件汇聚、线程池任务队列）
+ * - 线程数增加时互斥锁 / 自旋锁的锁字与 head 所在缓存行在核间来回传递，
+ *   吞吐随线程数下降
+ *
+ * 实现方式：
+ * - 每个线程把读写请求填入一个请求槽（独占缓存行），然后等待
+ * - 抢到合并者锁的线程依次执行所有槽中的请求，每执行完一个就把该槽置为完成；
+ *   一轮扫描发现新请求则再扫一轮，最多 RING_BUFFER_COMBINING_PASSES 轮
+ * - 其余线程只读自己的槽，完成后取回结果；head / tail 只在合并者核上修改
+ * - 线程记住上次用过的槽号，下次优先使用同一个槽；合并者只扫描用过的槽
+ *
+ * 线程安全保证：
+ * - 任意多个生产者与消费者，请求按合并者的扫描顺序执行，每个请求原子完成
+ * - 清空、CRC、文件描述符与扩缩容操作直接持合并者锁执行
+ * - 状态查询不加锁，读取同一时刻的一对 head / tail
+ *
+ * @warning
+ * - 等待为自旋（退避后让出 CPU），RTOS 单核系统请使用互斥锁模式
+ * - 不可在 ISR 中使用
+ */
+
+#include "ring_buffer_decorator.h"
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_COMBINING
+
+/* Private defines -----------------------------------------------------------*/
+
+#define FC_FREE     0   /**< 空闲 */
+#define FC_FILLING  1   /**< 已占用，正在填写请求 */
+#define FC_PENDING  2   /**< 等待合并者处理 */
+#define FC_DONE     3   /**< 已完成，结果在 ret 中 */
+
+/* Private variables ---------------------------------------------------------*/
+
+/* 本线程上次使用的槽号 */
+static RING_BUFFER_COMBINING_TLS uint8_t fc_home;
+
+/* Private functions ---------------------------------------------------------*/
+
+static inline void fc_backoff(uint32_t *backoff)
+{
+    for (uint32_t i = 0; i < *backoff; i++) {
+        RING_BUFFER_SPIN_PAUSE();
+    }
+    if (*backoff < RING_BUFFER_SPIN_BACKOFF_MAX) {
+        *backoff <<= 1;
+    } else {
+        RING_BUFFER_SPIN_YIELD();
+    }
+}
+
+static inline bool fc_trylock(ring_buffer_combining_t *fc)
+{
+    return __atomic_load_n(&fc->lock, __ATOMIC_RELAXED) == 0 &&
+           __atomic_exchange_n(&fc->lock, 1, __ATOMIC_ACQUIRE) == 0;
+}
+
+static inline void fc_unlock(ring_buffer_combining_t *fc)
+{
+    __atomic_store_n(&fc->lock, 0, __ATOMIC_RELEASE);
+}
+
+static void fc_lock(ring_buffer_combining_t *fc)
+{
+    uint32_t backoff = 1;
+
+    while (!fc_trylock(fc)) {
+        fc_backoff(&backoff);
+    }
+}
+
+/**
+ * @brief 扩大合并者的扫描范围，使其覆盖槽 [0, n)
+ *
+ * 合并者读取旧值后才扩大时，新槽的请求由其所有者自己抢锁执行，不会遗漏
+ */
+static void fc_raise_active(ring_buffer_combining_t *fc, uint8_t n)
+{
+    uint8_t cur = __atomic_load_n(&fc->active, __ATOMIC_RELAXED);
+
+    while (cur < n &&
+           !__atomic_compare_exchange_n(&fc->active, &cur, n, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * @brief 占用一个空槽，从本线程上次使用的槽开始查找
+ */
+static ring_buffer_combining_slot_t *fc_claim(ring_buffer_combining_t *fc)
+{
+    uint32_t backoff = 1;
+    uint8_t i = fc_home;
+
+    for (;;) {
+        for (uint8_t n = 0; n < RING_BUFFER_COMBINING_SLOTS; n++) {
+            ring_buffer_combining_slot_t *slot = &fc->slot[i];
+            uint8_t expected = FC_FREE;
+
+            if (slot->state == FC_FREE &&
+                __atomic_compare_exchange_n(&slot->state, &expected, FC_FILLING, false,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                fc_home = i;
+                fc_raise_active(fc, (uint8_t)(i + 1));
+                return slot;
+            }
+            i = (uint8_t)((i + 1) % RING_BUFFER_COMBINING_SLOTS);
+        }
+        fc_backoff(&backoff);
+    }
+}
+
+/**
+ * @brief 执行一个请求（合并者持锁调用）
+ */
+static uint16_t fc_apply(ring_buffer_t *rb, const ring_buffer_combining_slot_t *slot)
+{
+    switch (slot->op) {
+        case RING_BUFFER_OP_WRITE:
+            return rb_lockfree_write(rb, *(const uint8_t *)slot->data);
+        case RING_BUFFER_OP_READ:
+            return rb_lockfree_read(rb, (uint8_t *)slot->data);
+        case RING_BUFFER_OP_WRITE_MULTI:
+            return rb_lockfree_write_multi(rb, (const uint8_t *)slot->data, slot->len);
+        case RING_BUFFER_OP_READ_MULTI:
+            return rb_lockfree_read_multi(rb, (uint8_t *)slot->data, slot->len);
+        case RING_BUFFER_OP_WRITEV:
+            return rb_lockfree_writev(rb, (const ring_buffer_iovec_t *)slot->data,
+                                      (uint8_t)slot->len);
+        case RING_BUFFER_OP_READV:
+            return rb_lockfree_readv(rb, (const ring_buffer_iovec_t *)slot->data,
+                                     (uint8_t)slot->len);
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief 合并者：扫描所有槽并执行待处理的请求（持锁调用）
+ */
+static void fc_combine(ring_buffer_t *rb, ring_buffer_combining_t *fc)
+{
+    uint8_t active = __atomic_load_n(&fc->active, __ATOMIC_ACQUIRE);
+    uint32_t applied = 0;
+
+    for (uint8_t pass = 0; pass < RING_BUFFER_COMBINING_PASSES; pass++) {
+        uint32_t found = 0;
+
+        for (uint8_t i = 0; i < active; i++) {
+            ring_buffer_combining_slot_t *slot = &fc->slot[i];
+
+            if (__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) != FC_PENDING) {
+                continue;
+            }
+            slot->ret = fc_apply(rb, slot);
+            __atomic_store_n(&slot->state, FC_DONE, __ATOMIC_RELEASE);
+            found++;
+        }
+        if (found == 0) {
+            break;
+        }
+        applied += found;
+    }
+
+    fc->batches++;
+    fc->combined += applied;
+}
+
+/**
+ * @brief 发布请求并等待完成；锁空闲时自己成为合并者
+ */
+static uint16_t fc_submit(ring_buffer_t *rb, uint8_t op, const void *data, uint16_t len)
+{
+    ring_buffer_combining_t *fc = (ring_buffer_combining_t *)rb->ctx;
+    ring_buffer_combining_slot_t *slot = fc_claim(fc);
+    uint32_t backoff = 1;
+    uint16_t ret;
+
+    slot->op = op;
+    slot->data = data;
+    slot->len = len;
+    __atomic_store_n(&slot->state, FC_PENDING, __ATOMIC_RELEASE);
+
+    while (__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) != FC_DONE) {
+        if (fc_trylock(fc)) {
+            fc_combine(rb, fc);     /* 本线程的请求在第一轮即被执行 */
+            fc_unlock(fc);
+        } else {
+            fc_backoff(&backoff);
+        }
+    }
+
+    ret = slot->ret;
+    __atomic_store_n(&slot->state, FC_FREE, __ATOMIC_RELEASE);
+    return ret;
+}
+
+/* Exported functions (Implementation) ---------------------------------------*/
+
+static bool combining_write(ring_buffer_t *rb, uint8_t data)
+{
+    return fc_submit(rb, RING_BUFFER_OP_WRITE, &data, 1) != 0;
+}
+
+static bool combining_read(ring_buffer_t *rb, uint8_t *data)
+{
+    return fc_submit(rb, RING_BUFFER_OP_READ, data, 1) != 0;
+}
+
+static uint16_t combining_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
+{
+    return fc_submit(rb, RING_BUFFER_OP_WRITE_MULTI, data, len);
+}
+
+static uint16_t combining_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
+{
+    return fc_submit(rb, RING_BUFFER_OP_READ_MULTI, data, len);
+}
+
+static uint16_t combining_writev(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    return fc_submit(rb, RING_BUFFER_OP_WRITEV, iov, iovcnt);
+}
+
+static uint16_t combining_readv(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    return fc_submit(rb, RING_BUFFER_OP_READV, iov, iovcnt);
+}
+
+/* 其余修改操作：持合并者锁 → 直接调用无锁实现 → 解锁 */
+#define RB_LAYER_FC_ENTER(rb, op)       fc_lock((ring_buffer_combining_t *)(rb)->ctx)
+#define RB_LAYER_FC_EXIT(rb, op, ret)   fc_unlock((ring_buffer_combining_t *)(rb)->ctx)
+
+static void combining_clear(ring_buffer_t *rb)
+{
+    RB_LAYER_FC_ENTER(rb, RING_BUFFER_OP_CLEAR);
+    rb_lockfree_clear(rb);
+    RB_LAYER_FC_EXIT(rb, RING_BUFFER_OP_CLEAR, 0);
+}
+
+/* 未启用的功能展开为空 */
+RB_DECORATE_CRC_(combining, rb_lockfree, RB_LAYER_FC_ENTER, RB_LAYER_FC_EXIT)
+RB_DECORATE_FD_(combining, rb_lockfree, RB_LAYER_FC_ENTER, RB_LAYER_FC_EXIT)
+RB_DECORATE_RESIZE_(combining, rb_lockfree, RB_LAYER_FC_ENTER, RB_LAYER_FC_EXIT)
+
+/* 状态查询：不加锁，结果为调用期间某一时刻的准确值 */
+
+static uint16_t combining_peek_available(const ring_buffer_t *rb)
+{
+    return rb_peek_available(rb);
+}
+
+static uint16_t combining_peek_free_space(const ring_buffer_t *rb)
+{
+    return rb_peek_free_space(rb);
+}
+
+static bool combining_peek_is_empty(const ring_buffer_t *rb)
+{
+    return rb_peek_available(rb) == 0;
+}
+
+static bool combining_peek_is_full(const ring_buffer_t *rb)
+{
+    return rb_peek_free_space(rb) == 0;
+}
+
+/* Private constant ----------------------------------------------------------*/
+
+static const struct ring_buffer_ops ring_buffer_combining_ops =
+    RING_BUFFER_DECORATED_OPS_QUERIES_FROM(combining, combining_peek);
+
+/* Exported functions --------------------------------------------------------*/
+
+bool ring_buffer_combining_create(ring_buffer_t *rb, ring_buffer_combining_t *fc,
+                                  uint8_t *buffer, uint16_t size)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (rb == NULL || fc == NULL) {
+        return false;
+    }
+#endif
+
+    if (!ring_buffer_create(rb, buffer, size, RING_BUFFER_TYPE_LOCKFREE)) {
+        return false;
+    }
+
+    memset(fc, 0, sizeof(*fc));
+
+    rb->ctx = fc;
+    rb->ops = &ring_buffer_combining_ops;
+    return true;
+}
+
+#endif /* RING_BUFFER_ENABLE_COMBINING */
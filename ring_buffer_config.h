@@ -34,11 +34,21 @@ extern "C" {
  * - LOCKFREE: ISR → 主循环（单生产者单消费者）
  * - DISABLE_IRQ: 裸机多任务，多个中断源共享缓冲区
  * - MUTEX: FreeRTOS/RT-Thread 等 RTOS 多线程
+ * - SPINLOCK: 多核主机 / 多核 MCU，临界区很短、不希望线程休眠
+ * - COMBINING: 多核主机上大量线程争用同一缓冲区（ring_buffer_combining_create()）
  */
 #define RING_BUFFER_ENABLE_LOCKFREE    1  /**< 无锁模式 */
 #define RING_BUFFER_ENABLE_DISABLE_IRQ 0  /**< 关中断模式 */
 #define RING_BUFFER_ENABLE_MUTEX       0  /**< 互斥锁模式 */
 
+#ifndef RING_BUFFER_ENABLE_SPINLOCK
+#define RING_BUFFER_ENABLE_SPINLOCK    0  /**< 自旋锁模式 */
+#endif
+
+#ifndef RING_BUFFER_ENABLE_COMBINING
+#define RING_BUFFER_ENABLE_COMBINING   0  /**< 合并模式（flat combining）*/
+#endif
+
 /* ==================== 平台适配：中断控制 ==================== */
 
 #if RING_BUFFER_ENABLE_DISABLE_IRQ
@@ -247,8 +257,569 @@ extern "C" {
     #error "未选择 RTOS，请在 ring_buffer_config.h 中定义 RTOS_xxx"
 #endif
 
+/**
+ * @brief 锁外拷贝阈值（字节）
+ *
+ * 写入长度达到该值时，锁内只预留空间，数据在锁外拷入，拷完再加锁按预留顺序
+ * 提交 head；多个生产者可以同时拷贝，持锁时间与写入长度无关。
+ * 短于该值的写入仍在锁内拷贝（加解锁两次比直接拷贝更慢）
+ *
+ * 设为 0 则始终在锁内拷贝
+ */
+#ifndef RING_BUFFER_MUTEX_COPY_OUTSIDE
+#define RING_BUFFER_MUTEX_COPY_OUTSIDE  256
+#endif
+
+/**
+ * @brief 同时在锁外拷贝的最大写入数（1 ~ 8）
+ *
+ * 超出时新的写入退回锁内拷贝，仍按顺序提交
+ */
+#ifndef RING_BUFFER_MUTEX_MAX_RESERVE
+#define RING_BUFFER_MUTEX_MAX_RESERVE  4
+#endif
+
+#if RING_BUFFER_MUTEX_MAX_RESERVE < 1 || RING_BUFFER_MUTEX_MAX_RESERVE > 8
+#error "RING_BUFFER_MUTEX_MAX_RESERVE 必须在 1 ~ 8 之间"
+#endif
+
 #endif /* RING_BUFFER_ENABLE_MUTEX */
 
+/* ==================== 平台适配：自旋锁 ==================== */
+
+#if RING_BUFFER_ENABLE_SPINLOCK
+
+/**
+ * @brief 锁算法
+ *
+ * 0 = TTAS（test-and-test-and-set）+ 指数退避：开销最小，线程数多于核数时也稳定
+ * 1 = 票据锁 + 按排队距离退避：严格先来先服务，适合核数固定的 SMP MCU
+ */
+#ifndef RING_BUFFER_SPINLOCK_TICKET
+#define RING_BUFFER_SPINLOCK_TICKET  0
+#endif
+
+/**
+ * @brief 持锁期间是否同时关闭本核中断（SMP MCU）
+ *
+ * 中断服务程序也会访问同一缓冲区时必须启用，否则本核 ISR 抢占持锁代码后
+ * 自旋等待会死锁；需同时启用 RING_BUFFER_ENABLE_DISABLE_IRQ 以提供 IRQ_SAVE/IRQ_RESTORE
+ */
+#ifndef RING_BUFFER_SPINLOCK_IRQ
+#define RING_BUFFER_SPINLOCK_IRQ  0
+#endif
+
+#if RING_BUFFER_SPINLOCK_IRQ && !RING_BUFFER_ENABLE_DISABLE_IRQ
+#error "RING_BUFFER_SPINLOCK_IRQ 需要启用 RING_BUFFER_ENABLE_DISABLE_IRQ（提供 IRQ_SAVE/IRQ_RESTORE）"
+#endif
+
+#endif /* RING_BUFFER_ENABLE_SPINLOCK */
+
+/* ==================== 平台适配：合并模式 ==================== */
+
+#if RING_BUFFER_ENABLE_COMBINING
+
+/**
+ * @brief 请求槽数
+ *
+ * 每个正在读写的线程占用一个槽；线程数多于槽数时后来者等待空槽，
+ * 一般设为可能同时访问该缓冲区的线程数
+ */
+#ifndef RING_BUFFER_COMBINING_SLOTS
+#define RING_BUFFER_COMBINING_SLOTS  16
+#endif
+
+#if RING_BUFFER_COMBINING_SLOTS < 1 || RING_BUFFER_COMBINING_SLOTS > 255
+#error "RING_BUFFER_COMBINING_SLOTS 必须在 1 ~ 255 之间"
+#endif
+
+/**
+ * @brief 合并者每次持锁最多扫描请求槽的轮数
+ *
+ * 一轮没有发现新请求即提前结束；轮数越多批次越大，但合并者自己的请求返回越晚
+ */
+#ifndef RING_BUFFER_COMBINING_PASSES
+#define RING_BUFFER_COMBINING_PASSES  4
+#endif
+
+/**
+ * @brief 请求槽对齐（缓存行大小），各线程的槽互不共享缓存行
+ */
+#ifndef RING_BUFFER_COMBINING_CACHE_LINE
+#define RING_BUFFER_COMBINING_CACHE_LINE  64
+#endif
+
+/**
+ * @brief 线程局部存储说明符（记住每个线程上次使用的槽号）
+ *
+ * 裸机无 TLS 时为空，所有上下文从第一个槽开始查找空槽
+ */
+#ifndef RING_BUFFER_COMBINING_TLS
+#if defined(__unix__) || defined(__APPLE__)
+#define RING_BUFFER_COMBINING_TLS  __thread
+#else
+#define RING_BUFFER_COMBINING_TLS
+#endif
+#endif
+
+#endif /* RING_BUFFER_ENABLE_COMBINING */
+
+/* ==================== 平台适配：自旋等待 ==================== */
+
+#if RING_BUFFER_ENABLE_SPINLOCK || RING_BUFFER_ENABLE_COMBINING
+
+/**
+ * @brief 指数退避上限（每轮最多执行的 PAUSE 次数）
+ */
+#ifndef RING_BUFFER_SPIN_BACKOFF_MAX
+#define RING_BUFFER_SPIN_BACKOFF_MAX  256
+#endif
+
+/**
+ * @brief 自旋等待提示指令
+ *
+ * 降低自旋时的功耗与流水线冲刷，并把执行资源让给同核的超线程
+ */
+#ifndef RING_BUFFER_SPIN_PAUSE
+#if defined(__x86_64__) || defined(__i386__)
+#define RING_BUFFER_SPIN_PAUSE()  __builtin_ia32_pause()
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+#define RING_BUFFER_SPIN_PAUSE()  __asm__ __volatile__("yield" ::: "memory")
+#elif defined(__riscv)
+#define RING_BUFFER_SPIN_PAUSE()  __asm__ __volatile__(".insn i 0x0F, 0, x0, x0, 0x010" ::: "memory")
+#else
+#define RING_BUFFER_SPIN_PAUSE()  __asm__ __volatile__("" ::: "memory")
+#endif
+#endif
+
+/**
+ * @brief 退避达到上限后仍未拿到锁时让出 CPU
+ *
+ * 线程数多于核数时，持锁线程可能被调度出去，一直自旋只会浪费时间片；
+ * POSIX 主机默认 sched_yield()，MCU 默认为空
+ */
+#ifndef RING_BUFFER_SPIN_YIELD
+#if defined(__unix__) || defined(__APPLE__)
+#include <sched.h>
+#define RING_BUFFER_SPIN_YIELD()  sched_yield()
+#else
+#define RING_BUFFER_SPIN_YIELD()  do { } while (0)
+#endif
+#endif
+
+#endif /* RING_BUFFER_ENABLE_SPINLOCK || RING_BUFFER_ENABLE_COMBINING */
+
+/* ==================== 平台适配：Linux 主机 ==================== */
+
+/**
+ * @brief 是否启用 Linux 大页 / NUMA 存储分配器
+ *
+ * 仅用于 Linux 主机（网关、采集主机等），MCU 项目保持 0
+ *
+ * 启用后可通过 ring_buffer_storage_alloc() 为缓冲区分配：
+ * - 大页（MAP_HUGETLB）存储，减少 memcpy 时的 TLB 缺失
+ * - 绑定到指定 NUMA 节点（mbind）
+ * - 创建时预先触发缺页，首次环绕不再产生缺页中断
+ */
+#ifndef RING_BUFFER_ENABLE_LINUX_STORAGE
+#define RING_BUFFER_ENABLE_LINUX_STORAGE  0
+#endif
+
+#if RING_BUFFER_ENABLE_LINUX_STORAGE
+
+/**
+ * @brief 大页大小（字节）
+ *
+ * 需与 /proc/meminfo 中 Hugepagesize 一致
+ */
+#ifndef RING_BUFFER_HUGEPAGE_SIZE
+#define RING_BUFFER_HUGEPAGE_SIZE  (2UL * 1024 * 1024)
+#endif
+
+#endif /* RING_BUFFER_ENABLE_LINUX_STORAGE */
+
+/**
+ * @brief 是否启用文件描述符直接读写
+ *
+ * 启用后可通过 ring_buffer_fill_from_fd() / ring_buffer_drain_to_fd()
+ * 在 socket、管道、文件与缓冲区之间直接搬运数据（readv/writev），
+ * 省去中间栈缓冲区的一次拷贝
+ *
+ * 支持无锁模式与互斥锁模式，需 POSIX 环境
+ */
+#ifndef RING_BUFFER_ENABLE_FD_IO
+#define RING_BUFFER_ENABLE_FD_IO  0
+#endif
+
+/**
+ * @brief 是否启用零拷贝发送（MSG_ZEROCOPY）
+ *
+ * 启用后可通过 ring_buffer_zc_send() 直接把缓冲区页面交给内核发送，
+ * 内核确认不再引用页面后，ring_buffer_zc_reap() 才推进 tail
+ *
+ * 仅用于无锁模式的消费者侧，需 Linux 4.14+ 的 TCP/UDP socket
+ */
+#ifndef RING_BUFFER_ENABLE_ZEROCOPY
+#define RING_BUFFER_ENABLE_ZEROCOPY  0
+#endif
+
+#if RING_BUFFER_ENABLE_ZEROCOPY
+
+/**
+ * @brief 最多同时在途（未确认）的零拷贝发送次数
+ */
+#ifndef RING_BUFFER_ZC_MAX_INFLIGHT
+#define RING_BUFFER_ZC_MAX_INFLIGHT  8
+#endif
+
+#endif /* RING_BUFFER_ENABLE_ZEROCOPY */
+
+/**
+ * @brief 是否启用 io_uring 异步读写引擎
+ *
+ * 启用后一个线程可通过 ring_buffer_uring_run() 同时驱动多个缓冲区：
+ * 为每个缓冲区提交 readv（fd → 空闲区域）或 writev（可读区域 → fd），
+ * 所有请求一次 io_uring_enter() 批量提交，完成后推进 head / tail
+ *
+ * 需 Linux 5.6+，直接使用系统调用，无需 liburing
+ */
+#ifndef RING_BUFFER_ENABLE_IO_URING
+#define RING_BUFFER_ENABLE_IO_URING  0
+#endif
+
+#if RING_BUFFER_ENABLE_IO_URING
+
+/**
+ * @brief 单个引擎最多驱动的缓冲区个数
+ */
+#ifndef RING_BUFFER_URING_MAX_RINGS
+#define RING_BUFFER_URING_MAX_RINGS  32
+#endif
+
+#endif /* RING_BUFFER_ENABLE_IO_URING */
+
+/**
+ * @brief 是否启用共享内存进程间缓冲区
+ *
+ * 启用后提供 ring_buffer_shm_xxx() 接口：头部只保存偏移量，
+ * 放在 shm_open / memfd_create 映射的起始处，生产者进程与消费者进程
+ * 按无锁 SPSC 协议直接访问
+ */
+#ifndef RING_BUFFER_ENABLE_SHM
+#define RING_BUFFER_ENABLE_SHM  0
+#endif
+
+#if RING_BUFFER_ENABLE_SHM
+
+/**
+ * @brief 缓存行大小（字节），head 与 tail 分处不同缓存行，避免伪共享
+ */
+#ifndef RING_BUFFER_SHM_CACHE_LINE
+#define RING_BUFFER_SHM_CACHE_LINE  64
+#endif
+
+#endif /* RING_BUFFER_ENABLE_SHM */
+
+/* ==================== 扩展功能 ==================== */
+
+/**
+ * @brief 是否启用在线扩缩容
+ *
+ * 启用后提供 ring_buffer_resize()：把可读数据迁移到新的存储块，
+ * 不丢数据；同时启用统计功能时还提供按溢出次数自动扩容的策略
+ */
+#ifndef RING_BUFFER_ENABLE_RESIZE
+#define RING_BUFFER_ENABLE_RESIZE  0
+#endif
+
+/**
+ * @brief 是否启用分段缓冲区
+ *
+ * 启用后提供 ring_buffer_seg_create()：数据存放在从块池中按需取得的
+ * 定长块组成的链表中，写满一块再取一块，读空的块归还块池；
+ * 读写仍通过 ring_buffer_write_multi() / ring_buffer_read_multi()
+ */
+#ifndef RING_BUFFER_ENABLE_SEGMENTED
+#define RING_BUFFER_ENABLE_SEGMENTED  0
+#endif
+
+#if RING_BUFFER_ENABLE_SEGMENTED
+
+/**
+ * @brief 单块数据大小（字节）
+ */
+#ifndef RING_BUFFER_SEG_CHUNK_SIZE
+#define RING_BUFFER_SEG_CHUNK_SIZE  256
+#endif
+
+/**
+ * @brief 块池临界区
+ *
+ * 单个缓冲区内部为 SPSC 无锁协议；块池可能被多个缓冲区的生产者与
+ * 消费者同时访问，多上下文共享块池时须定义为关中断或互斥锁，例如：
+ *   #define RING_BUFFER_SEG_POOL_LOCK()   { uint32_t _pm = __get_PRIMASK(); __disable_irq();
+ *   #define RING_BUFFER_SEG_POOL_UNLOCK() __set_PRIMASK(_pm); }
+ */
+#ifndef RING_BUFFER_SEG_POOL_LOCK
+#define RING_BUFFER_SEG_POOL_LOCK()    do {
+#define RING_BUFFER_SEG_POOL_UNLOCK()  } while (0)
+#endif
+
+#endif /* RING_BUFFER_ENABLE_SEGMENTED */
+
+/**
+ * @brief 是否启用压缩缓冲区
+ *
+ * 启用后提供 ring_buffer_lz_create()：write_multi 把数据按块做 LZ 压缩后
+ * 存入缓冲区，read_multi 解压读出；重复度高的日志/遥测可在同样的 RAM 中
+ * 缓存数倍的数据
+ *
+ * 依赖无锁实现（RING_BUFFER_ENABLE_LOCKFREE），需要 GCC / Clang 原子内建函数
+ */
+#ifndef RING_BUFFER_ENABLE_LZ
+#define RING_BUFFER_ENABLE_LZ  0
+#endif
+
+#if RING_BUFFER_ENABLE_LZ
+
+/**
+ * @brief 压缩块大小（字节）
+ *
+ * 越大压缩率越高，但上下文占用 4 倍该大小的 RAM；
+ * 大于存储区容量时自动按存储区容量分块
+ */
+#ifndef RING_BUFFER_LZ_BLOCK_SIZE
+#define RING_BUFFER_LZ_BLOCK_SIZE  512
+#endif
+
+/**
+ * @brief 匹配查找表位数（表大小 2^N 项，每项 2 字节）
+ */
+#ifndef RING_BUFFER_LZ_HASH_BITS
+#define RING_BUFFER_LZ_HASH_BITS  10
+#endif
+
+#endif /* RING_BUFFER_ENABLE_LZ */
+
+/**
+ * @brief 是否启用 AES-CTR 加密缓冲区
+ *
+ * 启用后提供 ring_buffer_aes_create()：存储区中只保存密文，
+ * write_multi 写入时加密、read_multi 读出时解密，拷贝与加解密一次完成
+ *
+ * 编译器开启 AES-NI（-maes）或 ARMv8 Crypto 扩展时自动使用硬件指令，
+ * 否则使用查表实现；依赖无锁实现（RING_BUFFER_ENABLE_LOCKFREE）
+ */
+#ifndef RING_BUFFER_ENABLE_AES
+#define RING_BUFFER_ENABLE_AES  0
+#endif
+
+/**
+ * @brief 是否启用事件追踪
+ *
+ * 启用后 ring_buffer_write_multi / read_multi（以及单字节写入溢出）会向
+ * 当前线程的追踪缓冲区记录一条 16 字节的二进制事件：缓冲区编号、操作、
+ * 请求/实际长度、操作后的数据量、时间戳；ring_buffer_trace_dump() 导出后
+ * 可用 ring_buffer_trace2json 转换为 Chrome trace / Perfetto 可打开的 JSON
+ *
+ * 只有设置了追踪编号的缓冲区才记录，其余缓冲区只多一次判断；
+ * 需要 GCC / Clang 原子内建函数
+ */
+#ifndef RING_BUFFER_ENABLE_TRACE
+#define RING_BUFFER_ENABLE_TRACE  0
+#endif
+
+#if RING_BUFFER_ENABLE_TRACE
+
+/**
+ * @brief 每个线程的追踪缓冲区容量（事件数，2 的幂，写满后覆盖最旧的事件）
+ */
+#ifndef RING_BUFFER_TRACE_EVENTS
+#define RING_BUFFER_TRACE_EVENTS  1024
+#endif
+
+/**
+ * @brief 独占追踪缓冲区的线程数，同时记录的线程更多时，多出的共用一个额外的缓冲区
+ *
+ * 线程退出前调用 ring_buffer_trace_thread_exit() 归还缓冲区
+ */
+#ifndef RING_BUFFER_TRACE_MAX_THREADS
+#define RING_BUFFER_TRACE_MAX_THREADS  4
+#endif
+
+/**
+ * @brief 时间戳来源与单位
+ *
+ * 未定义 RING_BUFFER_TRACE_TIMESTAMP() 时使用 CLOCK_MONOTONIC（纳秒）；
+ * MCU 上可改用周期计数器，例如：
+ *   #define RING_BUFFER_TRACE_TIMESTAMP()   (DWT->CYCCNT)
+ *   #define RING_BUFFER_TRACE_TICKS_PER_US  (SystemCoreClock / 1000000)
+ */
+#ifndef RING_BUFFER_TRACE_TICKS_PER_US
+#define RING_BUFFER_TRACE_TICKS_PER_US  1000
+#endif
+
+/**
+ * @brief 线程局部存储说明符
+ *
+ * 裸机无 TLS 时为空，所有上下文共用第一个追踪缓冲区
+ */
+#ifndef RING_BUFFER_TRACE_TLS
+#if defined(__unix__) || defined(__APPLE__)
+#define RING_BUFFER_TRACE_TLS  __thread
+#else
+#define RING_BUFFER_TRACE_TLS
+#endif
+#endif
+
+#endif /* RING_BUFFER_ENABLE_TRACE */
+
+/**
+ * @brief 是否启用一致性快照
+ *
+ * 启用后提供 ring_buffer_snapshot()：监控线程不加锁地读出同一时刻的
+ * head / tail / 数据量与统计计数。生产者侧、消费者侧各维护一个序号，
+ * 修改索引或计数前后各自增一次；读者发现序号为奇数或前后不一致就重读
+ *
+ * 数据路径每次修改只多两次序号写入，不加锁、不原子读改写；
+ * 未启用时没有任何开销
+ */
+#ifndef RING_BUFFER_ENABLE_SNAPSHOT
+#define RING_BUFFER_ENABLE_SNAPSHOT  0
+#endif
+
+#if RING_BUFFER_ENABLE_SNAPSHOT
+
+/**
+ * @brief 快照最多重读次数
+ *
+ * 写者在修改窗口内被抢占时读者不会一直等待，超过次数返回 false，稍后再取
+ */
+#ifndef RING_BUFFER_SNAPSHOT_RETRIES
+#define RING_BUFFER_SNAPSHOT_RETRIES  16
+#endif
+
+#endif /* RING_BUFFER_ENABLE_SNAPSHOT */
+
+/**
+ * @brief 是否启用多缓冲区选择器（ring set）
+ *
+ * 启用后多个缓冲区可加入同一个 ring_buffer_set_t：生产者在缓冲区
+ * 由空变为非空时置位就绪位图，消费者按优先级或轮询顺序取出就绪缓冲区，
+ * 无需逐个 ring_buffer_is_empty() 轮询
+ *
+ * 需要 GCC / Clang 原子内建函数（含 ARM Compiler 6）
+ */
+#ifndef RING_BUFFER_ENABLE_RING_SET
+#define RING_BUFFER_ENABLE_RING_SET  0
+#endif
+
+#if RING_BUFFER_ENABLE_RING_SET
+
+/**
+ * @brief 单个选择器最多容纳的缓冲区个数（<= 32，位图宽度）
+ */
+#ifndef RING_BUFFER_SET_MAX_RINGS
+#define RING_BUFFER_SET_MAX_RINGS  32
+#endif
+
+#endif /* RING_BUFFER_ENABLE_RING_SET */
+
+/**
+ * @brief 是否启用优先级缓冲区组
+ *
+ * 启用后多个缓冲区可按优先级组成一组，ring_buffer_group_read() 一次调用
+ * 即按优先级与配额从合适的缓冲区读出数据；配额防止低优先级饿死
+ */
+#ifndef RING_BUFFER_ENABLE_GROUP
+#define RING_BUFFER_ENABLE_GROUP  0
+#endif
+
+#if RING_BUFFER_ENABLE_GROUP
+
+/**
+ * @brief 单个组最多容纳的缓冲区个数
+ */
+#ifndef RING_BUFFER_GROUP_MAX_RINGS
+#define RING_BUFFER_GROUP_MAX_RINGS  8
+#endif
+
+#endif /* RING_BUFFER_ENABLE_GROUP */
+
+/**
+ * @brief 是否启用分片缓冲区（可扩展的多生产者单消费者）
+ *
+ * 启用后提供 ring_buffer_shard_init()：每个生产者线程 / 核独占一个无锁
+ * SPSC 分片，生产者之间不共享任何缓存行；消费者按轮询或时间戳顺序
+ * 从各分片取出整条记录
+ *
+ * 依赖无锁实现（RING_BUFFER_ENABLE_LOCKFREE），需要 GCC / Clang 原子内建函数
+ */
+#ifndef RING_BUFFER_ENABLE_SHARD
+#define RING_BUFFER_ENABLE_SHARD  0
+#endif
+
+#if RING_BUFFER_ENABLE_SHARD
+
+/**
+ * @brief 最多分片数（生产者数）
+ */
+#ifndef RING_BUFFER_SHARD_MAX
+#define RING_BUFFER_SHARD_MAX  8
+#endif
+
+#if RING_BUFFER_SHARD_MAX < 1 || RING_BUFFER_SHARD_MAX > 255
+#error "RING_BUFFER_SHARD_MAX 必须在 1 ~ 255 之间"
+#endif
+
+/**
+ * @brief 分片控制结构对齐（缓存行大小），各分片的 head / tail 互不共享缓存行
+ */
+#ifndef RING_BUFFER_SHARD_CACHE_LINE
+#define RING_BUFFER_SHARD_CACHE_LINE  64
+#endif
+
+#endif /* RING_BUFFER_ENABLE_SHARD */
+
+/**
+ * @brief 是否启用掉电/崩溃可恢复缓冲区
+ *
+ * 启用后提供 ring_buffer_persist_open()：数据与 head / tail 都放在
+ * 持久区域（mmap 文件或电池备份 SRAM），重启后恢复可读区域
+ *
+ * 依赖无锁实现（RING_BUFFER_ENABLE_LOCKFREE）
+ */
+#ifndef RING_BUFFER_ENABLE_PERSIST
+#define RING_BUFFER_ENABLE_PERSIST  0
+#endif
+
+#if RING_BUFFER_ENABLE_PERSIST
+
+/**
+ * @brief ring_buffer_persist_sync() 是否调用 msync()
+ *
+ * 0 = 仅内存屏障（SRAM / 只需抵御进程崩溃）
+ * 1 = 额外 msync() 整个区域（mmap 文件且需抵御系统掉电）
+ */
+#ifndef RING_BUFFER_PERSIST_MSYNC
+#define RING_BUFFER_PERSIST_MSYNC  0
+#endif
+
+#endif /* RING_BUFFER_ENABLE_PERSIST */
+
+/**
+ * @brief 是否启用带 CRC 的批量读写
+ *
+ * 启用后提供 ring_buffer_write_multi_crc() / ring_buffer_read_multi_crc()，
+ * 拷贝的同时计算 CRC，数据只遍历一次
+ *
+ * 支持 CRC-16/CCITT-FALSE、CRC-16/MODBUS、CRC-32、CRC-32C；
+ * 查表实现约占 3 KB Flash，SSE4.2 / ARMv8 CRC 指令可用时自动使用硬件加速
+ */
+#ifndef RING_BUFFER_ENABLE_CRC
+#define RING_BUFFER_ENABLE_CRC  0
+#endif
+
 /* ==================== 性能调优参数 ==================== */
 
 /**
@@ -260,6 +831,21 @@ extern "C" {
 #define RING_BUFFER_MIN_SIZE  2
 #endif
 
+/**
+ * @brief 自定义策略注册表容量
+ *
+ * 可注册的类型范围为
+ * [RING_BUFFER_TYPE_CUSTOM_BASE, RING_BUFFER_TYPE_CUSTOM_BASE + RING_BUFFER_MAX_CUSTOM_OPS)，
+ * 每项占一个指针
+ */
+#ifndef RING_BUFFER_MAX_CUSTOM_OPS
+#define RING_BUFFER_MAX_CUSTOM_OPS  8
+#endif
+
+#if 3 + RING_BUFFER_MAX_CUSTOM_OPS > 0x80
+#error "RING_BUFFER_MAX_CUSTOM_OPS 过大，自定义区间与 0x80 起的内置策略类型重叠"
+#endif
+
 /**
  * @brief 是否启用参数检查
  * 
@@ -280,6 +866,39 @@ extern "C" {
 #define RING_BUFFER_ENABLE_STATISTICS  0
 #endif
 
+/**
+ * @brief 小块拷贝内联阈值（字节）
+ *
+ * 批量读写中不超过该长度的拷贝使用内联拷贝内核（SSE2/AVX2/NEON/标量），
+ * 省去 memcpy 的调用与长度分派开销；超过该长度仍调用 memcpy
+ *
+ * 设为 0 则始终使用 memcpy
+ */
+#ifndef RING_BUFFER_SMALL_COPY_MAX
+#define RING_BUFFER_SMALL_COPY_MAX  64
+#endif
+
+/**
+ * @brief 大块流式读写阈值（字节）
+ *
+ * 批量读写长度达到该阈值时：
+ * - 写入使用非临时（streaming）存储，数据绕过缓存直接写内存，
+ *   不挤占消费者的工作集；发布 head 前插入写屏障
+ * - 读取边拷贝边预取后续缓存行（非临时提示）
+ *
+ * 设为 0 则禁用（默认）。仅 x86 SSE2 有非临时存储，其他平台只启用预取
+ */
+#ifndef RING_BUFFER_STREAM_THRESHOLD
+#define RING_BUFFER_STREAM_THRESHOLD  0
+#endif
+
+/**
+ * @brief 流式读取的预取距离（字节）
+ */
+#ifndef RING_BUFFER_PREFETCH_DISTANCE
+#define RING_BUFFER_PREFETCH_DISTANCE  256
+#endif
+
 /* ==================== 调试选项 ==================== */
 
 /**
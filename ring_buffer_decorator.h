@@ -0,0 +1,336 @@
+/**
+ * @file    ring_buffer_decorator.h
+ * @brief   策略装饰器 - 编译期把横切关注点叠加到核心实现上
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 自定义策略需要加锁 / 关中断，但不想手写全部操作
+ * - 多个关注点叠加（例如 互斥锁 + 调用计数）
+ *
+ * 统计与追踪不是层：统计在 rb_commit_write / rb_commit_read 中计数，
+ * 追踪在 ring_buffer.c 入口记录，所有策略自动获得，无需叠加
+ *
+ * 实现方式：
+ * - RING_BUFFER_DECORATE(P, CORE, ENTER, EXIT) 为每个操作生成 static 包装函数
+ *   P_write / P_read / ...，函数体为 ENTER → 直接调用 CORE_xxx → EXIT
+ * - CORE 是函数名前缀：可以是无锁核心 rb_lockfree，也可以是另一层装饰的 P，
+ *   层与层之间都是直接调用，编译器可内联，不会每层多一次函数指针跳转
+ * - RING_BUFFER_DECORATED_OPS(P) 生成对应的操作表初始化列表
+ * - 整条调用链只有 ring_buffer.c 入口处的一次间接调用
+ *
+ * 层的写法：
+ * - ENTER(rb, op)      在核心调用前展开，可声明局部变量（如保存的中断状态）
+ * - EXIT(rb, op, ret)  在核心调用后展开，ret 为返回值（clear 为 0）
+ * - op 为 ring_buffer_op_t 常量（ring_buffer.h），不关心的层直接忽略
+ *
+ * 使用示例：
+ * @code
+ * #define MY_ENTER(rb, op)       RB_LAYER_MUTEX_ENTER(rb, op); my_count[op]++
+ * #define MY_EXIT(rb, op, ret)   RB_LAYER_MUTEX_EXIT(rb, op, ret)
+ *
+ * RING_BUFFER_DECORATE(my, rb_lockfree, MY_ENTER, MY_EXIT)
+ *
+ * static const struct ring_buffer_ops my_ops = RING_BUFFER_DECORATED_OPS(my);
+ *
+ * ring_buffer_register_ops(RING_BUFFER_TYPE_CUSTOM_BASE, &my_ops);
+ * @endcode
+ *
+ * @note 组合发生在编译期；跨翻译单元调用 rb_lockfree_xxx 时需 -flto 才能完全内联
+ */
+
+#ifndef __RING_BUFFER_DECORATOR_H
+#define __RING_BUFFER_DECORATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "ring_buffer.h"
+
+/* ==================== 无锁核心 ==================== */
+
+#if RING_BUFFER_ENABLE_LOCKFREE
+
+/**
+ * @brief 无锁实现的各个操作（ring_buffer_lockfree.c / ring_buffer_fd.c）
+ *
+ * 作为 RING_BUFFER_DECORATE 的 CORE 使用（前缀 rb_lockfree）
+ */
+bool rb_lockfree_write(ring_buffer_t *rb, uint8_t data);
+bool rb_lockfree_read(ring_buffer_t *rb, uint8_t *data);
+uint16_t rb_lockfree_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len);
+uint16_t rb_lockfree_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len);
+uint16_t rb_lockfree_available(const ring_buffer_t *rb);
+uint16_t rb_lockfree_free_space(const ring_buffer_t *rb);
+bool rb_lockfree_is_empty(const ring_buffer_t *rb);
+bool rb_lockfree_is_full(const ring_buffer_t *rb);
+void rb_lockfree_clear(ring_buffer_t *rb);
+uint16_t rb_lockfree_writev(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt);
+uint16_t rb_lockfree_readv(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt);
+
+#if RING_BUFFER_ENABLE_CRC
+uint16_t rb_lockfree_write_multi_crc(ring_buffer_t *rb, const uint8_t *data, uint16_t len,
+                                     ring_buffer_crc_type_t type, uint32_t *crc);
+uint16_t rb_lockfree_read_multi_crc(ring_buffer_t *rb, uint8_t *data, uint16_t len,
+                                    ring_buffer_crc_type_t type, uint32_t *crc);
+#endif
+
+#if RING_BUFFER_ENABLE_FD_IO
+ssize_t rb_lockfree_fill_from_fd(ring_buffer_t *rb, int fd, uint16_t max);
+ssize_t rb_lockfree_drain_to_fd(ring_buffer_t *rb, int fd, uint16_t max);
+#endif
+
+#if RING_BUFFER_ENABLE_RESIZE
+bool rb_lockfree_resize(ring_buffer_t *rb, uint8_t *buffer, uint16_t size,
+                        uint8_t **old, uint16_t *old_size);
+#endif
+
+#endif /* RING_BUFFER_ENABLE_LOCKFREE */
+
+/* ==================== 内置层 ==================== */
+
+/**
+ * @brief 空层（只需要 ENTER 或只需要 EXIT 时占位）
+ */
+#define RB_LAYER_NONE_ENTER(rb, op)         do { } while (0)
+#define RB_LAYER_NONE_EXIT(rb, op, ret)     do { } while (0)
+
+#if RING_BUFFER_ENABLE_DISABLE_IRQ
+/**
+ * @brief 关中断层（中断控制宏在 ring_buffer_config.h 中定义）
+ */
+#define RB_LAYER_IRQ_ENTER(rb, op)          irq_state_t _rb_irq; IRQ_SAVE(_rb_irq)
+#define RB_LAYER_IRQ_EXIT(rb, op, ret)      IRQ_RESTORE(_rb_irq)
+#endif
+
+#if RING_BUFFER_ENABLE_MUTEX
+/**
+ * @brief 互斥锁层（锁由 ring_buffer_mutex_init 存入 rb->lock）
+ */
+#define RB_LAYER_MUTEX_ENTER(rb, op)        mutex_t _rb_mutex = (mutex_t)(rb)->lock; MUTEX_LOCK(_rb_mutex)
+#define RB_LAYER_MUTEX_EXIT(rb, op, ret)    MUTEX_UNLOCK(_rb_mutex)
+#endif
+
+#if RING_BUFFER_ENABLE_SPINLOCK
+/**
+ * @brief 获取自旋锁
+ *
+ * - TTAS：交换失败后只读等待（不产生总线写），每轮 PAUSE 次数翻倍至上限，
+ *   到达上限后每轮让出一次 CPU
+ * - 票据锁：按排队距离成比例等待，先来先服务
+ */
+static inline void rb_spin_lock(ring_buffer_spin_t *lock)
+{
+#if RING_BUFFER_SPINLOCK_TICKET
+    uint16_t ticket = __atomic_fetch_add(&lock->next, 1, __ATOMIC_RELAXED);
+
+    for (;;) {
+        uint16_t dist = (uint16_t)(ticket - __atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE));
+
+        if (dist == 0) {
+            return;
+        }
+        /* 前面每个持锁者大约需要 16 次 PAUSE，排得太靠后则先让出 CPU */
+        uint32_t spins = (uint32_t)dist * 16;
+
+        if (spins > RING_BUFFER_SPIN_BACKOFF_MAX) {
+            spins = RING_BUFFER_SPIN_BACKOFF_MAX;
+            RING_BUFFER_SPIN_YIELD();
+        }
+        for (uint32_t i = 0; i < spins; i++) {
+            RING_BUFFER_SPIN_PAUSE();
+        }
+    }
+#else
+    uint32_t backoff = 1;
+
+    while (__atomic_exchange_n(&lock->owner, 1, __ATOMIC_ACQUIRE) != 0) {
+        do {
+            for (uint32_t i = 0; i < backoff; i++) {
+                RING_BUFFER_SPIN_PAUSE();
+            }
+            if (backoff < RING_BUFFER_SPIN_BACKOFF_MAX) {
+                backoff <<= 1;
+            } else {
+                RING_BUFFER_SPIN_YIELD();
+            }
+        } while (__atomic_load_n(&lock->owner, __ATOMIC_RELAXED) != 0);
+    }
+#endif
+}
+
+/**
+ * @brief 释放自旋锁
+ */
+static inline void rb_spin_unlock(ring_buffer_spin_t *lock)
+{
+#if RING_BUFFER_SPINLOCK_TICKET
+    __atomic_store_n(&lock->owner, (uint16_t)(lock->owner + 1), __ATOMIC_RELEASE);
+#else
+    __atomic_store_n(&lock->owner, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * @brief 自旋锁层（锁字为 rb->spin；RING_BUFFER_SPINLOCK_IRQ 时先关本核中断）
+ */
+#if RING_BUFFER_SPINLOCK_IRQ
+#define RB_LAYER_SPIN_ENTER(rb, op)         RB_LAYER_IRQ_ENTER(rb, op); \
+                                            rb_spin_lock((ring_buffer_spin_t *)&(rb)->spin)
+#define RB_LAYER_SPIN_EXIT(rb, op, ret)     rb_spin_unlock((ring_buffer_spin_t *)&(rb)->spin); \
+                                            RB_LAYER_IRQ_EXIT(rb, op, ret)
+#else
+#define RB_LAYER_SPIN_ENTER(rb, op)         rb_spin_lock((ring_buffer_spin_t *)&(rb)->spin)
+#define RB_LAYER_SPIN_EXIT(rb, op, ret)     rb_spin_unlock((ring_buffer_spin_t *)&(rb)->spin)
+#endif
+#endif /* RING_BUFFER_ENABLE_SPINLOCK */
+
+/* ==================== 生成器 ==================== */
+
+/**
+ * @brief 生成单个有返回值的包装函数
+ */
+#define RB_DECORATE_FN(P, CORE, ENTER, EXIT, OP, RET, NAME, PARAMS, ARGS) \
+    static RET P##_##NAME PARAMS                                          \
+    {                                                                     \
+        ENTER(rb, OP);                                                    \
+        RET _rb_ret = CORE##_##NAME ARGS;                                 \
+        EXIT(rb, OP, _rb_ret);                                            \
+        return _rb_ret;                                                   \
+    }
+
+#if RING_BUFFER_ENABLE_CRC
+#define RB_DECORATE_CRC_(P, CORE, ENTER, EXIT)                                              \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_WRITE_MULTI_CRC, uint16_t,          \
+                   write_multi_crc,                                                         \
+                   (ring_buffer_t *rb, const uint8_t *data, uint16_t len,                   \
+                    ring_buffer_crc_type_t type, uint32_t *crc),                            \
+                   (rb, data, len, type, crc))                                              \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_READ_MULTI_CRC, uint16_t,           \
+                   read_multi_crc,                                                          \
+                   (ring_buffer_t *rb, uint8_t *data, uint16_t len,                         \
+                    ring_buffer_crc_type_t type, uint32_t *crc),                            \
+                   (rb, data, len, type, crc))
+#define RB_DECORATED_CRC_(P)  .write_multi_crc = P##_write_multi_crc, \
+                              .read_multi_crc  = P##_read_multi_crc,
+#else
+#define RB_DECORATE_CRC_(P, CORE, ENTER, EXIT)
+#define RB_DECORATED_CRC_(P)
+#endif
+
+#if RING_BUFFER_ENABLE_FD_IO
+#define RB_DECORATE_FD_(P, CORE, ENTER, EXIT)                                               \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_FILL_FROM_FD, ssize_t,              \
+                   fill_from_fd, (ring_buffer_t *rb, int fd, uint16_t max), (rb, fd, max))  \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_DRAIN_TO_FD, ssize_t,               \
+                   drain_to_fd, (ring_buffer_t *rb, int fd, uint16_t max), (rb, fd, max))
+#define RB_DECORATED_FD_(P)   .fill_from_fd    = P##_fill_from_fd, \
+                              .drain_to_fd     = P##_drain_to_fd,
+#else
+#define RB_DECORATE_FD_(P, CORE, ENTER, EXIT)
+#define RB_DECORATED_FD_(P)
+#endif
+
+#if RING_BUFFER_ENABLE_RESIZE
+#define RB_DECORATE_RESIZE_(P, CORE, ENTER, EXIT)                                           \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_RESIZE, bool, resize,               \
+                   (ring_buffer_t *rb, uint8_t *buffer, uint16_t size,                      \
+                    uint8_t **old, uint16_t *old_size),                                     \
+                   (rb, buffer, size, old, old_size))
+#define RB_DECORATED_RESIZE_(P) .resize        = P##_resize,
+#else
+#define RB_DECORATE_RESIZE_(P, CORE, ENTER, EXIT)
+#define RB_DECORATED_RESIZE_(P)
+#endif
+
+/**
+ * @brief 生成修改类操作的包装函数（读写、清空、CRC、文件描述符、扩缩容）
+ */
+#define RING_BUFFER_DECORATE_UPDATES(P, CORE, ENTER, EXIT)                                  \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_WRITE, bool, write,                 \
+                   (ring_buffer_t *rb, uint8_t data), (rb, data))                           \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_READ, bool, read,                   \
+                   (ring_buffer_t *rb, uint8_t *data), (rb, data))                          \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_WRITE_MULTI, uint16_t, write_multi, \
+                   (ring_buffer_t *rb, const uint8_t *data, uint16_t len), (rb, data, len)) \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_READ_MULTI, uint16_t, read_multi,   \
+                   (ring_buffer_t *rb, uint8_t *data, uint16_t len), (rb, data, len))       \
+    static void P##_clear(ring_buffer_t *rb)                                                \
+    {                                                                                       \
+        ENTER(rb, RING_BUFFER_OP_CLEAR);                                                    \
+        CORE##_clear(rb);                                                                   \
+        EXIT(rb, RING_BUFFER_OP_CLEAR, 0);                                                  \
+    }                                                                                       \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_WRITEV, uint16_t, writev,           \
+                   (ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt),     \
+                   (rb, iov, iovcnt))                                                       \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_READV, uint16_t, readv,             \
+                   (ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt),     \
+                   (rb, iov, iovcnt))                                                       \
+    RB_DECORATE_CRC_(P, CORE, ENTER, EXIT)                                                  \
+    RB_DECORATE_FD_(P, CORE, ENTER, EXIT)                                                   \
+    RB_DECORATE_RESIZE_(P, CORE, ENTER, EXIT)
+
+/**
+ * @brief 生成状态查询的包装函数（available / free_space / is_empty / is_full）
+ */
+#define RING_BUFFER_DECORATE_QUERIES(P, CORE, ENTER, EXIT)                                  \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_AVAILABLE, uint16_t, available,     \
+                   (const ring_buffer_t *rb), (rb))                                         \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_FREE_SPACE, uint16_t, free_space,   \
+                   (const ring_buffer_t *rb), (rb))                                         \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_IS_EMPTY, bool, is_empty,           \
+                   (const ring_buffer_t *rb), (rb))                                         \
+    RB_DECORATE_FN(P, CORE, ENTER, EXIT, RING_BUFFER_OP_IS_FULL, bool, is_full,             \
+                   (const ring_buffer_t *rb), (rb))
+
+/**
+ * @brief 生成一整套包装函数
+ *
+ * @param P      生成函数的前缀（P_write、P_read ...）
+ * @param CORE   被包装实现的前缀（rb_lockfree 或上一层的 P）
+ * @param ENTER  进入层的宏 ENTER(rb, op)
+ * @param EXIT   退出层的宏 EXIT(rb, op, ret)
+ *
+ * @note 生成的函数都是 static，需要替换某个操作时照常手写一个并在操作表中覆盖；
+ *       查询另有实现时改用 RING_BUFFER_DECORATE_UPDATES 与
+ *       RING_BUFFER_DECORATED_OPS_QUERIES_FROM，避免生成用不到的查询函数
+ */
+#define RING_BUFFER_DECORATE(P, CORE, ENTER, EXIT)   \
+    RING_BUFFER_DECORATE_UPDATES(P, CORE, ENTER, EXIT) \
+    RING_BUFFER_DECORATE_QUERIES(P, CORE, ENTER, EXIT)
+
+/**
+ * @brief 生成操作表初始化列表：修改类操作取自 P，状态查询取自 Q
+ */
+#define RING_BUFFER_DECORATED_OPS_QUERIES_FROM(P, Q) {  \
+    .write       = P##_write,           \
+    .read        = P##_read,            \
+    .write_multi = P##_write_multi,     \
+    .read_multi  = P##_read_multi,      \
+    .available   = Q##_available,       \
+    .free_space  = Q##_free_space,      \
+    .is_empty    = Q##_is_empty,        \
+    .is_full     = Q##_is_full,         \
+    .clear       = P##_clear,           \
+    .writev      = P##_writev,          \
+    .readv       = P##_readv,           \
+    RB_DECORATED_CRC_(P)                \
+    RB_DECORATED_FD_(P)                 \
+    RB_DECORATED_RESIZE_(P)             \
+}
+
+/**
+ * @brief 生成操作表初始化列表（与 RING_BUFFER_DECORATE 的 P 对应）
+ */
+#define RING_BUFFER_DECORATED_OPS(P)  RING_BUFFER_DECORATED_OPS_QUERIES_FROM(P, P)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RING_BUFFER_DECORATOR_H */
@@ -20,127 +20,19 @@
  * - 不适用于多核系统
  */
 
-#include "ring_buffer.h"
+#include "ring_buffer_decorator.h"
 
 #if RING_BUFFER_ENABLE_DISABLE_IRQ
 
 /* 中断控制宏在 ring_buffer_config.h 中定义 */
 
-/* 复用无锁实现的内部逻辑 */
-extern const struct ring_buffer_ops ring_buffer_lockfree_ops;
-
 /* Exported functions (Implementation) ---------------------------------------*/
 
-static bool disable_irq_write(ring_buffer_t *rb, uint8_t data)
-{
-    irq_state_t state;
-    IRQ_SAVE(state);
-    
-    bool ret = ring_buffer_lockfree_ops.write(rb, data);
-    
-    IRQ_RESTORE(state);
-    return ret;
-}
-
-static bool disable_irq_read(ring_buffer_t *rb, uint8_t *data)
-{
-    irq_state_t state;
-    IRQ_SAVE(state);
-    
-    bool ret = ring_buffer_lockfree_ops.read(rb, data);
-    
-    IRQ_RESTORE(state);
-    return ret;
-}
-
-static uint16_t disable_irq_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
-{
-    irq_state_t state;
-    IRQ_SAVE(state);
-    
-    uint16_t ret = ring_buffer_lockfree_ops.write_multi(rb, data, len);
-    
-    IRQ_RESTORE(state);
-    return ret;
-}
-
-static uint16_t disable_irq_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
-{
-    irq_state_t state;
-    IRQ_SAVE(state);
-    
-    uint16_t ret = ring_buffer_lockfree_ops.read_multi(rb, data, len);
-    
-    IRQ_RESTORE(state);
-    return ret;
-}
-
-static uint16_t disable_irq_available(const ring_buffer_t *rb)
-{
-    irq_state_t state;
-    IRQ_SAVE(state);
-    
-    uint16_t ret = ring_buffer_lockfree_ops.available(rb);
-    
-    IRQ_RESTORE(state);
-    return ret;
-}
-
-static uint16_t disable_irq_free_space(const ring_buffer_t *rb)
-{
-    irq_state_t state;
-    IRQ_SAVE(state);
-    
-    uint16_t ret = ring_buffer_lockfree_ops.free_space(rb);
-    
-    IRQ_RESTORE(state);
-    return ret;
-}
-
-static bool disable_irq_is_empty(const ring_buffer_t *rb)
-{
-    irq_state_t state;
-    IRQ_SAVE(state);
-    
-    bool ret = ring_buffer_lockfree_ops.is_empty(rb);
-    
-    IRQ_RESTORE(state);
-    return ret;
-}
-
-static bool disable_irq_is_full(const ring_buffer_t *rb)
-{
-    irq_state_t state;
-    IRQ_SAVE(state);
-    
-    bool ret = ring_buffer_lockfree_ops.is_full(rb);
-    
-    IRQ_RESTORE(state);
-    return ret;
-}
-
-static void disable_irq_clear(ring_buffer_t *rb)
-{
-    irq_state_t state;
-    IRQ_SAVE(state);
-    
-    ring_buffer_lockfree_ops.clear(rb);
-    
-    IRQ_RESTORE(state);
-}
+/* 每个操作：关中断 → 直接调用无锁实现 → 恢复中断 */
+RING_BUFFER_DECORATE(disable_irq, rb_lockfree, RB_LAYER_IRQ_ENTER, RB_LAYER_IRQ_EXIT)
 
 /* Exported constant ---------------------------------------------------------*/
 
-const struct ring_buffer_ops ring_buffer_disable_irq_ops = {
-    .write       = disable_irq_write,
-    .read        = disable_irq_read,
-    .write_multi = disable_irq_write_multi,
-    .read_multi  = disable_irq_read_multi,
-    .available   = disable_irq_available,
-    .free_space  = disable_irq_free_space,
-    .is_empty    = disable_irq_is_empty,
-    .is_full     = disable_irq_is_full,
-    .clear       = disable_irq_clear,
-};
+const struct ring_buffer_ops ring_buffer_disable_irq_ops = RING_BUFFER_DECORATED_OPS(disable_irq);
 
 #endif /* RING_BUFFER_ENABLE_DISABLE_IRQ */
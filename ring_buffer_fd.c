@@ -0,0 +1,82 @@
+/**
+ * @file    ring_buffer_fd.c
+ * @brief   环形缓冲区文件描述符直接读写
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - Linux 网关：socket / 串口设备 → 缓冲区 → 处理线程
+ * - 日志落盘：缓冲区 → 文件
+ *
+ * 实现方式：
+ * - 空闲区域 / 可读区域最多两段，直接作为 readv()/writev() 的 iovec
+ * - 按系统调用实际搬运的字节数推进 head / tail
+ * - 相比"read 到栈缓冲区再 write_multi"少一次拷贝
+ *
+ * @note 本文件提供无锁实现，互斥锁模式在其外层加锁
+ */
+
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_FD_IO
+
+#include <sys/uio.h>
+
+/* Private functions ---------------------------------------------------------*/
+
+static inline int spans_to_iovec(const rb_spans_t *sp, struct iovec iov[2])
+{
+    iov[0].iov_base = sp->ptr[0];
+    iov[0].iov_len = sp->len[0];
+    iov[1].iov_base = sp->ptr[1];
+    iov[1].iov_len = sp->len[1];
+    
+    return (sp->len[1] > 0) ? 2 : 1;
+}
+
+/* Exported functions (for strategies) ---------------------------------------*/
+
+ssize_t rb_lockfree_fill_from_fd(ring_buffer_t *rb, int fd, uint16_t max)
+{
+    rb_spans_t sp;
+    struct iovec iov[2];
+    
+    if (rb_write_spans(rb, max, &sp) == 0) {
+#if RING_BUFFER_ENABLE_STATISTICS
+        if (max > 0) rb_stat_overflow(rb);
+#endif
+        return 0;
+    }
+    
+    ssize_t n = readv(fd, iov, spans_to_iovec(&sp, iov));
+    if (n <= 0) {
+        return n;
+    }
+    
+    rb_commit_write(rb, (uint16_t)n);
+    
+    return n;
+}
+
+ssize_t rb_lockfree_drain_to_fd(ring_buffer_t *rb, int fd, uint16_t max)
+{
+    rb_spans_t sp;
+    struct iovec iov[2];
+    
+    if (rb_read_spans(rb, max, &sp) == 0) {
+        return 0;
+    }
+    
+    ssize_t n = writev(fd, iov, spans_to_iovec(&sp, iov));
+    if (n <= 0) {
+        return n;
+    }
+    
+    rb_commit_read(rb, (uint16_t)n);
+    
+    return n;
+}
+
+#endif /* RING_BUFFER_ENABLE_FD_IO */
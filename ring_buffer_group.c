@@ -0,0 +1,122 @@
+/**
+ * @file    ring_buffer_group.c
+ * @brief   优先级缓冲区组
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 紧急控制消息与批量遥测分别放在不同缓冲区
+ * - 分发器一次调用取出"当前最该处理"的数据
+ *
+ * 调度规则（带配额的多级队列）：
+ * - 按优先级从高到低，找到第一个有数据且本轮还有配额的成员
+ * - 读出不超过剩余配额的数据，并扣减配额
+ * - 没有这样的成员时（有数据的成员都用完了配额），重置配额开始新一轮
+ * - 配额为 0 的成员不受限制，等同严格优先级
+ */
+
+#include "ring_buffer.h"
+
+#if RING_BUFFER_ENABLE_GROUP
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief 查找优先级最高且可读的成员
+ *
+ * @return 成员编号，无则返回 -1
+ */
+static int group_pick(const ring_buffer_group_t *group)
+{
+    for (uint8_t i = 0; i < group->count; i++) {
+        const ring_buffer_group_member_t *m = &group->members[i];
+
+        if ((m->quota == 0 || m->credit > 0) && !ring_buffer_is_empty(m->rb)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void group_refill(ring_buffer_group_t *group)
+{
+    for (uint8_t i = 0; i < group->count; i++) {
+        group->members[i].credit = group->members[i].quota;
+    }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+void ring_buffer_group_init(ring_buffer_group_t *group)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (group == NULL) {
+        return;
+    }
+#endif
+
+    memset(group, 0, sizeof(*group));
+}
+
+int ring_buffer_group_add(ring_buffer_group_t *group, ring_buffer_t *rb, uint16_t quota)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (group == NULL || rb == NULL || rb->ops == NULL) {
+        return -1;
+    }
+#endif
+
+    if (group->count >= RING_BUFFER_GROUP_MAX_RINGS) {
+        return -1;
+    }
+
+    ring_buffer_group_member_t *m = &group->members[group->count];
+
+    m->rb = rb;
+    m->quota = quota;
+    m->credit = quota;
+
+    return group->count++;
+}
+
+uint16_t ring_buffer_group_read(ring_buffer_group_t *group, uint8_t *data, uint16_t len, int *src)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (group == NULL || data == NULL || len == 0) {
+        return 0;
+    }
+#endif
+
+    int i = group_pick(group);
+
+    if (i < 0) {
+        group_refill(group);
+        i = group_pick(group);
+        if (i < 0) {
+            return 0;
+        }
+    }
+
+    ring_buffer_group_member_t *m = &group->members[i];
+    uint16_t n = len;
+
+    if (m->quota != 0 && n > m->credit) {
+        n = m->credit;
+    }
+
+    n = ring_buffer_read_multi(m->rb, data, n);
+
+    if (m->quota != 0) {
+        m->credit -= n;
+    }
+
+    if (src != NULL) {
+        *src = i;
+    }
+
+    return n;
+}
+
+#endif /* RING_BUFFER_ENABLE_GROUP */
@@ -0,0 +1,547 @@
+/**
+ * @file    ring_buffer_internal.h
+ * @brief   环形缓冲区内部头文件 - 仅供实现文件使用
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 收纳各实现文件共用的内部工具：
+ * - 索引计算与连续区段（环绕时拆成两段）
+ * - 小块拷贝内核（编译期按指令集选择）
+ * - 大块流式拷贝（非临时存储 / 预取）
+ * - 拷贝并计算 CRC
+ * - 文件描述符直接读写（无锁实现）
+ * - 快照序号与统计计数
+ * - 多缓冲区选择器的就绪通知
+ * - 事件追踪记录
+ *
+ * @warning 应用层请勿包含本文件，接口随时可能变化
+ */
+
+#ifndef __RING_BUFFER_INTERNAL_H
+#define __RING_BUFFER_INTERNAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "ring_buffer.h"
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/* ==================== 索引与连续区段 ==================== */
+
+/**
+ * @brief 环形存储区中的连续区段
+ *
+ * @note 不环绕时 len[1] == 0
+ */
+typedef struct {
+    uint8_t *ptr[2];
+    uint16_t len[2];
+} rb_spans_t;
+
+static inline uint16_t rb_available(const ring_buffer_t *rb)
+{
+    uint16_t head = rb->head;
+    uint16_t tail = rb->tail;
+    
+    if (head >= tail) {
+        return head - tail;
+    } else {
+        return rb->size - tail + head;
+    }
+}
+
+static inline uint16_t rb_free_space(const ring_buffer_t *rb)
+{
+    return rb->size - 1 - rb_available(rb);
+}
+
+#if defined(__GNUC__)
+#define RB_LOAD_ACQUIRE(p)  __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#else
+#define RB_LOAD_ACQUIRE(p)  (*(p))
+#endif
+
+/**
+ * @brief 不加锁计算可读数据量（多生产者/多消费者策略的状态查询）
+ *
+ * head 夹在两次读 tail 之间读取：两次 tail 相同，说明读 head 的时刻 tail
+ * 正是该值，二者构成同一时刻的一对索引；消费者恰在这几条指令间提交时重读。
+ * size 在索引前后各读一次，扩缩容恰在其间发生时重读
+ *
+ * @param size 输出：计算所用的容量，调用者须用它而非再读 rb->size
+ *
+ * @note 结果是调用期间某一时刻的准确值，始终在 [0, *size - 1] 内；
+ *       返回后可能已被其他线程改变，与加锁查询后解锁再使用相同
+ */
+static inline uint16_t rb_peek_used(const ring_buffer_t *rb, uint16_t *size)
+{
+    uint16_t sz = RB_LOAD_ACQUIRE(&rb->size);
+    uint16_t tail = RB_LOAD_ACQUIRE(&rb->tail);
+    uint16_t head;
+    uint16_t again;
+    
+    for (;;) {
+        head = RB_LOAD_ACQUIRE(&rb->head);
+        again = RB_LOAD_ACQUIRE(&rb->tail);
+        if (again == tail) {
+            uint16_t now = RB_LOAD_ACQUIRE(&rb->size);
+            if (now == sz) {
+                break;
+            }
+            sz = now;
+        }
+        tail = again;
+    }
+    
+    *size = sz;
+    return (uint16_t)(((uint32_t)head + sz - tail) % sz);
+}
+
+static inline uint16_t rb_peek_available(const ring_buffer_t *rb)
+{
+    uint16_t size;
+    
+    return rb_peek_used(rb, &size);
+}
+
+static inline uint16_t rb_peek_free_space(const ring_buffer_t *rb)
+{
+    uint16_t size;
+    uint16_t used = rb_peek_used(rb, &size);
+    
+    return size - 1 - used;
+}
+
+/**
+ * @brief 从 pos 起 n 字节拆分为连续区段
+ */
+static inline void rb_spans_split(const ring_buffer_t *rb, uint16_t pos, uint16_t n, rb_spans_t *sp)
+{
+    uint16_t first = rb->size - pos;
+    
+    sp->ptr[0] = &rb->buffer[pos];
+    sp->ptr[1] = &rb->buffer[0];
+    
+    if (n <= first) {
+        sp->len[0] = n;
+        sp->len[1] = 0;
+    } else {
+        sp->len[0] = first;
+        sp->len[1] = n - first;
+    }
+}
+
+/**
+ * @brief 获取可写区段（生产者侧）
+ *
+ * @return 区段总长度，不超过 len 与剩余空间
+ */
+static inline uint16_t rb_write_spans(const ring_buffer_t *rb, uint16_t len, rb_spans_t *sp)
+{
+    uint16_t free = rb_free_space(rb);
+    uint16_t n = (len > free) ? free : len;
+    
+    rb_spans_split(rb, rb->head, n, sp);
+    return n;
+}
+
+/**
+ * @brief 获取可读区段（消费者侧）
+ *
+ * @return 区段总长度，不超过 len 与可读数据量
+ */
+static inline uint16_t rb_read_spans(const ring_buffer_t *rb, uint16_t len, rb_spans_t *sp)
+{
+    uint16_t available = rb_available(rb);
+    uint16_t n = (len > available) ? available : len;
+    
+    rb_spans_split(rb, rb->tail, n, sp);
+    return n;
+}
+
+#if RING_BUFFER_ENABLE_RING_SET
+
+/**
+ * @brief 置位就绪位并唤醒消费者（ring_buffer_set.c）
+ */
+void rb_set_notify(ring_buffer_t *rb);
+
+/**
+ * @brief 发布 head 后检测由空变为非空
+ *
+ * @note 全屏障与消费者"清位 → 全屏障 → 读 head"配对：
+ *       要么本侧看到消费者已追上旧 head 而置位，要么消费者看到新 head
+ */
+static inline void rb_set_check(ring_buffer_t *rb, uint16_t old_head)
+{
+    if (rb->set != NULL) {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (rb->tail == old_head) {
+            rb_set_notify(rb);
+        }
+    }
+}
+
+#endif /* RING_BUFFER_ENABLE_RING_SET */
+
+/* ==================== 快照序号 ==================== */
+
+#if RING_BUFFER_ENABLE_SNAPSHOT
+
+/**
+ * @brief 进入修改窗口：序号变为奇数
+ *
+ * @note 每个序号只有一个写者（生产者侧、消费者侧各自串行），普通自增即可；
+ *       屏障保证序号先于窗口内的修改可见
+ */
+static inline void rb_seq_begin(volatile uint32_t *seq)
+{
+    *seq = *seq + 1;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 离开修改窗口：序号恢复为偶数
+ */
+static inline void rb_seq_end(volatile uint32_t *seq)
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    *seq = *seq + 1;
+}
+
+#define RB_SEQ_BEGIN(rb, side)  rb_seq_begin(&(rb)->side##_seq)
+#define RB_SEQ_END(rb, side)    rb_seq_end(&(rb)->side##_seq)
+
+#else
+
+#define RB_SEQ_BEGIN(rb, side)  ((void)0)
+#define RB_SEQ_END(rb, side)    ((void)0)
+
+#endif /* RING_BUFFER_ENABLE_SNAPSHOT */
+
+/**
+ * @brief 提交写入：数据已拷入后发布 head
+ *
+ * @note 统计计数与 head 在同一快照窗口内更新，快照中二者总是一致
+ */
+static inline void rb_commit_write(ring_buffer_t *rb, uint16_t n)
+{
+#if RING_BUFFER_ENABLE_RING_SET
+    uint16_t old_head = rb->head;
+#endif
+    
+    RB_SEQ_BEGIN(rb, write);
+    rb->head = (uint16_t)(((uint32_t)rb->head + n) % rb->size);
+#if RING_BUFFER_ENABLE_STATISTICS
+    rb->write_count += n;
+#endif
+    RB_SEQ_END(rb, write);
+    
+#if RING_BUFFER_ENABLE_RING_SET
+    rb_set_check(rb, old_head);
+#endif
+}
+
+/**
+ * @brief 提交读取：数据已拷出后释放空间
+ */
+static inline void rb_commit_read(ring_buffer_t *rb, uint16_t n)
+{
+    RB_SEQ_BEGIN(rb, read);
+    rb->tail = (uint16_t)(((uint32_t)rb->tail + n) % rb->size);
+#if RING_BUFFER_ENABLE_STATISTICS
+    rb->read_count += n;
+#endif
+    RB_SEQ_END(rb, read);
+}
+
+/* ==================== 统计计数 ==================== */
+
+#if RING_BUFFER_ENABLE_STATISTICS
+
+/*
+ * 读写字节数由 rb_commit_write / rb_commit_read 计入；以下供不经过提交函数的
+ * 路径使用。write_count / overflow_count 归生产者侧序号，read_count 归消费者侧
+ */
+
+static inline void rb_stat_write(ring_buffer_t *rb, uint32_t n)
+{
+    RB_SEQ_BEGIN(rb, write);
+    rb->write_count += n;
+    RB_SEQ_END(rb, write);
+}
+
+static inline void rb_stat_overflow(ring_buffer_t *rb)
+{
+    RB_SEQ_BEGIN(rb, write);
+    rb->overflow_count++;
+    RB_SEQ_END(rb, write);
+}
+
+static inline void rb_stat_read(ring_buffer_t *rb, uint32_t n)
+{
+    RB_SEQ_BEGIN(rb, read);
+    rb->read_count += n;
+    RB_SEQ_END(rb, read);
+}
+
+/**
+ * @brief 清零全部计数（清空缓冲区时，要求期间无其他读写）
+ */
+static inline void rb_stat_reset(ring_buffer_t *rb)
+{
+    RB_SEQ_BEGIN(rb, write);
+    RB_SEQ_BEGIN(rb, read);
+    rb->write_count = 0;
+    rb->read_count = 0;
+    rb->overflow_count = 0;
+    RB_SEQ_END(rb, read);
+    RB_SEQ_END(rb, write);
+}
+
+#endif /* RING_BUFFER_ENABLE_STATISTICS */
+
+/* ==================== 小块拷贝内核 ==================== */
+
+/*
+ * 定长拷贝原语：
+ * - x86：SSE2 16 字节 / AVX2 32 字节非对齐访存
+ * - ARM：NEON 16 字节
+ * - 其他：定长 memcpy，编译器会展开为若干次字访问
+ */
+
+static inline void rb_copy4(uint8_t *dst, const uint8_t *src)
+{
+    memcpy(dst, src, 4);
+}
+
+static inline void rb_copy8(uint8_t *dst, const uint8_t *src)
+{
+    memcpy(dst, src, 8);
+}
+
+static inline void rb_copy16(uint8_t *dst, const uint8_t *src)
+{
+#if defined(__SSE2__)
+    _mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+#elif defined(__ARM_NEON)
+    vst1q_u8(dst, vld1q_u8(src));
+#else
+    memcpy(dst, src, 16);
+#endif
+}
+
+#if defined(__AVX2__)
+static inline void rb_copy32(uint8_t *dst, const uint8_t *src)
+{
+    _mm256_storeu_si256((__m256i *)dst, _mm256_loadu_si256((const __m256i *)src));
+}
+#endif
+
+/**
+ * @brief 环形缓冲区数据拷贝
+ *
+ * @note
+ * - 长度 <= RING_BUFFER_SMALL_COPY_MAX 时内联完成，首尾两次访存相互重叠，
+ *   无需逐字节处理尾部
+ * - 源与目的不可重叠（用户缓冲区 ↔ 环形存储区）
+ */
+static inline void rb_copy(uint8_t *dst, const uint8_t *src, uint16_t len)
+{
+    if (len > RING_BUFFER_SMALL_COPY_MAX) {
+        memcpy(dst, src, len);
+        return;
+    }
+
+#if defined(__AVX2__)
+    if (len >= 32) {
+        uint16_t off = 0;
+        while (len - off > 32) {
+            rb_copy32(dst + off, src + off);
+            off += 32;
+        }
+        rb_copy32(dst + len - 32, src + len - 32);
+        return;
+    }
+#endif
+
+    if (len >= 16) {
+        uint16_t off = 0;
+        while (len - off > 16) {
+            rb_copy16(dst + off, src + off);
+            off += 16;
+        }
+        rb_copy16(dst + len - 16, src + len - 16);
+    } else if (len >= 8) {
+        rb_copy8(dst, src);
+        rb_copy8(dst + len - 8, src + len - 8);
+    } else if (len >= 4) {
+        rb_copy4(dst, src);
+        rb_copy4(dst + len - 4, src + len - 4);
+    } else {
+        for (uint16_t i = 0; i < len; i++) {
+            dst[i] = src[i];
+        }
+    }
+}
+
+/* ==================== 区段拷贝 ==================== */
+
+/**
+ * @brief 拷贝入区段内偏移 off 处（跨越两段时自动拆分）
+ */
+static inline void rb_spans_copy_in(const rb_spans_t *sp, uint16_t off,
+                                    const uint8_t *src, uint16_t len)
+{
+    if (off < sp->len[0]) {
+        uint16_t n = sp->len[0] - off;
+        if (n > len) n = len;
+        rb_copy(sp->ptr[0] + off, src, n);
+        src += n;
+        len -= n;
+        off = 0;
+    } else {
+        off -= sp->len[0];
+    }
+    rb_copy(sp->ptr[1] + off, src, len);
+}
+
+/**
+ * @brief 从区段内偏移 off 处拷贝出（跨越两段时自动拆分）
+ */
+static inline void rb_spans_copy_out(const rb_spans_t *sp, uint16_t off,
+                                     uint8_t *dst, uint16_t len)
+{
+    if (off < sp->len[0]) {
+        uint16_t n = sp->len[0] - off;
+        if (n > len) n = len;
+        rb_copy(dst, sp->ptr[0] + off, n);
+        dst += n;
+        len -= n;
+        off = 0;
+    } else {
+        off -= sp->len[0];
+    }
+    rb_copy(dst, sp->ptr[1] + off, len);
+}
+
+/* ==================== 大块流式拷贝 ==================== */
+
+#if RING_BUFFER_STREAM_THRESHOLD
+
+/**
+ * @brief 非临时存储拷贝（写入环形存储区）
+ *
+ * @note
+ * - 目的地址先按 16 字节对齐，中段使用 movntdq 绕过缓存
+ * - 调用者须在发布 head 前执行 rb_stream_fence()
+ * - 无非临时存储指令的平台退化为普通拷贝
+ */
+static inline void rb_copy_stream(uint8_t *dst, const uint8_t *src, uint16_t len)
+{
+#if defined(__SSE2__)
+    uint16_t head = (uint16_t)((16 - ((uintptr_t)dst & 15)) & 15);
+    uint16_t off;
+
+    if (len < head + 16) {
+        rb_copy(dst, src, len);
+        return;
+    }
+
+    rb_copy(dst, src, head);
+    for (off = head; len - off >= 16; off += 16) {
+        _mm_stream_si128((__m128i *)(dst + off),
+                         _mm_loadu_si128((const __m128i *)(src + off)));
+    }
+    rb_copy(dst + off, src + off, len - off);
+#else
+    rb_copy(dst, src, len);
+#endif
+}
+
+/**
+ * @brief 非临时存储写屏障
+ *
+ * @note 非临时存储不遵循 x86 的 TSO 顺序，必须 sfence 后才能发布 head
+ */
+static inline void rb_stream_fence(void)
+{
+#if defined(__SSE2__)
+    _mm_sfence();
+#endif
+}
+
+/**
+ * @brief 边预取边拷贝（从环形存储区读出）
+ *
+ * @note 预取使用非临时提示（locality = 0），尽量不污染缓存
+ */
+static inline void rb_copy_prefetch(uint8_t *dst, const uint8_t *src, uint16_t len)
+{
+    uint16_t off = 0;
+
+    for (; len - off >= 64; off += 64) {
+#if defined(__GNUC__)
+        __builtin_prefetch(src + off + RING_BUFFER_PREFETCH_DISTANCE, 0, 0);
+#endif
+        rb_copy16(dst + off, src + off);
+        rb_copy16(dst + off + 16, src + off + 16);
+        rb_copy16(dst + off + 32, src + off + 32);
+        rb_copy16(dst + off + 48, src + off + 48);
+    }
+    rb_copy(dst + off, src + off, len - off);
+}
+
+#endif /* RING_BUFFER_STREAM_THRESHOLD */
+
+/* ==================== 拷贝并计算 CRC ==================== */
+
+#if RING_BUFFER_ENABLE_CRC
+
+/**
+ * @brief 拷贝 len 字节并累计 CRC（ring_buffer_crc.c）
+ *
+ * @return 更新后的 CRC（未做最终异或）
+ */
+uint32_t rb_crc_copy(uint8_t *dst, const uint8_t *src, uint16_t len,
+                     ring_buffer_crc_type_t type, uint32_t crc);
+
+#endif /* RING_BUFFER_ENABLE_CRC */
+
+/* ==================== 文件描述符直接读写 ==================== */
+
+#if RING_BUFFER_ENABLE_FD_IO
+
+/**
+ * @brief 无锁实现（ring_buffer_fd.c），由各策略复用
+ */
+ssize_t rb_lockfree_fill_from_fd(ring_buffer_t *rb, int fd, uint16_t max);
+ssize_t rb_lockfree_drain_to_fd(ring_buffer_t *rb, int fd, uint16_t max);
+
+#endif /* RING_BUFFER_ENABLE_FD_IO */
+
+/* ==================== 事件追踪 ==================== */
+
+#if RING_BUFFER_ENABLE_TRACE
+
+/**
+ * @brief 记录一条追踪事件（ring_buffer_trace.c），调用前须确认 rb->trace_id != 0
+ */
+void rb_trace_record(const ring_buffer_t *rb, uint8_t op, uint16_t req, uint16_t len);
+
+#endif /* RING_BUFFER_ENABLE_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RING_BUFFER_INTERNAL_H */
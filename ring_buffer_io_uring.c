@@ -0,0 +1,324 @@
+/**
+ * @file    ring_buffer_io_uring.c
+ * @brief   环形缓冲区 io_uring 异步读写引擎
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 单核上数十个缓冲区分别对接文件、管道、socket
+ * - 不希望每个缓冲区每次搬运都付出一次 read()/write() 系统调用
+ *
+ * 实现方式：
+ * - 每个缓冲区至多一个在途请求：FILL 为 readv（fd → 空闲区段），
+ *   DRAIN 为 writev（可读区段 → fd），区段直接作为 iovec
+ * - 一轮内所有请求写入提交队列后只调用一次 io_uring_enter()
+ * - 完成队列中按实际字节数推进 head（FILL）或 tail（DRAIN）
+ *
+ * 直接使用 io_uring_setup / io_uring_enter 系统调用，不依赖 liburing
+ *
+ * @warning 缓冲区须为无锁模式；引擎独占 FILL 的生产者侧 / DRAIN 的消费者侧
+ */
+
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_IO_URING
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+/* Private functions ---------------------------------------------------------*/
+
+static int uring_setup(unsigned entries, struct io_uring_params *p)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+/**
+ * @brief 为槽位准备一个 SQE（被内核接受后才标记为在途）
+ *
+ * @return true=已入队, false=无事可做或提交队列已满
+ */
+static bool uring_prep(ring_buffer_uring_t *eng, uint8_t idx)
+{
+    ring_buffer_uring_slot_t *slot = &eng->slots[idx];
+    rb_spans_t sp;
+    uint16_t n;
+
+    if (slot->busy || slot->eof || slot->err) {
+        return false;
+    }
+
+    if (slot->dir == RING_BUFFER_URING_FILL) {
+        n = rb_write_spans(slot->rb, slot->rb->size, &sp);
+    } else {
+        n = rb_read_spans(slot->rb, slot->rb->size, &sp);
+    }
+
+    if (n == 0) {
+        return false;
+    }
+
+    unsigned tail = *eng->sq_tail;
+    if (tail - __atomic_load_n(eng->sq_head, __ATOMIC_ACQUIRE) >= eng->sq_entries) {
+        return false;
+    }
+
+    slot->iov[0].iov_base = sp.ptr[0];
+    slot->iov[0].iov_len = sp.len[0];
+    slot->iov[1].iov_base = sp.ptr[1];
+    slot->iov[1].iov_len = sp.len[1];
+
+    unsigned i = tail & *eng->sq_mask;
+    struct io_uring_sqe *sqe = &((struct io_uring_sqe *)eng->sqes)[i];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (slot->dir == RING_BUFFER_URING_FILL) ? IORING_OP_READV : IORING_OP_WRITEV;
+    sqe->fd = slot->fd;
+    sqe->addr = (uint64_t)(uintptr_t)slot->iov;
+    sqe->len = (sp.len[1] > 0) ? 2 : 1;
+    sqe->off = (uint64_t)-1;    /* 文件使用当前偏移，管道 / socket 忽略 */
+    sqe->user_data = idx;
+
+    eng->sq_array[i] = i;
+    __atomic_store_n(eng->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/**
+ * @brief 处理一个完成结果
+ */
+static void uring_complete(ring_buffer_uring_t *eng, const struct io_uring_cqe *cqe)
+{
+    ring_buffer_uring_slot_t *slot = &eng->slots[cqe->user_data];
+    ring_buffer_t *rb = slot->rb;
+
+    slot->busy = false;
+    eng->inflight--;
+
+    if (cqe->res < 0) {
+        /* 暂时性错误下一轮重试 */
+        if (cqe->res != -EAGAIN && cqe->res != -EINTR) {
+            slot->err = cqe->res;
+        }
+        return;
+    }
+
+    if (cqe->res == 0) {
+        if (slot->dir == RING_BUFFER_URING_FILL) {
+            slot->eof = true;
+        }
+        return;
+    }
+
+    if (slot->dir == RING_BUFFER_URING_FILL) {
+        rb_commit_write(rb, (uint16_t)cqe->res);
+    } else {
+        rb_commit_read(rb, (uint16_t)cqe->res);
+    }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+bool ring_buffer_uring_init(ring_buffer_uring_t *eng, unsigned entries)
+{
+    struct io_uring_params p;
+
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (eng == NULL || entries == 0) {
+        return false;
+    }
+#endif
+
+    memset(eng, 0, sizeof(*eng));
+    memset(&p, 0, sizeof(p));
+
+    eng->ring_fd = uring_setup(entries, &p);
+    if (eng->ring_fd < 0) {
+        return false;
+    }
+
+    eng->sq_map_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    eng->cq_map_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    eng->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (eng->cq_map_len > eng->sq_map_len) {
+            eng->sq_map_len = eng->cq_map_len;
+        }
+        eng->cq_map_len = eng->sq_map_len;
+    }
+
+    eng->sq_map = mmap(NULL, eng->sq_map_len, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, eng->ring_fd, IORING_OFF_SQ_RING);
+    if (eng->sq_map == MAP_FAILED) {
+        goto fail_fd;
+    }
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        eng->cq_map = eng->sq_map;
+    } else {
+        eng->cq_map = mmap(NULL, eng->cq_map_len, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, eng->ring_fd, IORING_OFF_CQ_RING);
+        if (eng->cq_map == MAP_FAILED) {
+            goto fail_sq;
+        }
+    }
+
+    eng->sqes = mmap(NULL, eng->sqes_len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, eng->ring_fd, IORING_OFF_SQES);
+    if (eng->sqes == MAP_FAILED) {
+        goto fail_cq;
+    }
+
+    uint8_t *sq = (uint8_t *)eng->sq_map;
+    uint8_t *cq = (uint8_t *)eng->cq_map;
+
+    eng->sq_entries = p.sq_entries;
+    eng->sq_head = (unsigned *)(sq + p.sq_off.head);
+    eng->sq_tail = (unsigned *)(sq + p.sq_off.tail);
+    eng->sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+    eng->sq_array = (unsigned *)(sq + p.sq_off.array);
+    eng->cq_head = (unsigned *)(cq + p.cq_off.head);
+    eng->cq_tail = (unsigned *)(cq + p.cq_off.tail);
+    eng->cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+    eng->cqes = cq + p.cq_off.cqes;
+
+    return true;
+
+fail_cq:
+    if (eng->cq_map != eng->sq_map) {
+        munmap(eng->cq_map, eng->cq_map_len);
+    }
+fail_sq:
+    munmap(eng->sq_map, eng->sq_map_len);
+fail_fd:
+    close(eng->ring_fd);
+    eng->ring_fd = -1;
+    return false;
+}
+
+int ring_buffer_uring_add(ring_buffer_uring_t *eng, ring_buffer_t *rb, int fd,
+                          ring_buffer_uring_dir_t dir)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (eng == NULL || rb == NULL || fd < 0) {
+        return -1;
+    }
+#endif
+
+    if (eng->slot_count >= RING_BUFFER_URING_MAX_RINGS) {
+        return -1;
+    }
+
+    ring_buffer_uring_slot_t *slot = &eng->slots[eng->slot_count];
+
+    memset(slot, 0, sizeof(*slot));
+    slot->rb = rb;
+    slot->fd = fd;
+    slot->dir = (uint8_t)dir;
+
+    return eng->slot_count++;
+}
+
+int ring_buffer_uring_run(ring_buffer_uring_t *eng, bool wait)
+{
+    uint8_t prepared[RING_BUFFER_URING_MAX_RINGS];
+    unsigned to_submit = 0;
+    unsigned min_complete = 0;
+    int ret = 0;
+    int done = 0;
+
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (eng == NULL) {
+        return -1;
+    }
+#endif
+
+    unsigned sq_head = __atomic_load_n(eng->sq_head, __ATOMIC_ACQUIRE);
+
+    for (uint8_t i = 0; i < eng->slot_count; i++) {
+        if (uring_prep(eng, i)) {
+            prepared[to_submit++] = i;
+        }
+    }
+
+    /* 完成队列为空时才阻塞，否则直接回收已有结果 */
+    if (wait && eng->inflight + to_submit > 0 &&
+        __atomic_load_n(eng->cq_tail, __ATOMIC_ACQUIRE) == *eng->cq_head) {
+        min_complete = 1;
+    }
+
+    if (to_submit > 0 || min_complete > 0) {
+        do {
+            ret = uring_enter(eng->ring_fd, to_submit, min_complete,
+                              min_complete ? IORING_ENTER_GETEVENTS : 0);
+        } while (ret < 0 && errno == EINTR);
+    }
+
+    if (to_submit > 0) {
+        /*
+         * 内核按顺序消费 SQE 并推进 sq_head，前 accepted 个才真正在途（出错或
+         * 部分提交时少于 to_submit）。其余 SQE 从队尾收回，槽位下一轮按最新
+         * 区段重新准备；未启用 SQPOLL 时内核只在 io_uring_enter 中读取 SQE
+         */
+        unsigned accepted = __atomic_load_n(eng->sq_head, __ATOMIC_ACQUIRE) - sq_head;
+
+        if (accepted > to_submit) {
+            accepted = to_submit;
+        }
+        for (unsigned k = 0; k < accepted; k++) {
+            eng->slots[prepared[k]].busy = true;
+        }
+        eng->inflight += accepted;
+        __atomic_store_n(eng->sq_tail, *eng->sq_tail - (to_submit - accepted), __ATOMIC_RELEASE);
+    }
+
+    if (ret < 0) {
+        return -1;
+    }
+
+    unsigned head = *eng->cq_head;
+    const struct io_uring_cqe *cqes = (const struct io_uring_cqe *)eng->cqes;
+
+    while (head != __atomic_load_n(eng->cq_tail, __ATOMIC_ACQUIRE)) {
+        uring_complete(eng, &cqes[head & *eng->cq_mask]);
+        head++;
+        done++;
+    }
+    __atomic_store_n(eng->cq_head, head, __ATOMIC_RELEASE);
+
+    return done;
+}
+
+void ring_buffer_uring_deinit(ring_buffer_uring_t *eng)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (eng == NULL || eng->ring_fd < 0) {
+        return;
+    }
+#endif
+
+    munmap(eng->sqes, eng->sqes_len);
+    if (eng->cq_map != eng->sq_map) {
+        munmap(eng->cq_map, eng->cq_map_len);
+    }
+    munmap(eng->sq_map, eng->sq_map_len);
+    close(eng->ring_fd);
+
+    eng->ring_fd = -1;
+    eng->slot_count = 0;
+    eng->inflight = 0;
+}
+
+#endif /* RING_BUFFER_ENABLE_IO_URING */
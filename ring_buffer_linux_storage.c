@@ -0,0 +1,146 @@
+/**
+ * @file    ring_buffer_linux_storage.c
+ * @brief   环形缓冲区 Linux 存储分配器（大页 / NUMA）
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - Linux 主机上的大容量采集缓冲区
+ * - 生产者/消费者线程固定在某个 NUMA 节点
+ *
+ * 优化手段：
+ * - MAP_HUGETLB：整个缓冲区落在一个大页内，memcpy 不再产生 TLB 缺失
+ * - mbind：物理页分配在消费者所在节点，避免跨节点访问
+ * - 预缺页：创建时逐页写入，首次环绕不再触发缺页中断
+ *
+ * @note 仅分配存储空间，线程安全策略仍由 ring_buffer_create() 选择
+ */
+
+#define _GNU_SOURCE
+
+#include "ring_buffer.h"
+
+#if RING_BUFFER_ENABLE_LINUX_STORAGE
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+/* Private functions ---------------------------------------------------------*/
+
+static inline size_t align_up(size_t len, size_t align)
+{
+    return (len + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief 绑定到 NUMA 节点
+ *
+ * @note 直接使用系统调用，无需链接 libnuma
+ */
+static bool storage_bind_node(void *addr, size_t len, int node)
+{
+    unsigned long nodemask[4] = {0};
+    const unsigned long bits = sizeof(unsigned long) * 8;
+
+    if (node < 0 || (size_t)node >= sizeof(nodemask) * 8) {
+        return false;
+    }
+
+    nodemask[node / bits] = 1UL << (node % bits);
+
+    return syscall(SYS_mbind, addr, len, MPOL_BIND, nodemask,
+                   sizeof(nodemask) * 8, MPOL_MF_MOVE) == 0;
+}
+
+/**
+ * @brief 逐页写入，提前完成缺页
+ */
+static void storage_prefault(uint8_t *addr, size_t len, size_t page)
+{
+    for (size_t off = 0; off < len; off += page) {
+        ((volatile uint8_t *)addr)[off] = 0;
+    }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+bool ring_buffer_storage_alloc(ring_buffer_storage_t *st, uint16_t size,
+                               int numa_node, uint32_t flags)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!st || size < RING_BUFFER_MIN_SIZE) {
+        return false;
+    }
+#endif
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    void *addr = MAP_FAILED;
+    size_t map_len = 0;
+
+    st->flags = 0;
+
+    /* 优先尝试大页，系统未预留大页时回退普通页 */
+    if (flags & RING_BUFFER_STORAGE_HUGETLB) {
+        map_len = align_up(size, RING_BUFFER_HUGEPAGE_SIZE);
+        addr = mmap(NULL, map_len, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr != MAP_FAILED) {
+            st->flags |= RING_BUFFER_STORAGE_HUGETLB;
+            page = RING_BUFFER_HUGEPAGE_SIZE;
+        } else {
+            RB_LOG("Hugepage mapping unavailable, fallback to normal pages");
+        }
+    }
+
+    if (addr == MAP_FAILED) {
+        map_len = align_up(size, page);
+        addr = mmap(NULL, map_len, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            RB_LOG("Storage alloc failed: mmap");
+            return false;
+        }
+    }
+
+    /* 必须在首次触碰前绑定，否则物理页已按默认策略分配 */
+    if (numa_node >= 0 && !storage_bind_node(addr, map_len, numa_node)) {
+        RB_LOG("Storage alloc failed: mbind node %d", numa_node);
+        munmap(addr, map_len);
+        return false;
+    }
+
+    if (flags & RING_BUFFER_STORAGE_PREFAULT) {
+        storage_prefault(addr, map_len, page);
+        st->flags |= RING_BUFFER_STORAGE_PREFAULT;
+    }
+
+    st->buffer = addr;
+    st->size = size;
+    st->map_len = map_len;
+
+    RB_LOG("Storage allocated (size=%u, map=%zu, flags=0x%x)",
+           size, map_len, (unsigned)st->flags);
+    return true;
+}
+
+void ring_buffer_storage_free(ring_buffer_storage_t *st)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (!st || !st->buffer) {
+        return;
+    }
+#endif
+
+    munmap(st->buffer, st->map_len);
+
+    st->buffer = NULL;
+    st->size = 0;
+    st->map_len = 0;
+    st->flags = 0;
+}
+
+#endif /* RING_BUFFER_ENABLE_LINUX_STORAGE */
@@ -18,179 +18,328 @@
  * @warning 禁止多个生产者或多个消费者同时访问
  */
 
-#include "ring_buffer.h"
+#include "ring_buffer_internal.h"
+#include "ring_buffer_decorator.h"
 
 #if RING_BUFFER_ENABLE_LOCKFREE
 
 /* Private functions ---------------------------------------------------------*/
 
-static inline uint16_t lockfree_available_internal(const ring_buffer_t *rb)
+#if RING_BUFFER_STREAM_THRESHOLD
+#define LOCKFREE_STREAMING(len)  ((len) >= RING_BUFFER_STREAM_THRESHOLD)
+#else
+#define LOCKFREE_STREAMING(len)  (false)
+#endif
+
+/**
+ * @brief 拷贝入存储区（大块使用非临时存储）
+ */
+static inline void lockfree_copy_in(uint8_t *dst, const uint8_t *src, uint16_t len, bool stream)
 {
-    uint16_t head = rb->head;
-    uint16_t tail = rb->tail;
-    
-    if (head >= tail) {
-        return head - tail;
-    } else {
-        return rb->size - tail + head;
+#if RING_BUFFER_STREAM_THRESHOLD
+    if (stream) {
+        rb_copy_stream(dst, src, len);
+        return;
     }
+#else
+    (void)stream;
+#endif
+    rb_copy(dst, src, len);
 }
 
-static inline uint16_t lockfree_free_space_internal(const ring_buffer_t *rb)
+/**
+ * @brief 从存储区拷贝出（大块边拷贝边预取）
+ */
+static inline void lockfree_copy_out(uint8_t *dst, const uint8_t *src, uint16_t len, bool stream)
 {
-    return rb->size - 1 - lockfree_available_internal(rb);
+#if RING_BUFFER_STREAM_THRESHOLD
+    if (stream) {
+        rb_copy_prefetch(dst, src, len);
+        return;
+    }
+#else
+    (void)stream;
+#endif
+    rb_copy(dst, src, len);
 }
 
 /* Exported functions (Implementation) ---------------------------------------*/
 
-static bool lockfree_write(ring_buffer_t *rb, uint8_t data)
+bool rb_lockfree_write(ring_buffer_t *rb, uint8_t data)
 {
     uint16_t next_head = (rb->head + 1) % rb->size;
     
     if (next_head == rb->tail) {
 #if RING_BUFFER_ENABLE_STATISTICS
-        rb->overflow_count++;
+        rb_stat_overflow(rb);
 #endif
         return false;  /* 满 */
     }
     
     rb->buffer[rb->head] = data;
-    rb->head = next_head;
-    
-#if RING_BUFFER_ENABLE_STATISTICS
-    rb->write_count++;
-#endif
+    rb_commit_write(rb, 1);
     
     return true;
 }
 
-static bool lockfree_read(ring_buffer_t *rb, uint8_t *data)
+bool rb_lockfree_read(ring_buffer_t *rb, uint8_t *data)
 {
     if (rb->tail == rb->head) {
         return false;  /* 空 */
     }
     
     *data = rb->buffer[rb->tail];
-    rb->tail = (rb->tail + 1) % rb->size;
-    
-#if RING_BUFFER_ENABLE_STATISTICS
-    rb->read_count++;
-#endif
+    rb_commit_read(rb, 1);
     
     return true;
 }
 
-static uint16_t lockfree_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
+uint16_t rb_lockfree_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
 {
-    uint16_t free = lockfree_free_space_internal(rb);
-    uint16_t to_write = (len > free) ? free : len;
+    rb_spans_t sp;
+    uint16_t to_write = rb_write_spans(rb, len, &sp);
     
     if (to_write == 0) {
 #if RING_BUFFER_ENABLE_STATISTICS
-        if (len > 0) rb->overflow_count++;
+        if (len > 0) rb_stat_overflow(rb);
 #endif
         return 0;
     }
     
-    uint16_t head = rb->head;
-    uint16_t size = rb->size;
+    bool stream = LOCKFREE_STREAMING(to_write);
+    
+    lockfree_copy_in(sp.ptr[0], data, sp.len[0], stream);
+    lockfree_copy_in(sp.ptr[1], &data[sp.len[0]], sp.len[1], stream);
     
-    if (head + to_write <= size) {
-        memcpy(&rb->buffer[head], data, to_write);
-        rb->head = (head + to_write) % size;
-    } else {
-        uint16_t first_chunk = size - head;
-        uint16_t second_chunk = to_write - first_chunk;
-        
-        memcpy(&rb->buffer[head], data, first_chunk);
-        memcpy(&rb->buffer[0], &data[first_chunk], second_chunk);
-        
-        rb->head = second_chunk;
+#if RING_BUFFER_STREAM_THRESHOLD
+    /* 非临时存储须先全局可见，才能发布 head */
+    if (stream) {
+        rb_stream_fence();
     }
+#endif
+    
+    rb_commit_write(rb, to_write);
     
 #if RING_BUFFER_ENABLE_STATISTICS
-    rb->write_count += to_write;
-    if (to_write < len) rb->overflow_count++;
+    if (to_write < len) rb_stat_overflow(rb);
 #endif
     
     return to_write;
 }
 
-static uint16_t lockfree_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
+uint16_t rb_lockfree_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
 {
-    uint16_t available = lockfree_available_internal(rb);
-    uint16_t to_read = (len > available) ? available : len;
+    rb_spans_t sp;
+    uint16_t to_read = rb_read_spans(rb, len, &sp);
     
     if (to_read == 0) {
         return 0;
     }
     
-    uint16_t tail = rb->tail;
-    uint16_t size = rb->size;
+    bool stream = LOCKFREE_STREAMING(to_read);
+    
+    lockfree_copy_out(data, sp.ptr[0], sp.len[0], stream);
+    lockfree_copy_out(&data[sp.len[0]], sp.ptr[1], sp.len[1], stream);
+    
+    rb_commit_read(rb, to_read);
+    
+    return to_read;
+}
+
+uint16_t rb_lockfree_writev(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    uint32_t total = 0;
+    
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
     
-    if (tail + to_read <= size) {
-        memcpy(data, &rb->buffer[tail], to_read);
-        rb->tail = (tail + to_read) % size;
-    } else {
-        uint16_t first_chunk = size - tail;
-        uint16_t second_chunk = to_read - first_chunk;
-        
-        memcpy(data, &rb->buffer[tail], first_chunk);
-        memcpy(&data[first_chunk], &rb->buffer[0], second_chunk);
-        
-        rb->tail = second_chunk;
+    if (total == 0) {
+        return 0;
     }
     
+    /* 全部写入或完全不写，避免消费者看到半帧 */
+    if (total > rb_free_space(rb)) {
 #if RING_BUFFER_ENABLE_STATISTICS
-    rb->read_count += to_read;
+        rb_stat_overflow(rb);
 #endif
+        return 0;
+    }
     
-    return to_read;
+    rb_spans_t sp;
+    uint16_t off = 0;
+    
+    rb_write_spans(rb, (uint16_t)total, &sp);
+    
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        rb_spans_copy_in(&sp, off, (const uint8_t *)iov[i].base, iov[i].len);
+        off += iov[i].len;
+    }
+    
+    rb_commit_write(rb, (uint16_t)total);
+    
+    return (uint16_t)total;
 }
 
-static uint16_t lockfree_available(const ring_buffer_t *rb)
+uint16_t rb_lockfree_readv(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
 {
-    return lockfree_available_internal(rb);
+    uint32_t total = 0;
+    
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+    
+    if (total == 0 || total > rb_available(rb)) {
+        return 0;
+    }
+    
+    rb_spans_t sp;
+    uint16_t off = 0;
+    
+    rb_read_spans(rb, (uint16_t)total, &sp);
+    
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        rb_spans_copy_out(&sp, off, (uint8_t *)iov[i].base, iov[i].len);
+        off += iov[i].len;
+    }
+    
+    rb_commit_read(rb, (uint16_t)total);
+    
+    return (uint16_t)total;
+}
+
+uint16_t rb_lockfree_available(const ring_buffer_t *rb)
+{
+    return rb_available(rb);
 }
 
-static uint16_t lockfree_free_space(const ring_buffer_t *rb)
+uint16_t rb_lockfree_free_space(const ring_buffer_t *rb)
 {
-    return lockfree_free_space_internal(rb);
+    return rb_free_space(rb);
 }
 
-static bool lockfree_is_empty(const ring_buffer_t *rb)
+bool rb_lockfree_is_empty(const ring_buffer_t *rb)
 {
     return (rb->head == rb->tail);
 }
 
-static bool lockfree_is_full(const ring_buffer_t *rb)
+bool rb_lockfree_is_full(const ring_buffer_t *rb)
 {
     return ((rb->head + 1) % rb->size == rb->tail);
 }
 
-static void lockfree_clear(ring_buffer_t *rb)
+void rb_lockfree_clear(ring_buffer_t *rb)
 {
+    RB_SEQ_BEGIN(rb, read);
     rb->tail = rb->head;
+    RB_SEQ_END(rb, read);
     
 #if RING_BUFFER_ENABLE_STATISTICS
-    rb->write_count = 0;
-    rb->read_count = 0;
-    rb->overflow_count = 0;
+    rb_stat_reset(rb);
 #endif
 }
 
+#if RING_BUFFER_ENABLE_CRC
+uint16_t rb_lockfree_write_multi_crc(ring_buffer_t *rb, const uint8_t *data, uint16_t len,
+                                     ring_buffer_crc_type_t type, uint32_t *crc)
+{
+    rb_spans_t sp;
+    uint16_t to_write = rb_write_spans(rb, len, &sp);
+    
+    if (to_write == 0) {
+#if RING_BUFFER_ENABLE_STATISTICS
+        if (len > 0) rb_stat_overflow(rb);
+#endif
+        return 0;
+    }
+    
+    *crc = rb_crc_copy(sp.ptr[0], data, sp.len[0], type, *crc);
+    *crc = rb_crc_copy(sp.ptr[1], &data[sp.len[0]], sp.len[1], type, *crc);
+    
+    rb_commit_write(rb, to_write);
+    
+#if RING_BUFFER_ENABLE_STATISTICS
+    if (to_write < len) rb_stat_overflow(rb);
+#endif
+    
+    return to_write;
+}
+
+uint16_t rb_lockfree_read_multi_crc(ring_buffer_t *rb, uint8_t *data, uint16_t len,
+                                    ring_buffer_crc_type_t type, uint32_t *crc)
+{
+    rb_spans_t sp;
+    uint16_t to_read = rb_read_spans(rb, len, &sp);
+    
+    if (to_read == 0) {
+        return 0;
+    }
+    
+    *crc = rb_crc_copy(data, sp.ptr[0], sp.len[0], type, *crc);
+    *crc = rb_crc_copy(&data[sp.len[0]], sp.ptr[1], sp.len[1], type, *crc);
+    
+    rb_commit_read(rb, to_read);
+    
+    return to_read;
+}
+#endif /* RING_BUFFER_ENABLE_CRC */
+
+#if RING_BUFFER_ENABLE_RESIZE
+bool rb_lockfree_resize(ring_buffer_t *rb, uint8_t *buffer, uint16_t size,
+                        uint8_t **old, uint16_t *old_size)
+{
+    rb_spans_t sp;
+    uint16_t n = rb_available(rb);
+    
+    if (size < RING_BUFFER_MIN_SIZE || n > size - 1) {
+        return false;   /* 可读数据放不下 */
+    }
+    
+    rb_read_spans(rb, n, &sp);
+    memcpy(buffer, sp.ptr[0], sp.len[0]);
+    memcpy(&buffer[sp.len[0]], sp.ptr[1], sp.len[1]);
+    
+    *old = rb->buffer;
+    *old_size = rb->size;
+    
+    RB_SEQ_BEGIN(rb, write);
+    RB_SEQ_BEGIN(rb, read);
+    rb->buffer = buffer;
+    rb->size = size;
+    rb->tail = 0;
+    rb->head = n;
+    RB_SEQ_END(rb, read);
+    RB_SEQ_END(rb, write);
+    
+    return true;
+}
+#endif /* RING_BUFFER_ENABLE_RESIZE */
+
 /* Exported constant ---------------------------------------------------------*/
 
 const struct ring_buffer_ops ring_buffer_lockfree_ops = {
-    .write       = lockfree_write,
-    .read        = lockfree_read,
-    .write_multi = lockfree_write_multi,
-    .read_multi  = lockfree_read_multi,
-    .available   = lockfree_available,
-    .free_space  = lockfree_free_space,
-    .is_empty    = lockfree_is_empty,
-    .is_full     = lockfree_is_full,
-    .clear       = lockfree_clear,
+    .write       = rb_lockfree_write,
+    .read        = rb_lockfree_read,
+    .write_multi = rb_lockfree_write_multi,
+    .read_multi  = rb_lockfree_read_multi,
+    .available   = rb_lockfree_available,
+    .free_space  = rb_lockfree_free_space,
+    .is_empty    = rb_lockfree_is_empty,
+    .is_full     = rb_lockfree_is_full,
+    .clear       = rb_lockfree_clear,
+    .writev      = rb_lockfree_writev,
+    .readv       = rb_lockfree_readv,
+#if RING_BUFFER_ENABLE_CRC
+    .write_multi_crc = rb_lockfree_write_multi_crc,
+    .read_multi_crc  = rb_lockfree_read_multi_crc,
+#endif
+#if RING_BUFFER_ENABLE_FD_IO
+    .fill_from_fd    = rb_lockfree_fill_from_fd,
+    .drain_to_fd     = rb_lockfree_drain_to_fd,
+#endif
+#if RING_BUFFER_ENABLE_RESIZE
+    .resize          = rb_lockfree_resize,
+#endif
 };
 
 #endif /* RING_BUFFER_ENABLE_LOCKFREE */
@@ -0,0 +1,616 @@
+/**
+ * @file    ring_buffer_lz.c
+ * @brief   环形缓冲区压缩实现（LZ 块压缩）
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - RAM 有限的日志/遥测记录器，数据重复度高（固定格式文本、慢变传感器值）
+ * - 用 CPU 时间换取缓冲区的有效容量
+ *
+ * 实现方式：
+ * - write_multi 把数据按 RING_BUFFER_LZ_BLOCK_SIZE 分块，每块压缩为一帧
+ * - 帧格式：[负载长度 u16][原始长度 u16][负载]，两长度相等表示未压缩
+ * - 帧整体写入或不写，帧头与负载都可跨越环绕点
+ * - read_multi 按帧解压；用户缓冲区放不下整块时，余下部分暂存在上下文中
+ * - writev 把数据段拼成块后逐帧压缩，全部帧放得下才一次提交
+ *
+ * 压缩格式：
+ * - LZ4 块格式（token + 字面量 + 16 位偏移 + 匹配长度），单次哈希探测
+ * - 最后 5 字节总是字面量，解码时逐项检查边界
+ *
+ * @warning SPSC 语义同无锁模式；生产者与消费者各用上下文中独立的暂存区
+ */
+
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_LZ
+
+#if RING_BUFFER_ENABLE_FD_IO
+#include <errno.h>
+#endif
+
+#if RING_BUFFER_LZ_BLOCK_SIZE > 0xFFFF
+#error "RING_BUFFER_LZ_BLOCK_SIZE 不能超过 65535"
+#endif
+
+/* 复用无锁实现的内部逻辑 */
+extern const struct ring_buffer_ops ring_buffer_lockfree_ops;
+
+/* Private defines -----------------------------------------------------------*/
+
+#define LZ_FRAME_HDR      4     /**< 帧头：负载长度 + 原始长度 */
+#define LZ_MIN_MATCH      4     /**< 最短匹配 */
+#define LZ_LAST_LITERALS  5     /**< 块末尾必须为字面量的字节数 */
+#define LZ_MFLIMIT        12    /**< 距块末尾不足该长度时不再开始匹配 */
+#define LZ_HASH_SIZE      (1U << RING_BUFFER_LZ_HASH_BITS)
+
+/* Private functions ---------------------------------------------------------*/
+
+static inline uint32_t lz_read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t lz_hash(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - RING_BUFFER_LZ_HASH_BITS);
+}
+
+/**
+ * @brief 写入长度扩展字节（len 已减去 15）
+ */
+static inline uint32_t lz_put_len(uint8_t *dst, uint32_t op, uint32_t len)
+{
+    while (len >= 255) {
+        dst[op++] = 255;
+        len -= 255;
+    }
+    dst[op++] = (uint8_t)len;
+    return op;
+}
+
+/**
+ * @brief 输出一个序列：字面量 + 可选匹配（mlen == 0 表示块末尾字面量）
+ *
+ * @return 新的输出位置，超出 cap 返回 0
+ */
+static uint32_t lz_put_seq(uint8_t *dst, uint32_t op, uint32_t cap,
+                           const uint8_t *lit, uint32_t lit_len, uint32_t offset, uint32_t mlen)
+{
+    uint32_t need = 1 + lit_len + lit_len / 255 + 1;
+
+    if (mlen != 0) {
+        need += 2 + (mlen - LZ_MIN_MATCH) / 255 + 1;
+    }
+    if (op + need > cap) {
+        return 0;
+    }
+
+    uint32_t token_pos = op++;
+    uint8_t token;
+
+    if (lit_len >= 15) {
+        token = 0xF0;
+        op = lz_put_len(dst, op, lit_len - 15);
+    } else {
+        token = (uint8_t)(lit_len << 4);
+    }
+
+    memcpy(&dst[op], lit, lit_len);
+    op += lit_len;
+
+    if (mlen != 0) {
+        uint32_t m = mlen - LZ_MIN_MATCH;
+
+        dst[op++] = (uint8_t)offset;
+        dst[op++] = (uint8_t)(offset >> 8);
+
+        if (m >= 15) {
+            token |= 0x0F;
+            op = lz_put_len(dst, op, m - 15);
+        } else {
+            token |= (uint8_t)m;
+        }
+    }
+
+    dst[token_pos] = token;
+    return op;
+}
+
+/**
+ * @brief 压缩一块
+ *
+ * @return 压缩后长度，不小于 cap（不值得压缩）时返回 0
+ */
+static uint32_t lz_compress(uint16_t *table, const uint8_t *src, uint32_t n,
+                            uint8_t *dst, uint32_t cap)
+{
+    uint32_t ip = 0;
+    uint32_t anchor = 0;
+    uint32_t op = 0;
+
+    if (n > LZ_MFLIMIT) {
+        uint32_t limit = n - LZ_MFLIMIT;
+        uint32_t match_limit = n - LZ_LAST_LITERALS;
+
+        memset(table, 0, LZ_HASH_SIZE * sizeof(uint16_t));
+        ip = 1;
+
+        while (ip < limit) {
+            uint32_t h = lz_hash(lz_read32(&src[ip]));
+            uint32_t ref = table[h];
+
+            table[h] = (uint16_t)ip;
+
+            if (lz_read32(&src[ref]) != lz_read32(&src[ip])) {
+                /* 连续未命中时加大步长，不可压缩数据快速通过 */
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            uint32_t mlen = LZ_MIN_MATCH;
+            while (ip + mlen < match_limit && src[ref + mlen] == src[ip + mlen]) {
+                mlen++;
+            }
+
+            op = lz_put_seq(dst, op, cap, &src[anchor], ip - anchor, ip - ref, mlen);
+            if (op == 0) {
+                return 0;
+            }
+
+            ip += mlen;
+            anchor = ip;
+
+            if (ip < limit) {
+                table[lz_hash(lz_read32(&src[ip - 2]))] = (uint16_t)(ip - 2);
+            }
+        }
+    }
+
+    op = lz_put_seq(dst, op, cap, &src[anchor], n - anchor, 0, 0);
+    return (op >= cap) ? 0 : op;
+}
+
+/**
+ * @brief 解压一块
+ *
+ * @return 解压后长度，数据损坏返回 0
+ */
+static uint32_t lz_decompress(const uint8_t *src, uint32_t n, uint8_t *dst, uint32_t cap)
+{
+    uint32_t ip = 0;
+    uint32_t op = 0;
+
+    while (ip < n) {
+        uint8_t token = src[ip++];
+        uint32_t len = token >> 4;
+        uint8_t b;
+
+        if (len == 15) {
+            do {
+                if (ip >= n) return 0;
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+        }
+
+        if (len > n - ip || len > cap - op) {
+            return 0;
+        }
+        memcpy(&dst[op], &src[ip], len);
+        ip += len;
+        op += len;
+
+        if (ip == n) {
+            break;  /* 块末尾字面量 */
+        }
+
+        if (n - ip < 2) {
+            return 0;
+        }
+        uint32_t offset = src[ip] | ((uint32_t)src[ip + 1] << 8);
+        ip += 2;
+
+        len = token & 0x0F;
+        if (len == 15) {
+            do {
+                if (ip >= n) return 0;
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        len += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > op || len > cap - op) {
+            return 0;
+        }
+
+        const uint8_t *ref = &dst[op - offset];
+        if (offset >= len) {
+            memcpy(&dst[op], ref, len);
+        } else {
+            /* 重叠匹配（重复模式）须逐字节复制 */
+            for (uint32_t i = 0; i < len; i++) {
+                dst[op + i] = ref[i];
+            }
+        }
+        op += len;
+    }
+
+    return op;
+}
+
+/* Exported functions (Implementation) ---------------------------------------*/
+
+/**
+ * @brief 单帧最大原始长度
+ */
+static inline uint16_t lz_block(const ring_buffer_t *rb)
+{
+    uint16_t block = rb->size - 1 - LZ_FRAME_HDR;
+
+    return (block > RING_BUFFER_LZ_BLOCK_SIZE) ? RING_BUFFER_LZ_BLOCK_SIZE : block;
+}
+
+/**
+ * @brief 压缩一块数据，写到 head 之后 off 处（不提交）
+ *
+ * @return 帧长度（含帧头），剩余空间不足时返回 0
+ */
+static uint16_t lz_put_frame(ring_buffer_t *rb, ring_buffer_lz_t *lz, uint16_t off,
+                             const uint8_t *src, uint16_t raw)
+{
+    const uint8_t *payload = lz->packed;
+    uint16_t stored = (uint16_t)lz_compress(lz->hash, src, raw, lz->packed, raw);
+    rb_spans_t sp;
+    uint8_t hdr[LZ_FRAME_HDR];
+
+    if (stored == 0) {
+        stored = raw;
+        payload = src;
+    }
+
+    uint16_t frame = LZ_FRAME_HDR + stored;
+    if ((uint32_t)off + frame > 0xFFFF || rb_write_spans(rb, off + frame, &sp) < off + frame) {
+        return 0;
+    }
+
+    hdr[0] = (uint8_t)stored;
+    hdr[1] = (uint8_t)(stored >> 8);
+    hdr[2] = (uint8_t)raw;
+    hdr[3] = (uint8_t)(raw >> 8);
+
+    rb_spans_copy_in(&sp, off, hdr, LZ_FRAME_HDR);
+    rb_spans_copy_in(&sp, off + LZ_FRAME_HDR, payload, stored);
+    return frame;
+}
+
+static uint16_t lz_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
+{
+    ring_buffer_lz_t *lz = (ring_buffer_lz_t *)rb->ctx;
+    uint16_t block = lz_block(rb);
+    uint16_t done = 0;
+
+    while (done < len) {
+        uint16_t raw = (len - done > block) ? block : (uint16_t)(len - done);
+        uint16_t frame = lz_put_frame(rb, lz, 0, &data[done], raw);
+
+        if (frame == 0) {
+            break;
+        }
+        rb_commit_write(rb, frame);
+
+        lz->packed_in += frame;
+        done += raw;
+    }
+
+    if (done > 0) {
+        __atomic_store_n(&lz->raw_in, lz->raw_in + done, __ATOMIC_RELEASE);
+    }
+
+#if RING_BUFFER_ENABLE_STATISTICS
+    if (done < len) rb_stat_overflow(rb);
+#endif
+
+    return done;
+}
+
+/**
+ * @brief 分散写入：数据段拼成块后逐帧压缩，全部帧放得下才一次提交
+ */
+static uint16_t lz_writev(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    ring_buffer_lz_t *lz = (ring_buffer_lz_t *)rb->ctx;
+    uint16_t block = lz_block(rb);
+    uint32_t total = 0;
+    uint16_t used = 0;      /* 已写入未提交的存储区字节数 */
+    uint16_t fill = 0;      /* gather 中的原始字节数 */
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+    if (total == 0 || total > 0xFFFF) {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        const uint8_t *src = (const uint8_t *)iov[i].base;
+        uint16_t left = iov[i].len;
+
+        while (left > 0) {
+            uint16_t n = block - fill;
+            if (n > left) {
+                n = left;
+            }
+            memcpy(&lz->gather[fill], src, n);
+            fill += n;
+            src += n;
+            left -= n;
+
+            bool last = (left == 0 && i == iovcnt - 1);
+            if (fill == block || last) {
+                uint16_t frame = lz_put_frame(rb, lz, used, lz->gather, fill);
+                if (frame == 0) {
+#if RING_BUFFER_ENABLE_STATISTICS
+                    rb_stat_overflow(rb);
+#endif
+                    return 0;   /* 未提交，存储区内容不变 */
+                }
+                used += frame;
+                fill = 0;
+            }
+        }
+    }
+
+    rb_commit_write(rb, used);
+    lz->packed_in += used;
+    __atomic_store_n(&lz->raw_in, lz->raw_in + total, __ATOMIC_RELEASE);
+
+    return (uint16_t)total;
+}
+
+static uint16_t lz_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
+{
+    ring_buffer_lz_t *lz = (ring_buffer_lz_t *)rb->ctx;
+    uint16_t done = 0;
+
+    while (done < len) {
+        /* 先交付上一帧余下的数据 */
+        if (lz->out_pos < lz->out_len) {
+            uint16_t n = lz->out_len - lz->out_pos;
+            if (n > len - done) {
+                n = len - done;
+            }
+            memcpy(&data[done], &lz->out[lz->out_pos], n);
+            lz->out_pos += n;
+            done += n;
+            continue;
+        }
+
+        rb_spans_t sp;
+        uint8_t hdr[LZ_FRAME_HDR];
+
+        if (rb_read_spans(rb, LZ_FRAME_HDR, &sp) < LZ_FRAME_HDR) {
+            break;
+        }
+        rb_spans_copy_out(&sp, 0, hdr, LZ_FRAME_HDR);
+
+        uint16_t stored = (uint16_t)(hdr[0] | (hdr[1] << 8));
+        uint16_t raw = (uint16_t)(hdr[2] | (hdr[3] << 8));
+        uint16_t frame = LZ_FRAME_HDR + stored;
+
+        /* 帧由生产者整体发布，这里总能取到完整负载 */
+        rb_read_spans(rb, frame, &sp);
+
+        /* 整块放得下时直接解压到用户缓冲区 */
+        uint8_t *dst = (raw <= len - done) ? &data[done] : lz->out;
+
+        if (stored == raw) {
+            rb_spans_copy_out(&sp, LZ_FRAME_HDR, dst, raw);
+        } else {
+            const uint8_t *src = sp.ptr[0] + LZ_FRAME_HDR;
+
+            if (sp.len[0] < frame) {
+                /* 负载跨越环绕点，先拼成连续数据 */
+                rb_spans_copy_out(&sp, LZ_FRAME_HDR, lz->frame, stored);
+                src = lz->frame;
+            }
+
+            if (lz_decompress(src, stored, dst, raw) != raw) {
+                raw = 0;    /* 帧损坏，丢弃 */
+            }
+        }
+
+        rb_commit_read(rb, frame);
+
+        if (dst == lz->out) {
+            lz->out_pos = 0;
+            lz->out_len = raw;
+        } else {
+            done += raw;
+        }
+    }
+
+    if (done > 0) {
+        __atomic_store_n(&lz->raw_out, lz->raw_out + done, __ATOMIC_RELEASE);
+    }
+
+    return done;
+}
+
+/*
+ * 单字节读写按长度 1 的块处理：每个字节单独成帧，占 LZ_FRAME_HDR + 1 字节存储区。
+ * 逐字节产生的数据应先攒成块再 write_multi，否则容量只有普通缓冲区的 1/5
+ */
+static bool lz_write(ring_buffer_t *rb, uint8_t data)
+{
+    return lz_write_multi(rb, &data, 1) == 1;
+}
+
+static bool lz_read(ring_buffer_t *rb, uint8_t *data)
+{
+    return lz_read_multi(rb, data, 1) == 1;
+}
+
+static uint16_t lz_available(const ring_buffer_t *rb)
+{
+    const ring_buffer_lz_t *lz = (const ring_buffer_lz_t *)rb->ctx;
+    uint32_t raw_in = __atomic_load_n(&lz->raw_in, __ATOMIC_ACQUIRE);
+    uint32_t raw_out = __atomic_load_n(&lz->raw_out, __ATOMIC_ACQUIRE);
+    int32_t n = (int32_t)(raw_in - raw_out);
+
+    /* raw_in 在帧提交之后才更新，消费者可能先解压读走使 raw_out 超过 raw_in；此时按 0 计 */
+    if (n <= 0) {
+        return 0;
+    }
+    return (n > 0xFFFF) ? 0xFFFF : (uint16_t)n;
+}
+
+static uint16_t lz_free_space(const ring_buffer_t *rb)
+{
+    uint16_t free = rb_free_space(rb);
+
+    return (free > LZ_FRAME_HDR) ? (uint16_t)(free - LZ_FRAME_HDR) : 0;
+}
+
+static bool lz_is_empty(const ring_buffer_t *rb)
+{
+    return lz_available(rb) == 0;
+}
+
+static bool lz_is_full(const ring_buffer_t *rb)
+{
+    return lz_free_space(rb) == 0;
+}
+
+static void lz_clear(ring_buffer_t *rb)
+{
+    ring_buffer_lz_t *lz = (ring_buffer_lz_t *)rb->ctx;
+
+    ring_buffer_lockfree_ops.clear(rb);
+    lz->out_pos = 0;
+    lz->out_len = 0;
+    __atomic_store_n(&lz->raw_out, __atomic_load_n(&lz->raw_in, __ATOMIC_ACQUIRE),
+                     __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 分散读取：解压后的数据足够填满全部数据段时才读出
+ *
+ * 单消费者，检查之后可读数据只增不减，逐段读出不会半途不足；仍以实际读出量为准
+ */
+static uint16_t lz_readv(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    uint32_t total = 0;
+    uint32_t done = 0;
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+    if (total == 0 || total > lz_available(rb)) {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        if (iov[i].len > 0) {
+            done += lz_read_multi(rb, (uint8_t *)iov[i].base, iov[i].len);
+        }
+    }
+
+    return (uint16_t)done;
+}
+
+/* 以下操作不适用于压缩数据，显式拒绝（关闭参数检查时入口不再判空） */
+
+#if RING_BUFFER_ENABLE_CRC
+static uint16_t lz_write_multi_crc(ring_buffer_t *rb, const uint8_t *data, uint16_t len,
+                                   ring_buffer_crc_type_t type, uint32_t *crc)
+{
+    (void)rb; (void)data; (void)len; (void)type; (void)crc;
+    return 0;
+}
+
+static uint16_t lz_read_multi_crc(ring_buffer_t *rb, uint8_t *data, uint16_t len,
+                                  ring_buffer_crc_type_t type, uint32_t *crc)
+{
+    (void)rb; (void)data; (void)len; (void)type; (void)crc;
+    return 0;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_FD_IO
+static ssize_t lz_fd_unsupported(ring_buffer_t *rb, int fd, uint16_t max)
+{
+    (void)rb; (void)fd; (void)max;
+    errno = ENOTSUP;
+    return -1;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_RESIZE
+static bool lz_resize(ring_buffer_t *rb, uint8_t *buffer, uint16_t size,
+                      uint8_t **old, uint16_t *old_size)
+{
+    (void)rb; (void)buffer; (void)size; (void)old; (void)old_size;
+    return false;
+}
+#endif
+
+/* Private constant ----------------------------------------------------------*/
+
+static const struct ring_buffer_ops ring_buffer_lz_ops = {
+    .write       = lz_write,
+    .read        = lz_read,
+    .write_multi = lz_write_multi,
+    .read_multi  = lz_read_multi,
+    .available   = lz_available,
+    .free_space  = lz_free_space,
+    .is_empty    = lz_is_empty,
+    .is_full     = lz_is_full,
+    .clear       = lz_clear,
+    .writev      = lz_writev,
+    .readv       = lz_readv,
+#if RING_BUFFER_ENABLE_CRC
+    .write_multi_crc = lz_write_multi_crc,
+    .read_multi_crc  = lz_read_multi_crc,
+#endif
+#if RING_BUFFER_ENABLE_FD_IO
+    .fill_from_fd    = lz_fd_unsupported,
+    .drain_to_fd     = lz_fd_unsupported,
+#endif
+#if RING_BUFFER_ENABLE_RESIZE
+    .resize          = lz_resize,
+#endif
+};
+
+/* Exported functions --------------------------------------------------------*/
+
+bool ring_buffer_lz_create(ring_buffer_t *rb, ring_buffer_lz_t *lz, uint8_t *buffer, uint16_t size)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (rb == NULL || lz == NULL || size <= LZ_FRAME_HDR + 1) {
+        return false;
+    }
+#endif
+
+    if (!ring_buffer_create(rb, buffer, size, RING_BUFFER_TYPE_LOCKFREE)) {
+        return false;
+    }
+
+    lz->out_pos = 0;
+    lz->out_len = 0;
+    lz->raw_in = 0;
+    lz->raw_out = 0;
+    lz->packed_in = 0;
+
+    rb->ctx = lz;
+    rb->ops = &ring_buffer_lz_ops;
+    return true;
+}
+
+#endif /* RING_BUFFER_ENABLE_LZ */
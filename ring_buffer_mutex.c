@@ -4,48 +4,67 @@
  * @author  CRITTY.熙影
  * @date    2024-12-27
  * @version 2.1
- * 
+ *
  * @details
  * 适用场景：
  * - FreeRTOS / RT-Thread / μC/OS 等 RTOS 环境
  * - 多线程之间的缓冲区共享
  * - 需要阻塞等待的场景
- * 
+ *
  * 线程安全保证：
- * - 使用 RTOS 互斥锁（Mutex）保护
+ * - 读写、清空等修改操作使用 RTOS 互斥锁（Mutex）保护
  * - 支持优先级继承（防止优先级反转）
- * 
+ * - 状态查询（available / free_space / is_empty / is_full）不加锁，
+ *   读取同一时刻的一对 head / tail，结果与加锁查询同样准确；
+ *   轮询大量缓冲区水位的调度循环不再产生锁争用与优先级继承抖动
+ *
+ * 锁外拷贝（RING_BUFFER_MUTEX_COPY_OUTSIDE）：
+ * - 长写入在锁内只预留 [rsv.head, rsv.head + n)，解锁后拷贝，
+ *   拷完加锁标记完成；从最早的预留起连续完成的部分一次提交到 head
+ * - 后预留者先拷完时不等待，由最早的预留者拷完后顺带提交，
+ *   消费者看到的数据始终按预留顺序、且每次写入完整
+ * - 短写入与预留槽用尽时在锁内拷贝，拷完并入最后一条预留一起提交
+ * - 读取仍在锁内拷贝；状态查询只反映已提交的数据
+ *
  * @warning 不可在 ISR 中使用
  */
 
-#include "ring_buffer.h"
+#include "ring_buffer_decorator.h"
+#include "ring_buffer_internal.h"
 
 #if RING_BUFFER_ENABLE_MUTEX
 
-/* RTOS 互斥锁宏在 ring_buffer_config.h 中定义 */
+#if RING_BUFFER_MUTEX_COPY_OUTSIDE && RING_BUFFER_ENABLE_FD_IO
+#include <errno.h>
+#endif
 
-/* 复用无锁实现的内部逻辑 */
-extern const struct ring_buffer_ops ring_buffer_lockfree_ops;
+/* RTOS 互斥锁宏在 ring_buffer_config.h 中定义 */
 
 /* Exported functions (for factory) ------------------------------------------*/
 
 bool ring_buffer_mutex_init(ring_buffer_t *rb)
 {
     if (!rb) return false;
-    
+
     mutex_t mutex = MUTEX_CREATE();
     if (!MUTEX_IS_VALID(mutex)) {
         return false;
     }
-    
+
     rb->lock = (void*)mutex;
+
+#if RING_BUFFER_MUTEX_COPY_OUTSIDE
+    memset(&rb->rsv, 0, sizeof(rb->rsv));
+    rb->rsv.head = rb->head;
+#endif
+
     return true;
 }
 
 void ring_buffer_mutex_deinit(ring_buffer_t *rb)
 {
     if (!rb || !rb->lock) return;
-    
+
     mutex_t mutex = (mutex_t)rb->lock;
     MUTEX_DELETE(mutex);
     rb->lock = NULL;
@@ -53,134 +72,286 @@ void ring_buffer_mutex_deinit(ring_buffer_t *rb)
 
 /* Exported functions (Implementation) ---------------------------------------*/
 
-static bool mutex_write(ring_buffer_t *rb, uint8_t data)
+#if RING_BUFFER_MUTEX_COPY_OUTSIDE
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief 从 rsv.head 起预留空间（持锁调用）
+ *
+ * @param all true = 放不下全部时不预留
+ *
+ * @return 预留的字节数，起点通过 pos 返回
+ */
+static uint16_t mutex_reserve(ring_buffer_t *rb, uint32_t len, bool all, uint16_t *pos)
 {
-    if (!rb || !rb->lock) return false;
-    
-    mutex_t mutex = (mutex_t)rb->lock;
-    MUTEX_LOCK(mutex);
-    
-    bool ret = ring_buffer_lockfree_ops.write(rb, data);
-    
-    MUTEX_UNLOCK(mutex);
-    return ret;
+    uint16_t used = (uint16_t)(((uint32_t)rb->rsv.head + rb->size - rb->tail) % rb->size);
+    uint16_t room = rb->size - 1 - used;
+    uint16_t n = (len > room) ? (all ? 0 : room) : (uint16_t)len;
+
+#if RING_BUFFER_ENABLE_STATISTICS
+    if (n < len) rb_stat_overflow(rb);
+#endif
+
+    *pos = rb->rsv.head;
+    rb->rsv.head = (uint16_t)(((uint32_t)rb->rsv.head + n) % rb->size);
+    return n;
 }
 
-static bool mutex_read(ring_buffer_t *rb, uint8_t *data)
+/**
+ * @brief 锁内拷贝完成后发布（持锁调用）
+ *
+ * 没有未提交的预留时直接提交；否则并入最后一条预留，随它一起提交
+ */
+static void mutex_publish(ring_buffer_t *rb, uint16_t n)
 {
-    if (!rb || !data || !rb->lock) return false;
-    
-    mutex_t mutex = (mutex_t)rb->lock;
-    MUTEX_LOCK(mutex);
-    
-    bool ret = ring_buffer_lockfree_ops.read(rb, data);
-    
-    MUTEX_UNLOCK(mutex);
-    return ret;
+    ring_buffer_reserve_t *rsv = &rb->rsv;
+
+    if (rsv->count == 0) {
+        rb_commit_write(rb, n);
+    } else {
+        rsv->end[(rsv->first + rsv->count - 1) % RING_BUFFER_MUTEX_MAX_RESERVE] = rsv->head;
+    }
 }
 
-static uint16_t mutex_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
+/**
+ * @brief 标记预留已拷贝完成，并按顺序提交连续完成的部分（持锁调用）
+ */
+static void mutex_complete(ring_buffer_t *rb, uint8_t slot)
 {
-    if (!rb || !data || len == 0 || !rb->lock) return 0;
-    
-    mutex_t mutex = (mutex_t)rb->lock;
-    MUTEX_LOCK(mutex);
-    
-    uint16_t ret = ring_buffer_lockfree_ops.write_multi(rb, data, len);
-    
-    MUTEX_UNLOCK(mutex);
-    return ret;
+    ring_buffer_reserve_t *rsv = &rb->rsv;
+
+    rsv->done |= (uint8_t)(1u << slot);
+
+    while (rsv->count > 0 && (rsv->done & (1u << rsv->first))) {
+        uint16_t end = rsv->end[rsv->first];
+
+        rsv->done &= (uint8_t)~(1u << rsv->first);
+        rsv->first = (uint8_t)((rsv->first + 1) % RING_BUFFER_MUTEX_MAX_RESERVE);
+        rsv->count--;
+        rb_commit_write(rb, (uint16_t)(((uint32_t)end + rb->size - rb->head) % rb->size));
+    }
 }
 
-static uint16_t mutex_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
+/**
+ * @brief 把数据段依次拷入区段，共 n 字节
+ */
+static void mutex_copy_iov(const rb_spans_t *sp, const ring_buffer_iovec_t *iov, uint8_t iovcnt,
+                           uint16_t n)
 {
-    if (!rb || !data || len == 0 || !rb->lock) return 0;
-    
-    mutex_t mutex = (mutex_t)rb->lock;
-    MUTEX_LOCK(mutex);
-    
-    uint16_t ret = ring_buffer_lockfree_ops.read_multi(rb, data, len);
-    
-    MUTEX_UNLOCK(mutex);
-    return ret;
+    uint16_t off = 0;
+
+    for (uint8_t i = 0; i < iovcnt && off < n; i++) {
+        uint16_t len = (iov[i].len > n - off) ? (uint16_t)(n - off) : iov[i].len;
+
+        rb_spans_copy_in(sp, off, (const uint8_t *)iov[i].base, len);
+        off += len;
+    }
 }
 
-static uint16_t mutex_available(const ring_buffer_t *rb)
+/**
+ * @brief 写入数据段：预留 → （锁外）拷贝 → 按序提交
+ *
+ * @param all true = 全部写入或完全不写（writev）
+ */
+static uint16_t mutex_put(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt,
+                          uint32_t total, bool all)
 {
-    if (!rb || !rb->lock) return 0;
-    
     mutex_t mutex = (mutex_t)rb->lock;
+    ring_buffer_reserve_t *rsv = &rb->rsv;
+    rb_spans_t sp;
+    uint16_t pos;
+    uint16_t n;
+    uint8_t slot;
+
+    if (total == 0) {
+        return 0;
+    }
+
     MUTEX_LOCK(mutex);
-    
-    uint16_t ret = ring_buffer_lockfree_ops.available(rb);
-    
+
+    n = mutex_reserve(rb, total, all, &pos);
+    rb_spans_split(rb, pos, n, &sp);
+
+    if (n < RING_BUFFER_MUTEX_COPY_OUTSIDE || rsv->count == RING_BUFFER_MUTEX_MAX_RESERVE) {
+        mutex_copy_iov(&sp, iov, iovcnt, n);
+        if (n > 0) {
+            mutex_publish(rb, n);
+        }
+        MUTEX_UNLOCK(mutex);
+        return n;
+    }
+
+    slot = (uint8_t)((rsv->first + rsv->count) % RING_BUFFER_MUTEX_MAX_RESERVE);
+    rsv->end[slot] = rsv->head;
+    rsv->count++;
     MUTEX_UNLOCK(mutex);
-    return ret;
+
+    mutex_copy_iov(&sp, iov, iovcnt, n);
+
+    MUTEX_LOCK(mutex);
+    mutex_complete(rb, slot);
+    MUTEX_UNLOCK(mutex);
+
+    return n;
+}
+
+static bool mutex_write(ring_buffer_t *rb, uint8_t data)
+{
+    ring_buffer_iovec_t iov = { &data, 1 };
+
+    return mutex_put(rb, &iov, 1, 1, true) == 1;
+}
+
+static uint16_t mutex_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
+{
+    ring_buffer_iovec_t iov = { (void *)data, len };
+
+    return mutex_put(rb, &iov, 1, len, false);
+}
+
+static uint16_t mutex_writev(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    uint32_t total = 0;
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+
+    return mutex_put(rb, iov, iovcnt, total, true);
 }
 
-static uint16_t mutex_free_space(const ring_buffer_t *rb)
+#if RING_BUFFER_ENABLE_CRC
+static uint16_t mutex_write_multi_crc(ring_buffer_t *rb, const uint8_t *data, uint16_t len,
+                                      ring_buffer_crc_type_t type, uint32_t *crc)
 {
-    if (!rb || !rb->lock) return 0;
-    
     mutex_t mutex = (mutex_t)rb->lock;
+    rb_spans_t sp;
+    uint16_t pos;
+    uint16_t n;
+
+    if (len == 0) {
+        return 0;
+    }
+
     MUTEX_LOCK(mutex);
-    
-    uint16_t ret = ring_buffer_lockfree_ops.free_space(rb);
-    
+    n = mutex_reserve(rb, len, false, &pos);
+    if (n > 0) {
+        rb_spans_split(rb, pos, n, &sp);
+        *crc = rb_crc_copy(sp.ptr[0], data, sp.len[0], type, *crc);
+        *crc = rb_crc_copy(sp.ptr[1], &data[sp.len[0]], sp.len[1], type, *crc);
+        mutex_publish(rb, n);
+    }
     MUTEX_UNLOCK(mutex);
-    return ret;
+
+    return n;
 }
+#endif
 
-static bool mutex_is_empty(const ring_buffer_t *rb)
+#if RING_BUFFER_ENABLE_FD_IO
+/* 读入长度事先未知，只在没有锁外拷贝进行中时执行 */
+static ssize_t mutex_fill_from_fd(ring_buffer_t *rb, int fd, uint16_t max)
 {
-    if (!rb || !rb->lock) return true;
-    
     mutex_t mutex = (mutex_t)rb->lock;
+    ssize_t ret;
+
     MUTEX_LOCK(mutex);
-    
-    bool ret = ring_buffer_lockfree_ops.is_empty(rb);
-    
+    if (rb->rsv.count > 0) {
+        errno = EAGAIN;
+        ret = -1;
+    } else {
+        ret = rb_lockfree_fill_from_fd(rb, fd, max);
+        rb->rsv.head = rb->head;
+    }
     MUTEX_UNLOCK(mutex);
+
     return ret;
 }
+#endif
 
-static bool mutex_is_full(const ring_buffer_t *rb)
+#if RING_BUFFER_ENABLE_RESIZE
+/* 锁外拷贝进行中时不能搬走存储区 */
+static bool mutex_resize(ring_buffer_t *rb, uint8_t *buffer, uint16_t size,
+                         uint8_t **old, uint16_t *old_size)
 {
-    if (!rb || !rb->lock) return false;
-    
     mutex_t mutex = (mutex_t)rb->lock;
+    bool ok = false;
+
     MUTEX_LOCK(mutex);
-    
-    bool ret = ring_buffer_lockfree_ops.is_full(rb);
-    
+    if (rb->rsv.count == 0) {
+        ok = rb_lockfree_resize(rb, buffer, size, old, old_size);
+        rb->rsv.head = rb->head;
+    }
     MUTEX_UNLOCK(mutex);
-    return ret;
+
+    return ok;
 }
+#endif
+
+/* 读取与清空：加锁 → 直接调用无锁实现 → 解锁（只涉及已提交的数据） */
+RB_DECORATE_FN(mutex, rb_lockfree, RB_LAYER_MUTEX_ENTER, RB_LAYER_MUTEX_EXIT,
+               RING_BUFFER_OP_READ, bool, read, (ring_buffer_t *rb, uint8_t *data), (rb, data))
+RB_DECORATE_FN(mutex, rb_lockfree, RB_LAYER_MUTEX_ENTER, RB_LAYER_MUTEX_EXIT,
+               RING_BUFFER_OP_READ_MULTI, uint16_t, read_multi,
+               (ring_buffer_t *rb, uint8_t *data, uint16_t len), (rb, data, len))
+RB_DECORATE_FN(mutex, rb_lockfree, RB_LAYER_MUTEX_ENTER, RB_LAYER_MUTEX_EXIT,
+               RING_BUFFER_OP_READV, uint16_t, readv,
+               (ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt),
+               (rb, iov, iovcnt))
+#if RING_BUFFER_ENABLE_CRC
+RB_DECORATE_FN(mutex, rb_lockfree, RB_LAYER_MUTEX_ENTER, RB_LAYER_MUTEX_EXIT,
+               RING_BUFFER_OP_READ_MULTI_CRC, uint16_t, read_multi_crc,
+               (ring_buffer_t *rb, uint8_t *data, uint16_t len,
+                ring_buffer_crc_type_t type, uint32_t *crc),
+               (rb, data, len, type, crc))
+#endif
+#if RING_BUFFER_ENABLE_FD_IO
+RB_DECORATE_FN(mutex, rb_lockfree, RB_LAYER_MUTEX_ENTER, RB_LAYER_MUTEX_EXIT,
+               RING_BUFFER_OP_DRAIN_TO_FD, ssize_t, drain_to_fd,
+               (ring_buffer_t *rb, int fd, uint16_t max), (rb, fd, max))
+#endif
 
+/* 只把 tail 追到已提交的 head，锁外拷贝中的预留不受影响 */
 static void mutex_clear(ring_buffer_t *rb)
 {
-    if (!rb || !rb->lock) return;
-    
-    mutex_t mutex = (mutex_t)rb->lock;
-    MUTEX_LOCK(mutex);
-    
-    ring_buffer_lockfree_ops.clear(rb);
-    
-    MUTEX_UNLOCK(mutex);
+    RB_LAYER_MUTEX_ENTER(rb, RING_BUFFER_OP_CLEAR);
+    rb_lockfree_clear(rb);
+    RB_LAYER_MUTEX_EXIT(rb, RING_BUFFER_OP_CLEAR, 0);
+}
+
+#else
+
+/* 修改操作：加锁 → 直接调用无锁实现 → 解锁（参数已由 ring_buffer.c 入口检查） */
+RING_BUFFER_DECORATE_UPDATES(mutex, rb_lockfree, RB_LAYER_MUTEX_ENTER, RB_LAYER_MUTEX_EXIT)
+
+#endif /* RING_BUFFER_MUTEX_COPY_OUTSIDE */
+
+/* 状态查询：不加锁，结果为调用期间某一时刻的准确值 */
+
+static uint16_t mutex_peek_available(const ring_buffer_t *rb)
+{
+    return rb_peek_available(rb);
+}
+
+static uint16_t mutex_peek_free_space(const ring_buffer_t *rb)
+{
+    return rb_peek_free_space(rb);
+}
+
+static bool mutex_peek_is_empty(const ring_buffer_t *rb)
+{
+    return rb_peek_available(rb) == 0;
+}
+
+static bool mutex_peek_is_full(const ring_buffer_t *rb)
+{
+    return rb_peek_free_space(rb) == 0;
 }
 
 /* Exported constant ---------------------------------------------------------*/
 
-const struct ring_buffer_ops ring_buffer_mutex_ops = {
-    .write       = mutex_write,
-    .read        = mutex_read,
-    .write_multi = mutex_write_multi,
-    .read_multi  = mutex_read_multi,
-    .available   = mutex_available,
-    .free_space  = mutex_free_space,
-    .is_empty    = mutex_is_empty,
-    .is_full     = mutex_is_full,
-    .clear       = mutex_clear,
-};
+/* 两种实现的函数名相同，操作表一致 */
+const struct ring_buffer_ops ring_buffer_mutex_ops =
+    RING_BUFFER_DECORATED_OPS_QUERIES_FROM(mutex, mutex_peek);
 
 #endif /* RING_BUFFER_ENABLE_MUTEX */
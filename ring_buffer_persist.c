@@ -0,0 +1,306 @@
+/**
+ * @file    ring_buffer_persist.c
+ * @brief   环形缓冲区掉电/崩溃可恢复实现
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 黑匣子记录：复位 / 进程崩溃后仍能读出最后的日志
+ * - 电池备份 SRAM、.noinit 段、mmap 文件
+ *
+ * 实现方式：
+ * - 区域布局：[头部][数据区]，头部只含索引，数据区地址由头部推算
+ * - 读写复用无锁实现，完成后经写屏障把 head / tail 同步到头部
+ * - 打开时校验头部，索引合法则恢复 [tail, head)，否则初始化为空
+ *
+ * 一致性保证：
+ * - 持久 head 只会指向已完整写入的数据
+ * - 持久 tail 只会在数据读出后前移，崩溃时最多重复读出一批数据
+ *
+ * @warning SPSC 语义同无锁模式；带数据缓存的 MCU 需将区域配置为不可缓存
+ */
+
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_PERSIST
+
+#if RING_BUFFER_PERSIST_MSYNC
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+/* 复用无锁实现的内部逻辑 */
+extern const struct ring_buffer_ops ring_buffer_lockfree_ops;
+
+/* Private defines -----------------------------------------------------------*/
+
+/**
+ * @brief 持久化写屏障：之前的数据存储先于之后的索引存储
+ */
+#if defined(__GNUC__)
+#define PERSIST_BARRIER()  __atomic_thread_fence(__ATOMIC_RELEASE)
+#else
+#define PERSIST_BARRIER()  do { } while (0)
+#endif
+
+/* Private functions ---------------------------------------------------------*/
+
+static inline ring_buffer_persist_hdr_t *persist_hdr(const ring_buffer_t *rb)
+{
+    return (ring_buffer_persist_hdr_t *)(rb->buffer - sizeof(ring_buffer_persist_hdr_t));
+}
+
+static inline void persist_publish_head(ring_buffer_t *rb)
+{
+    PERSIST_BARRIER();
+    persist_hdr(rb)->head = rb->head;
+}
+
+static inline void persist_publish_tail(ring_buffer_t *rb)
+{
+    PERSIST_BARRIER();
+    persist_hdr(rb)->tail = rb->tail;
+}
+
+static bool persist_hdr_valid(const ring_buffer_persist_hdr_t *hdr, uint16_t size)
+{
+    uint16_t size_inv = (uint16_t)~size;
+
+    return hdr->magic == RING_BUFFER_PERSIST_MAGIC &&
+           hdr->version == RING_BUFFER_PERSIST_VERSION &&
+           hdr->header_size == sizeof(ring_buffer_persist_hdr_t) &&
+           hdr->size == size &&
+           hdr->size_inv == size_inv &&
+           hdr->head < size &&
+           hdr->tail < size;
+}
+
+/* Exported functions (Implementation) ---------------------------------------*/
+
+static bool persist_write(ring_buffer_t *rb, uint8_t data)
+{
+    bool ret = ring_buffer_lockfree_ops.write(rb, data);
+
+    if (ret) {
+        persist_publish_head(rb);
+    }
+    return ret;
+}
+
+static bool persist_read(ring_buffer_t *rb, uint8_t *data)
+{
+    bool ret = ring_buffer_lockfree_ops.read(rb, data);
+
+    if (ret) {
+        persist_publish_tail(rb);
+    }
+    return ret;
+}
+
+static uint16_t persist_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
+{
+    uint16_t ret = ring_buffer_lockfree_ops.write_multi(rb, data, len);
+
+    if (ret) {
+        persist_publish_head(rb);
+    }
+    return ret;
+}
+
+static uint16_t persist_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
+{
+    uint16_t ret = ring_buffer_lockfree_ops.read_multi(rb, data, len);
+
+    if (ret) {
+        persist_publish_tail(rb);
+    }
+    return ret;
+}
+
+static uint16_t persist_writev(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    uint16_t ret = ring_buffer_lockfree_ops.writev(rb, iov, iovcnt);
+
+    if (ret) {
+        persist_publish_head(rb);
+    }
+    return ret;
+}
+
+static uint16_t persist_readv(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    uint16_t ret = ring_buffer_lockfree_ops.readv(rb, iov, iovcnt);
+
+    if (ret) {
+        persist_publish_tail(rb);
+    }
+    return ret;
+}
+
+static uint16_t persist_available(const ring_buffer_t *rb)
+{
+    return rb_available(rb);
+}
+
+static uint16_t persist_free_space(const ring_buffer_t *rb)
+{
+    return rb_free_space(rb);
+}
+
+static bool persist_is_empty(const ring_buffer_t *rb)
+{
+    return (rb->head == rb->tail);
+}
+
+static bool persist_is_full(const ring_buffer_t *rb)
+{
+    return ((rb->head + 1) % rb->size == rb->tail);
+}
+
+static void persist_clear(ring_buffer_t *rb)
+{
+    ring_buffer_lockfree_ops.clear(rb);
+    persist_publish_tail(rb);
+}
+
+#if RING_BUFFER_ENABLE_CRC
+static uint16_t persist_write_multi_crc(ring_buffer_t *rb, const uint8_t *data, uint16_t len,
+                                       ring_buffer_crc_type_t type, uint32_t *crc)
+{
+    uint16_t ret = ring_buffer_lockfree_ops.write_multi_crc(rb, data, len, type, crc);
+
+    if (ret) {
+        persist_publish_head(rb);
+    }
+    return ret;
+}
+
+static uint16_t persist_read_multi_crc(ring_buffer_t *rb, uint8_t *data, uint16_t len,
+                                      ring_buffer_crc_type_t type, uint32_t *crc)
+{
+    uint16_t ret = ring_buffer_lockfree_ops.read_multi_crc(rb, data, len, type, crc);
+
+    if (ret) {
+        persist_publish_tail(rb);
+    }
+    return ret;
+}
+#endif /* RING_BUFFER_ENABLE_CRC */
+
+#if RING_BUFFER_ENABLE_FD_IO
+static ssize_t persist_fill_from_fd(ring_buffer_t *rb, int fd, uint16_t max)
+{
+    ssize_t ret = ring_buffer_lockfree_ops.fill_from_fd(rb, fd, max);
+
+    if (ret > 0) {
+        persist_publish_head(rb);
+    }
+    return ret;
+}
+
+static ssize_t persist_drain_to_fd(ring_buffer_t *rb, int fd, uint16_t max)
+{
+    ssize_t ret = ring_buffer_lockfree_ops.drain_to_fd(rb, fd, max);
+
+    if (ret > 0) {
+        persist_publish_tail(rb);
+    }
+    return ret;
+}
+#endif /* RING_BUFFER_ENABLE_FD_IO */
+
+/* Private constant ----------------------------------------------------------*/
+
+static const struct ring_buffer_ops ring_buffer_persist_ops = {
+    .write       = persist_write,
+    .read        = persist_read,
+    .write_multi = persist_write_multi,
+    .read_multi  = persist_read_multi,
+    .available   = persist_available,
+    .free_space  = persist_free_space,
+    .is_empty    = persist_is_empty,
+    .is_full     = persist_is_full,
+    .clear       = persist_clear,
+    .writev      = persist_writev,
+    .readv       = persist_readv,
+#if RING_BUFFER_ENABLE_CRC
+    .write_multi_crc = persist_write_multi_crc,
+    .read_multi_crc  = persist_read_multi_crc,
+#endif
+#if RING_BUFFER_ENABLE_FD_IO
+    .fill_from_fd    = persist_fill_from_fd,
+    .drain_to_fd     = persist_drain_to_fd,
+#endif
+};
+
+/* Exported functions --------------------------------------------------------*/
+
+ring_buffer_persist_result_t ring_buffer_persist_open(ring_buffer_t *rb, void *region,
+                                                      size_t region_len)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (rb == NULL || region == NULL ||
+        region_len < RING_BUFFER_PERSIST_REGION_SIZE(RING_BUFFER_MIN_SIZE)) {
+        return RING_BUFFER_PERSIST_ERROR;
+    }
+#endif
+
+    ring_buffer_persist_hdr_t *hdr = (ring_buffer_persist_hdr_t *)region;
+    uint8_t *data = (uint8_t *)region + sizeof(ring_buffer_persist_hdr_t);
+    size_t data_len = region_len - sizeof(ring_buffer_persist_hdr_t);
+    uint16_t size = (data_len > 0xFFFF) ? 0xFFFF : (uint16_t)data_len;
+    ring_buffer_persist_result_t result;
+
+    if (!ring_buffer_create(rb, data, size, RING_BUFFER_TYPE_LOCKFREE)) {
+        return RING_BUFFER_PERSIST_ERROR;
+    }
+
+    if (persist_hdr_valid(hdr, size)) {
+        rb->head = hdr->head;
+        rb->tail = hdr->tail;
+        hdr->recover_count++;
+        result = RING_BUFFER_PERSIST_RECOVERED;
+    } else {
+        /* 先让头部失效，字段齐全后再写 magic */
+        hdr->magic = 0;
+        PERSIST_BARRIER();
+        hdr->version = RING_BUFFER_PERSIST_VERSION;
+        hdr->header_size = sizeof(ring_buffer_persist_hdr_t);
+        hdr->size = size;
+        hdr->size_inv = (uint16_t)~size;
+        hdr->head = 0;
+        hdr->tail = 0;
+        hdr->recover_count = 0;
+        PERSIST_BARRIER();
+        hdr->magic = RING_BUFFER_PERSIST_MAGIC;
+        result = RING_BUFFER_PERSIST_NEW;
+    }
+
+    rb->ops = &ring_buffer_persist_ops;
+    return result;
+}
+
+void ring_buffer_persist_sync(ring_buffer_t *rb)
+{
+    (void)rb;   /* 关闭参数检查且不 msync 时未使用 */
+
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (rb == NULL || rb->ops != &ring_buffer_persist_ops) {
+        return;
+    }
+#endif
+
+    PERSIST_BARRIER();
+
+#if RING_BUFFER_PERSIST_MSYNC
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)persist_hdr(rb) & ~(page - 1);
+    uintptr_t end = (uintptr_t)(rb->buffer + rb->size);
+
+    msync((void *)start, end - start, MS_SYNC);
+#endif
+}
+
+#endif /* RING_BUFFER_ENABLE_PERSIST */
@@ -0,0 +1,485 @@
+/**
+ * @file    ring_buffer_segmented.c
+ * @brief   环形缓冲区分段（块链表）实现
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 突发型生产者：平时数据很少，偶尔短时间内涌入大量数据
+ * - 多个缓冲区共享一块内存，按需分配，而非各自按峰值预留
+ *
+ * 实现方式：
+ * - 数据存放在定长块组成的单向链表中，生产者写满一块后链接新块
+ * - 消费者读空一块且已有后继块时，把该块归还块池
+ * - 块内 wr 只由生产者写，rd 只由消费者写，链表 next 由生产者发布
+ * - 生产者只在移到新块上时才链接它，链表末尾总是生产者正在写的块，
+ *   消费者不会归还生产者仍在使用的块
+ *
+ * 线程安全保证：
+ * - 单个缓冲区为 SPSC 无锁协议
+ * - 块池由 RING_BUFFER_SEG_POOL_LOCK/UNLOCK 保护
+ *
+ * @warning 禁止多个生产者或多个消费者同时访问同一缓冲区
+ */
+
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_SEGMENTED
+
+#if RING_BUFFER_SEG_CHUNK_SIZE > 0xFFFF
+#error "RING_BUFFER_SEG_CHUNK_SIZE 不能超过 65535"
+#endif
+
+#define SEG_CHUNK  RING_BUFFER_SEG_CHUNK_SIZE
+
+/* Private functions ---------------------------------------------------------*/
+
+static ring_buffer_seg_chunk_t *seg_pool_get(ring_buffer_seg_pool_t *pool)
+{
+    ring_buffer_seg_chunk_t *c;
+
+    RING_BUFFER_SEG_POOL_LOCK();
+    c = pool->free_list;
+    if (c != NULL) {
+        pool->free_list = c->next;
+        pool->free_count--;
+    }
+    RING_BUFFER_SEG_POOL_UNLOCK();
+
+    return c;
+}
+
+static void seg_pool_put(ring_buffer_seg_pool_t *pool, ring_buffer_seg_chunk_t *c)
+{
+    RING_BUFFER_SEG_POOL_LOCK();
+    c->next = pool->free_list;
+    pool->free_list = c;
+    pool->free_count++;
+    RING_BUFFER_SEG_POOL_UNLOCK();
+}
+
+static inline uint16_t seg_in_use(const ring_buffer_seg_t *seg)
+{
+    return (uint16_t)(seg->allocated - __atomic_load_n(&seg->released, __ATOMIC_ACQUIRE));
+}
+
+/**
+ * @brief 从块池取一个空块，尚未链接（生产者）
+ */
+static ring_buffer_seg_chunk_t *seg_take(ring_buffer_seg_t *seg)
+{
+    if (seg->max_chunks != 0 && seg_in_use(seg) >= seg->max_chunks) {
+        return NULL;
+    }
+
+    ring_buffer_seg_chunk_t *c = seg_pool_get(seg->pool);
+    if (c == NULL) {
+        return NULL;
+    }
+
+    c->next = NULL;
+    c->wr = 0;
+    c->rd = 0;
+    seg->allocated++;
+    return c;
+}
+
+/**
+ * @brief 把未链接的块链表归还块池（生产者撤销预留）
+ */
+static void seg_untake(ring_buffer_seg_t *seg, ring_buffer_seg_chunk_t *list)
+{
+    while (list != NULL) {
+        ring_buffer_seg_chunk_t *next = list->next;
+
+        seg_pool_put(seg->pool, list);
+        seg->allocated--;
+        list = next;
+    }
+}
+
+/**
+ * @brief 在生产者当前块之后链接新块并移到新块上（生产者）
+ */
+static ring_buffer_seg_chunk_t *seg_extend(ring_buffer_seg_t *seg, ring_buffer_seg_chunk_t *last)
+{
+    ring_buffer_seg_chunk_t *c = seg_take(seg);
+    if (c == NULL) {
+        return NULL;
+    }
+
+    /* 块初始化完成后才对消费者可见；此后 last 可能随时被消费者归还 */
+    __atomic_store_n(&last->next, c, __ATOMIC_RELEASE);
+    seg->wr_chunk = c;
+    return c;
+}
+
+/**
+ * @brief 读出或丢弃数据（消费者）
+ *
+ * @param dst 目的地址，NULL 表示丢弃
+ */
+static uint32_t seg_consume(ring_buffer_t *rb, uint8_t *dst, uint32_t len)
+{
+    ring_buffer_seg_t *seg = (ring_buffer_seg_t *)rb->ctx;
+    uint32_t done = 0;
+
+    while (done < len) {
+        ring_buffer_seg_chunk_t *c = seg->rd_chunk;
+        uint16_t wr = __atomic_load_n(&c->wr, __ATOMIC_ACQUIRE);
+        uint16_t rd = c->rd;
+
+        if (rd < wr) {
+            uint16_t n = wr - rd;
+            if (n > len - done) {
+                n = (uint16_t)(len - done);
+            }
+            if (dst != NULL) {
+                rb_copy(&dst[done], &c->data[rd], n);
+            }
+            c->rd = rd + n;
+            done += n;
+            continue;
+        }
+
+        /* 本块已读空：块未写满说明没有更多数据 */
+        if (rd < SEG_CHUNK) {
+            break;
+        }
+
+        ring_buffer_seg_chunk_t *next = __atomic_load_n(&c->next, __ATOMIC_ACQUIRE);
+        if (next == NULL) {
+            break;
+        }
+
+        seg->rd_chunk = next;
+        seg_pool_put(seg->pool, c);
+        __atomic_store_n(&seg->released, (uint16_t)(seg->released + 1), __ATOMIC_RELEASE);
+    }
+
+    if (done > 0) {
+        __atomic_store_n(&seg->read, seg->read + done, __ATOMIC_RELEASE);
+#if RING_BUFFER_ENABLE_STATISTICS
+        rb_stat_read(rb, done);
+#endif
+    }
+
+    return done;
+}
+
+static inline uint16_t seg_clamp(uint32_t n)
+{
+    return (n > 0xFFFF) ? 0xFFFF : (uint16_t)n;
+}
+
+/* Exported functions (Implementation) ---------------------------------------*/
+
+static uint16_t seg_write_multi(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
+{
+    ring_buffer_seg_t *seg = (ring_buffer_seg_t *)rb->ctx;
+    uint16_t done = 0;
+
+    while (done < len) {
+        ring_buffer_seg_chunk_t *c = seg->wr_chunk;
+        uint16_t wr = c->wr;
+
+        if (wr == SEG_CHUNK) {
+            if (seg_extend(seg, c) == NULL) {
+                break;  /* 块池耗尽或达到上限 */
+            }
+            continue;
+        }
+
+        uint16_t n = SEG_CHUNK - wr;
+        if (n > len - done) {
+            n = len - done;
+        }
+
+        rb_copy(&c->data[wr], &data[done], n);
+        __atomic_store_n(&c->wr, (uint16_t)(wr + n), __ATOMIC_RELEASE);
+        done += n;
+    }
+
+    if (done > 0) {
+        __atomic_store_n(&seg->written, seg->written + done, __ATOMIC_RELEASE);
+    }
+
+#if RING_BUFFER_ENABLE_STATISTICS
+    rb_stat_write(rb, done);
+    if (done < len) rb_stat_overflow(rb);
+#endif
+
+    return done;
+}
+
+static uint16_t seg_read_multi(ring_buffer_t *rb, uint8_t *data, uint16_t len)
+{
+    return (uint16_t)seg_consume(rb, data, len);
+}
+
+static bool seg_write(ring_buffer_t *rb, uint8_t data)
+{
+    return seg_write_multi(rb, &data, 1) == 1;
+}
+
+static bool seg_read(ring_buffer_t *rb, uint8_t *data)
+{
+    return seg_consume(rb, data, 1) == 1;
+}
+
+static uint16_t seg_available(const ring_buffer_t *rb)
+{
+    const ring_buffer_seg_t *seg = (const ring_buffer_seg_t *)rb->ctx;
+    uint32_t written = __atomic_load_n(&seg->written, __ATOMIC_ACQUIRE);
+    uint32_t read = __atomic_load_n(&seg->read, __ATOMIC_ACQUIRE);
+    int32_t n = (int32_t)(written - read);
+
+    /*
+     * written 在数据可见之后才更新，消费者可能先读走数据使 read 超过 written；
+     * 此时按 0 计。结果因此不会多于实际可读的数据
+     */
+    return (n > 0) ? seg_clamp((uint32_t)n) : 0;
+}
+
+static uint16_t seg_free_space(const ring_buffer_t *rb)
+{
+    const ring_buffer_seg_t *seg = (const ring_buffer_seg_t *)rb->ctx;
+    uint32_t room = SEG_CHUNK - seg->wr_chunk->wr;  /* 生产者当前块总是链表末尾 */
+    uint32_t chunks = seg->pool->free_count;
+
+    if (seg->max_chunks != 0) {
+        uint16_t in_use = seg_in_use(seg);
+        uint32_t limit = (in_use < seg->max_chunks) ? (uint32_t)(seg->max_chunks - in_use) : 0;
+        if (chunks > limit) {
+            chunks = limit;
+        }
+    }
+
+    return seg_clamp(room + chunks * SEG_CHUNK);
+}
+
+static bool seg_is_empty(const ring_buffer_t *rb)
+{
+    return seg_available(rb) == 0;
+}
+
+static bool seg_is_full(const ring_buffer_t *rb)
+{
+    return seg_free_space(rb) == 0;
+}
+
+static void seg_clear(ring_buffer_t *rb)
+{
+    while (seg_consume(rb, NULL, 0xFFFFFFFFU) > 0) {
+    }
+
+#if RING_BUFFER_ENABLE_STATISTICS
+    rb_stat_reset(rb);
+#endif
+}
+
+static uint16_t seg_writev(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    ring_buffer_seg_t *seg = (ring_buffer_seg_t *)rb->ctx;
+    ring_buffer_seg_chunk_t *cur = seg->wr_chunk;
+    ring_buffer_seg_chunk_t *head = NULL;
+    ring_buffer_seg_chunk_t *tail = NULL;
+    uint32_t total = 0;
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+
+    if (total == 0 || total > 0xFFFF) {
+        return 0;
+    }
+
+    /* 先把所需的空块取到私有链表中，空间不足时全部归还，完全不写 */
+    for (uint32_t room = SEG_CHUNK - cur->wr; room < total; room += SEG_CHUNK) {
+        ring_buffer_seg_chunk_t *c = seg_take(seg);
+
+        if (c == NULL) {
+            seg_untake(seg, head);
+#if RING_BUFFER_ENABLE_STATISTICS
+            rb_stat_overflow(rb);
+#endif
+            return 0;
+        }
+        if (tail != NULL) {
+            tail->next = c;
+        } else {
+            head = c;
+        }
+        tail = c;
+    }
+
+    /* 拷入当前块剩余部分与私有块，此时都还对消费者不可见 */
+    ring_buffer_seg_chunk_t *dst = cur;
+    uint16_t pos = cur->wr;
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        const uint8_t *src = (const uint8_t *)iov[i].base;
+        uint16_t left = iov[i].len;
+
+        while (left > 0) {
+            if (pos == SEG_CHUNK) {
+                if (dst != cur) {
+                    dst->wr = SEG_CHUNK;
+                }
+                dst = (dst == cur) ? head : dst->next;
+                pos = 0;
+            }
+
+            uint16_t n = SEG_CHUNK - pos;
+            if (n > left) {
+                n = left;
+            }
+            rb_copy(&dst->data[pos], src, n);
+            pos += n;
+            src += n;
+            left -= n;
+        }
+    }
+
+    /*
+     * 一次发布：先链接私有块，再更新当前块的 wr。消费者要在当前块读到
+     * wr == SEG_CHUNK 之后才会沿 next 前进，看不到半条记录
+     */
+    if (head != NULL) {
+        dst->wr = pos;
+        __atomic_store_n(&cur->next, head, __ATOMIC_RELEASE);
+        seg->wr_chunk = dst;
+        if (cur->wr != SEG_CHUNK) {
+            __atomic_store_n(&cur->wr, (uint16_t)SEG_CHUNK, __ATOMIC_RELEASE);
+        }
+    } else {
+        __atomic_store_n(&cur->wr, pos, __ATOMIC_RELEASE);
+    }
+
+    __atomic_store_n(&seg->written, seg->written + total, __ATOMIC_RELEASE);
+#if RING_BUFFER_ENABLE_STATISTICS
+    rb_stat_write(rb, total);
+#endif
+
+    return (uint16_t)total;
+}
+
+static uint16_t seg_readv(ring_buffer_t *rb, const ring_buffer_iovec_t *iov, uint8_t iovcnt)
+{
+    uint32_t total = 0;
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        total += iov[i].len;
+    }
+
+    if (total == 0 || total > seg_available(rb)) {
+        return 0;
+    }
+
+    /* seg_available 不会多算，这里总能读满；仍以实际读出量为准 */
+    uint32_t done = 0;
+
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        done += seg_consume(rb, (uint8_t *)iov[i].base, iov[i].len);
+    }
+
+    return (uint16_t)done;
+}
+
+/* Private constant ----------------------------------------------------------*/
+
+static const struct ring_buffer_ops ring_buffer_seg_ops = {
+    .write       = seg_write,
+    .read        = seg_read,
+    .write_multi = seg_write_multi,
+    .read_multi  = seg_read_multi,
+    .available   = seg_available,
+    .free_space  = seg_free_space,
+    .is_empty    = seg_is_empty,
+    .is_full     = seg_is_full,
+    .clear       = seg_clear,
+    .writev      = seg_writev,
+    .readv       = seg_readv,
+};
+
+/* Exported functions --------------------------------------------------------*/
+
+void ring_buffer_seg_pool_init(ring_buffer_seg_pool_t *pool, ring_buffer_seg_chunk_t *chunks,
+                               uint16_t count)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (pool == NULL || (chunks == NULL && count > 0)) {
+        return;
+    }
+#endif
+
+    pool->free_list = NULL;
+    pool->free_count = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        chunks[i].next = pool->free_list;
+        pool->free_list = &chunks[i];
+        pool->free_count++;
+    }
+}
+
+bool ring_buffer_seg_create(ring_buffer_t *rb, ring_buffer_seg_t *seg,
+                            ring_buffer_seg_pool_t *pool, uint16_t max_chunks)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (rb == NULL || seg == NULL || pool == NULL) {
+        return false;
+    }
+#endif
+
+    ring_buffer_seg_chunk_t *c = seg_pool_get(pool);
+    if (c == NULL) {
+        return false;
+    }
+
+    c->next = NULL;
+    c->wr = 0;
+    c->rd = 0;
+
+    memset(seg, 0, sizeof(*seg));
+    seg->pool = pool;
+    seg->rd_chunk = c;
+    seg->wr_chunk = c;
+    seg->allocated = 1;
+    seg->max_chunks = max_chunks;
+
+    /* 借用工厂函数完成公共初始化，数据不经过 buffer / size */
+    ring_buffer_create(rb, c->data, SEG_CHUNK, RING_BUFFER_TYPE_LOCKFREE);
+    rb->buffer = NULL;
+    rb->size = 0;
+    rb->ctx = seg;
+    rb->ops = &ring_buffer_seg_ops;
+
+    return true;
+}
+
+void ring_buffer_seg_destroy(ring_buffer_t *rb)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (rb == NULL || rb->ops != &ring_buffer_seg_ops) {
+        return;
+    }
+#endif
+
+    ring_buffer_seg_t *seg = (ring_buffer_seg_t *)rb->ctx;
+    ring_buffer_seg_chunk_t *c = seg->rd_chunk;
+
+    while (c != NULL) {
+        ring_buffer_seg_chunk_t *next = c->next;
+        seg_pool_put(seg->pool, c);
+        c = next;
+    }
+
+    seg->rd_chunk = NULL;
+    seg->wr_chunk = NULL;
+    ring_buffer_destroy(rb);
+}
+
+#endif /* RING_BUFFER_ENABLE_SEGMENTED */
@@ -0,0 +1,201 @@
+/**
+ * @file    ring_buffer_set.c
+ * @brief   多缓冲区选择器
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 主循环同时服务多个 UART / CAN / SPI 接收缓冲区
+ * - 任务阻塞等待任一缓冲区有数据
+ *
+ * 实现方式：
+ * - 每个缓冲区对应就绪位图中的一位
+ * - 生产者发布 head 后，仅在消费者已追上旧 head（由空变为非空）时置位
+ * - 消费者仅在缓冲区看似为空时清位，清位后再次确认，避免丢失唤醒
+ * - 优先级模式取最低位，轮询模式从上次位置之后取
+ */
+
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_RING_SET
+
+#if RING_BUFFER_SET_MAX_RINGS > 32
+#error "RING_BUFFER_SET_MAX_RINGS 不能超过 32"
+#endif
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief 确认位号 i 的缓冲区确有数据
+ *
+ * @return true=有数据（就绪位保持置位）, false=为空（就绪位已清除）
+ */
+static bool set_claim(ring_buffer_set_t *set, uint8_t i)
+{
+    ring_buffer_t *rb = set->rings[i];
+    uint32_t bit = 1U << i;
+
+    if (rb == NULL) {
+        __atomic_fetch_and(&set->ready, ~bit, __ATOMIC_SEQ_CST);
+        return false;
+    }
+
+    if (rb->head != rb->tail) {
+        return true;
+    }
+
+    /* 看似为空：先清位，再确认，与 rb_set_check() 配对 */
+    __atomic_fetch_and(&set->ready, ~bit, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (rb->head != rb->tail) {
+        __atomic_fetch_or(&set->ready, bit, __ATOMIC_SEQ_CST);
+        return true;
+    }
+
+    return false;
+}
+
+/* Exported functions (for strategies) ---------------------------------------*/
+
+void rb_set_notify(ring_buffer_t *rb)
+{
+    ring_buffer_set_t *set = rb->set;
+    uint32_t bit = 1U << rb->set_index;
+    uint32_t prev = __atomic_fetch_or(&set->ready, bit, __ATOMIC_SEQ_CST);
+
+    if (!(prev & bit) && set->signal != NULL) {
+        set->signal(set->arg);
+    }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+void ring_buffer_set_init(ring_buffer_set_t *set, ring_buffer_set_order_t order)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (set == NULL) {
+        return;
+    }
+#endif
+
+    memset(set, 0, sizeof(*set));
+    set->order = (uint8_t)order;
+}
+
+void ring_buffer_set_waiter(ring_buffer_set_t *set, void (*signal)(void *arg),
+                            bool (*wait)(void *arg, uint32_t timeout_ms), void *arg)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (set == NULL) {
+        return;
+    }
+#endif
+
+    set->arg = arg;
+    set->wait = wait;
+    set->signal = signal;
+}
+
+int ring_buffer_set_add(ring_buffer_set_t *set, ring_buffer_t *rb)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (set == NULL || rb == NULL || rb->set != NULL) {
+        return -1;
+    }
+#endif
+
+    uint8_t i = 0;
+    while (i < RING_BUFFER_SET_MAX_RINGS && set->rings[i] != NULL) {
+        i++;
+    }
+    if (i == RING_BUFFER_SET_MAX_RINGS) {
+        return -1;
+    }
+
+    set->rings[i] = rb;
+    if (i >= set->count) {
+        set->count = i + 1;
+    }
+
+    rb->set_index = i;
+    rb->set = set;
+
+    /* 加入前已有数据的缓冲区直接置位 */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (rb->head != rb->tail) {
+        rb_set_notify(rb);
+    }
+
+    return i;
+}
+
+void ring_buffer_set_remove(ring_buffer_set_t *set, ring_buffer_t *rb)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (set == NULL || rb == NULL || rb->set != set) {
+        return;
+    }
+#endif
+
+    uint8_t i = rb->set_index;
+
+    rb->set = NULL;
+    set->rings[i] = NULL;
+    __atomic_fetch_and(&set->ready, ~(1U << i), __ATOMIC_SEQ_CST);
+}
+
+ring_buffer_t *ring_buffer_set_next(ring_buffer_set_t *set)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (set == NULL) {
+        return NULL;
+    }
+#endif
+
+    uint32_t ready = __atomic_load_n(&set->ready, __ATOMIC_ACQUIRE);
+
+    while (ready != 0) {
+        uint32_t pick = ready;
+
+        if (set->order == RING_BUFFER_SET_ROUND_ROBIN) {
+            uint32_t upper = ready & ~((1U << set->rr_next) - 1U);
+            if (upper != 0) {
+                pick = upper;
+            }
+        }
+
+        uint8_t i = (uint8_t)__builtin_ctz(pick);
+        ready &= ~(1U << i);
+
+        if (set_claim(set, i)) {
+            set->rr_next = (i + 1 < set->count) ? i + 1 : 0;
+            return set->rings[i];
+        }
+    }
+
+    return NULL;
+}
+
+ring_buffer_t *ring_buffer_set_wait(ring_buffer_set_t *set, uint32_t timeout_ms)
+{
+    ring_buffer_t *rb;
+
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (set == NULL) {
+        return NULL;
+    }
+#endif
+
+    while ((rb = ring_buffer_set_next(set)) == NULL) {
+        if (set->wait == NULL || !set->wait(set->arg, timeout_ms)) {
+            return NULL;
+        }
+    }
+
+    return rb;
+}
+
+#endif /* RING_BUFFER_ENABLE_RING_SET */
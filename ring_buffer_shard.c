@@ -0,0 +1,185 @@
+/**
+ * @file    ring_buffer_shard.c
+ * @brief   分片缓冲区（多生产者单消费者）
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 每核 / 每线程一个生产者的事件收集器、日志汇聚
+ * - 共享一个 head 的多生产者缓冲区（加锁或原子操作）在核数增加时
+ *   吞吐不升反降
+ *
+ * 实现方式：
+ * - 每个生产者独占一个无锁 SPSC 分片，写入路径与无锁模式完全相同，
+ *   分片控制结构按缓存行对齐，生产者之间没有任何共享写
+ * - 记录用 writev 一次写入（帧头 + 负载），消费者总能读到整条记录
+ * - 消费者先读出各分片首条记录的帧头，按轮询或最小时间戳选择分片
+ *
+ * @warning 每个分片只能有一个生产者；消费者只能有一个
+ */
+
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_SHARD
+
+/* Private defines -----------------------------------------------------------*/
+
+#define SHARD_HDR  10   /**< 帧头：负载长度 u16 + 时间戳 u64 */
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @brief 读出分片首条记录的帧头（不消费）
+ *
+ * @return false = 分片为空
+ */
+static bool shard_peek(const ring_buffer_t *rb, uint16_t *len, uint64_t *ts)
+{
+    uint8_t hdr[SHARD_HDR];
+    rb_spans_t sp;
+
+    if (rb_read_spans(rb, SHARD_HDR, &sp) < SHARD_HDR) {
+        return false;   /* 记录整条发布，不足一个帧头即为空 */
+    }
+
+    rb_spans_copy_out(&sp, 0, hdr, SHARD_HDR);
+    memcpy(len, &hdr[0], sizeof(*len));
+    memcpy(ts, &hdr[2], sizeof(*ts));
+    return true;
+}
+
+/**
+ * @brief 按合并顺序选择分片
+ *
+ * @return 分片编号，所有分片为空时返回 -1
+ */
+static int shard_pick(const ring_buffer_sharded_t *sh, uint16_t *len, uint64_t *ts)
+{
+    int best = -1;
+
+    for (uint8_t n = 0; n < sh->count; n++) {
+        uint8_t i = (uint8_t)((sh->next + n) % sh->count);
+        uint16_t l;
+        uint64_t t;
+
+        if (!shard_peek(&sh->shard[i].rb, &l, &t)) {
+            continue;
+        }
+        if (best < 0 || t < *ts) {
+            best = i;
+            *len = l;
+            *ts = t;
+        }
+        if (sh->order == RING_BUFFER_SHARD_ROUND_ROBIN) {
+            break;
+        }
+    }
+    return best;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+bool ring_buffer_shard_init(ring_buffer_sharded_t *sh, uint8_t *storage, uint16_t shard_size,
+                            uint8_t count, ring_buffer_shard_order_t order)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (sh == NULL || storage == NULL || count == 0 || count > RING_BUFFER_SHARD_MAX ||
+        shard_size <= SHARD_HDR + 1) {
+        return false;
+    }
+#endif
+
+    memset(sh, 0, sizeof(*sh));
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (!ring_buffer_create(&sh->shard[i].rb, &storage[(uint32_t)i * shard_size],
+                                shard_size, RING_BUFFER_TYPE_LOCKFREE)) {
+            return false;
+        }
+    }
+
+    sh->count = count;
+    sh->order = order;
+    return true;
+}
+
+ring_buffer_t *ring_buffer_shard_claim(ring_buffer_sharded_t *sh)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (sh == NULL) {
+        return NULL;
+    }
+#endif
+
+    uint8_t i = __atomic_load_n(&sh->claimed, __ATOMIC_RELAXED);
+
+    do {
+        if (i >= sh->count) {
+            return NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&sh->claimed, &i, (uint8_t)(i + 1), true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return &sh->shard[i].rb;
+}
+
+bool ring_buffer_shard_write(ring_buffer_t *shard, uint64_t ts, const void *data, uint16_t len)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (shard == NULL || data == NULL || len == 0) {
+        return false;
+    }
+#endif
+
+    uint8_t hdr[SHARD_HDR];
+    ring_buffer_iovec_t iov[2] = {
+        { hdr, SHARD_HDR },
+        { (void *)data, len }
+    };
+
+    memcpy(&hdr[0], &len, sizeof(len));
+    memcpy(&hdr[2], &ts, sizeof(ts));
+
+    return ring_buffer_writev(shard, iov, 2) != 0;
+}
+
+uint16_t ring_buffer_shard_read(ring_buffer_sharded_t *sh, void *data, uint16_t len,
+                                int *src, uint64_t *ts)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (sh == NULL || data == NULL || len == 0) {
+        return 0;
+    }
+#endif
+
+    uint16_t rec_len = 0;
+    uint64_t rec_ts = 0;
+    int i = shard_pick(sh, &rec_len, &rec_ts);
+
+    if (i < 0) {
+        return 0;
+    }
+
+    ring_buffer_t *rb = &sh->shard[i].rb;
+    uint16_t n = (rec_len < len) ? rec_len : len;
+    rb_spans_t sp;
+
+    rb_read_spans(rb, SHARD_HDR + rec_len, &sp);
+    rb_spans_copy_out(&sp, SHARD_HDR, (uint8_t *)data, n);
+    rb_commit_read(rb, SHARD_HDR + rec_len);
+
+    sh->next = (uint8_t)((i + 1) % sh->count);
+
+    if (src != NULL) {
+        *src = i;
+    }
+    if (ts != NULL) {
+        *ts = rec_ts;
+    }
+
+    return n;
+}
+
+#endif /* RING_BUFFER_ENABLE_SHARD */
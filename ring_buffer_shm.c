@@ -0,0 +1,260 @@
+/**
+ * @file    ring_buffer_shm.c
+ * @brief   环形缓冲区共享内存进程间实现
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 采集进程 → 处理进程，单生产者单消费者
+ * - 需要绕过 socket / pipe 的内核拷贝
+ *
+ * 实现方式：
+ * - 头部只保存偏移与索引，各进程自行计算本地地址
+ * - head / tail 使用 acquire / release 原子访问，分处不同缓存行
+ * - 每侧缓存对端索引，空间/数据充足时不读取对端缓存行
+ *
+ * @warning 禁止多个生产者进程或多个消费者进程同时访问
+ */
+
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_SHM
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Private functions ---------------------------------------------------------*/
+
+static inline uint32_t shm_used(uint32_t head, uint32_t tail, uint32_t size)
+{
+    return (head >= tail) ? (head - tail) : (size - tail + head);
+}
+
+static bool shm_map(ring_buffer_shm_t *shm, int fd, size_t len)
+{
+    void *p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (p == MAP_FAILED) {
+        return false;
+    }
+
+    shm->hdr = (ring_buffer_shm_hdr_t *)p;
+    shm->map_len = len;
+    return true;
+}
+
+/**
+ * @brief 两段拷贝入数据区
+ */
+static void shm_copy_in(ring_buffer_shm_t *shm, uint32_t pos, const uint8_t *src, uint32_t len)
+{
+    uint32_t first = shm->size - pos;
+
+    if (len <= first) {
+        memcpy(&shm->data[pos], src, len);
+    } else {
+        memcpy(&shm->data[pos], src, first);
+        memcpy(shm->data, &src[first], len - first);
+    }
+}
+
+/**
+ * @brief 两段拷贝出数据区
+ */
+static void shm_copy_out(ring_buffer_shm_t *shm, uint32_t pos, uint8_t *dst, uint32_t len)
+{
+    uint32_t first = shm->size - pos;
+
+    if (len <= first) {
+        memcpy(dst, &shm->data[pos], len);
+    } else {
+        memcpy(dst, &shm->data[pos], first);
+        memcpy(&dst[first], shm->data, len - first);
+    }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+bool ring_buffer_shm_create(ring_buffer_shm_t *shm, int fd, uint32_t size)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (shm == NULL || fd < 0 || size < RING_BUFFER_MIN_SIZE) {
+        return false;
+    }
+#endif
+
+    size_t len = sizeof(ring_buffer_shm_hdr_t) + size;
+
+    if (ftruncate(fd, (off_t)len) != 0 || !shm_map(shm, fd, len)) {
+        return false;
+    }
+
+    ring_buffer_shm_hdr_t *hdr = shm->hdr;
+
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->version = RING_BUFFER_SHM_VERSION;
+    hdr->header_size = sizeof(ring_buffer_shm_hdr_t);
+    hdr->size = size;
+    hdr->data_offset = sizeof(ring_buffer_shm_hdr_t);
+
+    shm->data = (uint8_t *)hdr + hdr->data_offset;
+    shm->size = size;
+    shm->cached_head = 0;
+    shm->cached_tail = 0;
+
+    /* 最后发布 magic，attach 方看到它即可认为头部完整 */
+    __atomic_store_n(&hdr->magic, RING_BUFFER_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+bool ring_buffer_shm_attach(ring_buffer_shm_t *shm, int fd)
+{
+    struct stat st;
+
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (shm == NULL || fd < 0) {
+        return false;
+    }
+#endif
+
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ring_buffer_shm_hdr_t)) {
+        return false;
+    }
+
+    if (!shm_map(shm, fd, (size_t)st.st_size)) {
+        return false;
+    }
+
+    const ring_buffer_shm_hdr_t *hdr = shm->hdr;
+
+    /* 头部来自其他进程，所有字段都要校验后才能使用 */
+    if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != RING_BUFFER_SHM_MAGIC ||
+        hdr->version != RING_BUFFER_SHM_VERSION ||
+        hdr->header_size != sizeof(ring_buffer_shm_hdr_t) ||
+        hdr->data_offset < hdr->header_size ||
+        hdr->size < RING_BUFFER_MIN_SIZE ||
+        (uint64_t)hdr->data_offset + hdr->size > shm->map_len) {
+        ring_buffer_shm_detach(shm);
+        return false;
+    }
+
+    shm->data = (uint8_t *)shm->hdr + hdr->data_offset;
+    shm->size = hdr->size;
+    shm->cached_head = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+    shm->cached_tail = __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+
+    if (shm->cached_head >= shm->size || shm->cached_tail >= shm->size) {
+        ring_buffer_shm_detach(shm);
+        return false;
+    }
+
+    return true;
+}
+
+void ring_buffer_shm_detach(ring_buffer_shm_t *shm)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (shm == NULL || shm->hdr == NULL) {
+        return;
+    }
+#endif
+
+    munmap(shm->hdr, shm->map_len);
+    shm->hdr = NULL;
+    shm->data = NULL;
+    shm->map_len = 0;
+}
+
+uint32_t ring_buffer_shm_write(ring_buffer_shm_t *shm, const uint8_t *data, uint32_t len)
+{
+    ring_buffer_shm_hdr_t *hdr = shm->hdr;
+    uint32_t size = shm->size;
+    uint32_t head = __atomic_load_n(&hdr->head, __ATOMIC_RELAXED);
+
+    /* 自己的索引同样位于共享内存中，可能被其他进程写坏 */
+    if (head >= size) {
+        return 0;
+    }
+
+    uint32_t free = size - 1 - shm_used(head, shm->cached_tail, size);
+
+    /* 缓存的 tail 显示空间不足时才去读对端缓存行 */
+    if (free < len) {
+        uint32_t tail = __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+        if (tail >= size) {
+            return 0;   /* 对端索引损坏 */
+        }
+        shm->cached_tail = tail;
+        free = size - 1 - shm_used(head, tail, size);
+    }
+
+    uint32_t n = (len > free) ? free : len;
+    if (n == 0) {
+        return 0;
+    }
+
+    shm_copy_in(shm, head, data, n);
+    __atomic_store_n(&hdr->head, (uint32_t)(((uint64_t)head + n) % size), __ATOMIC_RELEASE);
+
+    return n;
+}
+
+uint32_t ring_buffer_shm_read(ring_buffer_shm_t *shm, uint8_t *data, uint32_t len)
+{
+    ring_buffer_shm_hdr_t *hdr = shm->hdr;
+    uint32_t size = shm->size;
+    uint32_t tail = __atomic_load_n(&hdr->tail, __ATOMIC_RELAXED);
+
+    if (tail >= size) {
+        return 0;   /* 自己的索引损坏 */
+    }
+
+    uint32_t avail = shm_used(shm->cached_head, tail, size);
+
+    if (avail < len) {
+        uint32_t head = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+        if (head >= size) {
+            return 0;   /* 对端索引损坏 */
+        }
+        shm->cached_head = head;
+        avail = shm_used(head, tail, size);
+    }
+
+    uint32_t n = (len > avail) ? avail : len;
+    if (n == 0) {
+        return 0;
+    }
+
+    shm_copy_out(shm, tail, data, n);
+    __atomic_store_n(&hdr->tail, (uint32_t)(((uint64_t)tail + n) % size), __ATOMIC_RELEASE);
+
+    return n;
+}
+
+uint32_t ring_buffer_shm_available(const ring_buffer_shm_t *shm)
+{
+    uint32_t head = __atomic_load_n(&shm->hdr->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = __atomic_load_n(&shm->hdr->tail, __ATOMIC_ACQUIRE);
+
+    if (head >= shm->size || tail >= shm->size) {
+        return 0;
+    }
+    return shm_used(head, tail, shm->size);
+}
+
+uint32_t ring_buffer_shm_free_space(const ring_buffer_shm_t *shm)
+{
+    uint32_t head = __atomic_load_n(&shm->hdr->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = __atomic_load_n(&shm->hdr->tail, __ATOMIC_ACQUIRE);
+
+    if (head >= shm->size || tail >= shm->size) {
+        return 0;
+    }
+    return shm->size - 1 - shm_used(head, tail, shm->size);
+}
+
+#endif /* RING_BUFFER_ENABLE_SHM */
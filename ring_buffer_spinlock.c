@@ -0,0 +1,37 @@
+/**
+ * @file    ring_buffer_spinlock.c
+ * @brief   环形缓冲区自旋锁实现
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 多核主机上的多生产者 / 多消费者（MPMC）
+ * - 双核 MCU（ESP32、RP2040、STM32H7 双核等）核间共享缓冲区
+ * - 临界区只有几十纳秒，互斥锁的休眠/唤醒开销远大于临界区本身
+ *
+ * 线程安全保证：
+ * - 锁字内嵌在缓冲区控制结构中（rb->spin），无需创建与释放
+ * - TTAS + 指数退避或票据锁，见 RING_BUFFER_SPINLOCK_TICKET
+ * - 可选持锁期间关闭本核中断（RING_BUFFER_SPINLOCK_IRQ）
+ *
+ * @warning
+ * - 持锁线程被抢占时其他线程只能空转，RTOS 单核系统请使用互斥锁模式
+ * - ISR 会访问同一缓冲区时必须启用 RING_BUFFER_SPINLOCK_IRQ
+ */
+
+#include "ring_buffer_decorator.h"
+
+#if RING_BUFFER_ENABLE_SPINLOCK
+
+/* Exported functions (Implementation) ---------------------------------------*/
+
+/* 每个操作：加自旋锁 → 直接调用无锁实现 → 解锁 */
+RING_BUFFER_DECORATE(spinlock, rb_lockfree, RB_LAYER_SPIN_ENTER, RB_LAYER_SPIN_EXIT)
+
+/* Exported constant ---------------------------------------------------------*/
+
+const struct ring_buffer_ops ring_buffer_spinlock_ops = RING_BUFFER_DECORATED_OPS(spinlock);
+
+#endif /* RING_BUFFER_ENABLE_SPINLOCK */
@@ -10,7 +10,13 @@
  * 
  * 编译方式（Linux/macOS）：
  * gcc -o test ring_buffer_test.c ring_buffer.c ring_buffer_lockfree.c \
- *     ring_buffer_disable_irq.c ring_buffer_mutex.c -I. -lpthread
+ *     ring_buffer_disable_irq.c ring_buffer_mutex.c \
+ *     ring_buffer_linux_storage.c ring_buffer_crc.c ring_buffer_fd.c \
+ *     ring_buffer_zerocopy.c ring_buffer_io_uring.c ring_buffer_shm.c \
+ *     ring_buffer_persist.c ring_buffer_set.c ring_buffer_group.c \
+ *     ring_buffer_segmented.c ring_buffer_lz.c ring_buffer_aes.c \
+ *     ring_buffer_trace.c ring_buffer_spinlock.c ring_buffer_combining.c \
+ *     ring_buffer_shard.c -I. -lpthread
  * 
  * 运行：
  * ./test
@@ -20,6 +26,34 @@
 #include <string.h>
 #include <assert.h>
 #include "ring_buffer.h"
+#include "ring_buffer_decorator.h"
+
+#if RING_BUFFER_ENABLE_FD_IO || RING_BUFFER_ENABLE_ZEROCOPY || RING_BUFFER_ENABLE_IO_URING || \
+    RING_BUFFER_ENABLE_SHM
+#include <unistd.h>
+#endif
+
+#if RING_BUFFER_ENABLE_SHM
+#include <sys/wait.h>
+#endif
+
+#if RING_BUFFER_ENABLE_TRACE || RING_BUFFER_ENABLE_SPINLOCK || RING_BUFFER_ENABLE_SNAPSHOT || \
+    RING_BUFFER_ENABLE_COMBINING || RING_BUFFER_ENABLE_SHARD || \
+    RING_BUFFER_ENABLE_SEGMENTED || RING_BUFFER_ENABLE_LZ || \
+    (RING_BUFFER_ENABLE_MUTEX && RING_BUFFER_MUTEX_COPY_OUTSIDE)
+#include <pthread.h>
+#endif
+
+#if RING_BUFFER_ENABLE_SEGMENTED || RING_BUFFER_ENABLE_LZ
+#include <sched.h>
+#endif
+
+#if RING_BUFFER_ENABLE_ZEROCOPY
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
 
 /* 测试用宏 */
 #define TEST_ASSERT(cond, msg) do { \
@@ -163,6 +197,157 @@ bool test_wrap_around(void)
     return true;
 }
 
+/**
+ * @brief 测试各长度批量拷贝（覆盖内联拷贝内核的所有分支）
+ */
+bool test_copy_lengths(void)
+{
+    /* 奇数大小，使各长度在不同位置环绕 */
+    ring_buffer_create(&test_rb, test_buffer, 131, RING_BUFFER_TYPE_LOCKFREE);
+    
+    uint8_t data[130];
+    uint8_t temp[130];
+    uint8_t seq = 0;
+    
+    for (uint16_t len = 1; len <= 130; len++) {
+        for (uint16_t i = 0; i < len; i++) {
+            data[i] = seq++;
+        }
+        memset(temp, 0, sizeof(temp));
+        
+        TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, len) == len, "Write count mismatch");
+        TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, len) == len, "Read count mismatch");
+        TEST_ASSERT(memcmp(data, temp, len) == 0, "Data mismatch");
+    }
+    
+    ring_buffer_destroy(&test_rb);
+    TEST_PASS("Copy Lengths");
+    return true;
+}
+
+#if RING_BUFFER_STREAM_THRESHOLD
+/**
+ * @brief 测试大块流式读写（阈值两侧的长度，环绕与不环绕，目的地址不对齐）
+ *
+ * 默认阈值为 0 不编译，用小阈值编译运行：-DRING_BUFFER_STREAM_THRESHOLD=64
+ */
+bool test_stream_copy(void)
+{
+    static uint8_t storage[1021];   /* 奇数大小，使各长度在不同位置环绕 */
+    static uint8_t data[600];
+    static uint8_t temp[600];
+    const uint16_t limit = sizeof(data);
+    uint16_t wrapped = 0;
+    uint16_t flat = 0;
+    uint8_t seq = 0;
+    
+    if (RING_BUFFER_STREAM_THRESHOLD + 200 > limit) {
+        printf("  (stream threshold %u too large, skipped)\n", (unsigned)RING_BUFFER_STREAM_THRESHOLD);
+        return true;
+    }
+    
+    ring_buffer_create(&test_rb, storage, sizeof(storage), RING_BUFFER_TYPE_LOCKFREE);
+    
+    for (uint16_t len = RING_BUFFER_STREAM_THRESHOLD - 1; len < RING_BUFFER_STREAM_THRESHOLD + 200; len += 3) {
+        for (uint16_t i = 0; i < len; i++) {
+            data[i] = seq++;
+        }
+        memset(temp, 0, sizeof(temp));
+        
+        if (test_rb.head + len > test_rb.size) {
+            wrapped++;
+        } else {
+            flat++;
+        }
+        
+        TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, len) == len, "Stream write count mismatch");
+        TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, len) == len, "Stream read count mismatch");
+        TEST_ASSERT(memcmp(data, temp, len) == 0, "Stream data mismatch");
+    }
+    TEST_ASSERT(wrapped > 0 && flat > 0, "Should cover wrapped and unwrapped copies");
+    
+    /* 流式写入、逐块读出；小块写入、流式读出 */
+    for (uint16_t i = 0; i < limit; i++) {
+        data[i] = (uint8_t)(i * 7 + 3);
+    }
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, limit) == limit, "Large write failed");
+    for (uint16_t off = 0; off < limit; off += 20) {
+        TEST_ASSERT(ring_buffer_read_multi(&test_rb, &temp[off], 20) == 20, "Small read failed");
+    }
+    TEST_ASSERT(memcmp(data, temp, limit) == 0, "Stream write / small read mismatch");
+    
+    for (uint16_t off = 0; off < limit; off += 20) {
+        TEST_ASSERT(ring_buffer_write_multi(&test_rb, &data[off], 20) == 20, "Small write failed");
+    }
+    memset(temp, 0, sizeof(temp));
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, &temp[1], limit - 1) == limit - 1, "Large read failed");
+    TEST_ASSERT(memcmp(data, &temp[1], limit - 1) == 0, "Small write / stream read mismatch");
+    ring_buffer_clear(&test_rb);
+    
+    /* 剩余空间不足时截断，截断后的长度达到阈值仍走流式路径 */
+    ring_buffer_write_multi(&test_rb, data, 500);
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, limit) == sizeof(storage) - 1 - 500,
+                "Truncated stream write mismatch");
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, 500) == 500, "Read failed");
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, limit) == sizeof(storage) - 1 - 500, "Read failed");
+    TEST_ASSERT(memcmp(data, temp, sizeof(storage) - 1 - 500) == 0, "Truncated stream data mismatch");
+    
+    ring_buffer_destroy(&test_rb);
+    TEST_PASS("Stream Copy");
+    return true;
+}
+#endif
+
+/**
+ * @brief 测试分散/聚集读写
+ */
+bool test_iovec_rw(void)
+{
+    ring_buffer_create(&test_rb, test_buffer, 16, RING_BUFFER_TYPE_LOCKFREE);
+    
+    uint8_t hdr[2] = {0x7E, 0x05};
+    uint8_t payload[5] = {1, 2, 3, 4, 5};
+    uint8_t trailer[1] = {0xA5};
+    uint8_t temp[16];
+    
+    /* 先移动读写指针，使帧跨越环绕点 */
+    ring_buffer_write_multi(&test_rb, temp, 10);
+    ring_buffer_read_multi(&test_rb, temp, 10);
+    
+    ring_buffer_iovec_t wiov[3] = {
+        { hdr, sizeof(hdr) },
+        { payload, sizeof(payload) },
+        { trailer, sizeof(trailer) },
+    };
+    TEST_ASSERT(ring_buffer_writev(&test_rb, wiov, 3) == 8, "Writev count mismatch");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 8, "Available should be 8");
+    
+    /* 剩余 7 字节，整帧 8 字节应完全不写 */
+    TEST_ASSERT(ring_buffer_writev(&test_rb, wiov, 3) == 0, "Writev should be all-or-nothing");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 8, "Partial frame written");
+    
+    /* 帧头与其余部分分开读出 */
+    uint8_t rhdr[2];
+    uint8_t rbody[6];
+    ring_buffer_iovec_t riov[2] = {
+        { rhdr, sizeof(rhdr) },
+        { rbody, sizeof(rbody) },
+    };
+    TEST_ASSERT(ring_buffer_readv(&test_rb, riov, 2) == 8, "Readv count mismatch");
+    TEST_ASSERT(memcmp(rhdr, hdr, 2) == 0, "Header mismatch");
+    TEST_ASSERT(memcmp(rbody, payload, 5) == 0, "Payload mismatch");
+    TEST_ASSERT(rbody[5] == 0xA5, "Trailer mismatch");
+    
+    /* 数据不足时应完全不读 */
+    ring_buffer_write_multi(&test_rb, hdr, 2);
+    TEST_ASSERT(ring_buffer_readv(&test_rb, riov, 2) == 0, "Readv should be all-or-nothing");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 2, "Partial frame read");
+    
+    ring_buffer_destroy(&test_rb);
+    TEST_PASS("Scatter/Gather R/W");
+    return true;
+}
+
 /**
  * @brief 测试满状态
  */
@@ -229,14 +414,12 @@ static bool custom_write(ring_buffer_t *rb, uint8_t data)
     printf("  [Custom] Writing byte: 0x%02X\n", data);
     
     /* 调用无锁实现 */
-    extern const struct ring_buffer_ops ring_buffer_lockfree_ops;
-    return ring_buffer_lockfree_ops.write(rb, data);
+    return rb_lockfree_write(rb, data);
 }
 
 static bool custom_read(ring_buffer_t *rb, uint8_t *data)
 {
-    extern const struct ring_buffer_ops ring_buffer_lockfree_ops;
-    bool ret = ring_buffer_lockfree_ops.read(rb, data);
+    bool ret = rb_lockfree_read(rb, data);
     
     if (ret) {
         printf("  [Custom] Read byte: 0x%02X\n", *data);
@@ -246,18 +429,16 @@ static bool custom_read(ring_buffer_t *rb, uint8_t *data)
 }
 
 /* 复用其他函数 */
-extern const struct ring_buffer_ops ring_buffer_lockfree_ops;
-
 static const struct ring_buffer_ops custom_ops = {
     .write       = custom_write,
     .read        = custom_read,
-    .write_multi = ring_buffer_lockfree_ops.write_multi,
-    .read_multi  = ring_buffer_lockfree_ops.read_multi,
-    .available   = ring_buffer_lockfree_ops.available,
-    .free_space  = ring_buffer_lockfree_ops.free_space,
-    .is_empty    = ring_buffer_lockfree_ops.is_empty,
-    .is_full     = ring_buffer_lockfree_ops.is_full,
-    .clear       = ring_buffer_lockfree_ops.clear,
+    .write_multi = rb_lockfree_write_multi,
+    .read_multi  = rb_lockfree_read_multi,
+    .available   = rb_lockfree_available,
+    .free_space  = rb_lockfree_free_space,
+    .is_empty    = rb_lockfree_is_empty,
+    .is_full     = rb_lockfree_is_full,
+    .clear       = rb_lockfree_clear,
 };
 
 /**
@@ -270,6 +451,18 @@ bool test_custom_strategy(void)
     bool ret = ring_buffer_register_ops(custom_type, &custom_ops);
     TEST_ASSERT(ret == true, "Register custom ops failed");
     
+    /* 重复注册与超出范围的类型应失败 */
+    ret = ring_buffer_register_ops(custom_type, &custom_ops);
+    TEST_ASSERT(ret == false, "Duplicate register should fail");
+    ret = ring_buffer_register_ops(RING_BUFFER_TYPE_CUSTOM_BASE + RING_BUFFER_MAX_CUSTOM_OPS,
+                                   &custom_ops);
+    TEST_ASSERT(ret == false, "Out of range register should fail");
+    
+    /* 类型号固定：内置策略不占用自定义区间 */
+    TEST_ASSERT(RING_BUFFER_TYPE_CUSTOM_BASE == 3, "Custom base must keep its value");
+    ret = ring_buffer_register_ops(RING_BUFFER_TYPE_SPINLOCK, &custom_ops);
+    TEST_ASSERT(ret == false, "Built-in type must not be registrable");
+    
     /* 使用自定义策略创建缓冲区 */
     ret = ring_buffer_create(&test_rb, test_buffer, 16, custom_type);
     TEST_ASSERT(ret == true, "Create with custom type failed");
@@ -285,10 +478,1639 @@ bool test_custom_strategy(void)
     ring_buffer_read(&test_rb, &data);
     
     ring_buffer_destroy(&test_rb);
+    
+    /* 注销后不可再创建，槽位可重新注册 */
+    ret = ring_buffer_unregister_ops(custom_type);
+    TEST_ASSERT(ret == true, "Unregister custom ops failed");
+    ret = ring_buffer_unregister_ops(custom_type);
+    TEST_ASSERT(ret == false, "Double unregister should fail");
+    ret = ring_buffer_create(&test_rb, test_buffer, 16, custom_type);
+    TEST_ASSERT(ret == false, "Create after unregister should fail");
+    ret = ring_buffer_register_ops(custom_type, &custom_ops);
+    TEST_ASSERT(ret == true, "Re-register custom ops failed");
+    ring_buffer_unregister_ops(custom_type);
+    
     TEST_PASS("Custom Strategy");
     return true;
 }
 
+/**
+ * @brief 装饰器示例：内层记录调用次数，外层记录进出顺序
+ */
+static uint32_t deco_calls[RING_BUFFER_OP_COUNT];
+static uint16_t deco_last_ret;
+static int deco_depth;
+static int deco_max_depth;
+
+#define DECO_COUNT_ENTER(rb, op)        deco_calls[op]++; \
+                                        if (++deco_depth > deco_max_depth) deco_max_depth = deco_depth
+#define DECO_COUNT_EXIT(rb, op, ret)    deco_depth--
+#define DECO_OUTER_ENTER(rb, op)        deco_depth++
+#define DECO_OUTER_EXIT(rb, op, ret)    deco_depth--; deco_last_ret = (uint16_t)(ret)
+
+RING_BUFFER_DECORATE(deco_inner, rb_lockfree, DECO_COUNT_ENTER, DECO_COUNT_EXIT)
+RING_BUFFER_DECORATE(deco_outer, deco_inner, DECO_OUTER_ENTER, DECO_OUTER_EXIT)
+
+static const struct ring_buffer_ops deco_ops = RING_BUFFER_DECORATED_OPS(deco_outer);
+
+/**
+ * @brief 测试装饰器叠加
+ */
+bool test_decorator(void)
+{
+    ring_buffer_type_t type = RING_BUFFER_TYPE_CUSTOM_BASE + 1;
+    uint8_t out[8];
+    
+    memset(deco_calls, 0, sizeof(deco_calls));
+    deco_depth = 0;
+    deco_max_depth = 0;
+    
+    TEST_ASSERT(ring_buffer_register_ops(type, &deco_ops), "Register decorated ops failed");
+    TEST_ASSERT(ring_buffer_create(&test_rb, test_buffer, 16, type), "Create failed");
+    
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, (const uint8_t *)"layered", 7) == 7,
+                "Write through layers failed");
+    TEST_ASSERT(deco_last_ret == 7, "Outer layer should see core return value");
+    TEST_ASSERT(ring_buffer_write(&test_rb, '!'), "Single write failed");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 8, "Available mismatch");
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, out, sizeof(out)) == 8, "Read failed");
+    TEST_ASSERT(memcmp(out, "layered!", 8) == 0, "Data mismatch");
+    TEST_ASSERT(ring_buffer_is_empty(&test_rb), "Should be empty");
+    ring_buffer_clear(&test_rb);
+    
+    TEST_ASSERT(deco_calls[RING_BUFFER_OP_WRITE_MULTI] == 1, "write_multi count mismatch");
+    TEST_ASSERT(deco_calls[RING_BUFFER_OP_WRITE] == 1, "write count mismatch");
+    TEST_ASSERT(deco_calls[RING_BUFFER_OP_AVAILABLE] == 1, "available count mismatch");
+    TEST_ASSERT(deco_calls[RING_BUFFER_OP_READ_MULTI] == 1, "read_multi count mismatch");
+    TEST_ASSERT(deco_calls[RING_BUFFER_OP_IS_EMPTY] == 1, "is_empty count mismatch");
+    TEST_ASSERT(deco_calls[RING_BUFFER_OP_CLEAR] == 1, "clear count mismatch");
+    TEST_ASSERT(deco_depth == 0 && deco_max_depth == 2, "Layer nesting mismatch");
+    
+    ring_buffer_destroy(&test_rb);
+    ring_buffer_unregister_ops(type);
+    
+    TEST_PASS("Decorator");
+    return true;
+}
+
+#if RING_BUFFER_ENABLE_SPINLOCK
+#define SPIN_THREADS   4
+#define SPIN_PER_THREAD 20000
+
+static ring_buffer_t spin_rb;
+static uint32_t spin_seen[SPIN_THREADS][SPIN_THREADS];
+
+/**
+ * @brief 每个线程写入自己的编号，同时读出任意线程写入的字节并计数
+ */
+static void *spin_worker(void *arg)
+{
+    uint8_t id = (uint8_t)(uintptr_t)arg;
+    uint8_t out[8];
+    uint32_t sent = 0;
+
+    while (sent < SPIN_PER_THREAD) {
+        if (ring_buffer_write(&spin_rb, id)) {
+            sent++;
+        }
+        uint16_t n = ring_buffer_read_multi(&spin_rb, out, sizeof(out));
+        for (uint16_t i = 0; i < n; i++) {
+            spin_seen[id][out[i]]++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 测试自旋锁策略（多生产者多消费者下不丢不重）
+ */
+bool test_spinlock(void)
+{
+    pthread_t th[SPIN_THREADS];
+    uint8_t out[8];
+
+    TEST_ASSERT(ring_buffer_create(&spin_rb, test_buffer, 64, RING_BUFFER_TYPE_SPINLOCK),
+                "Create spinlock ring failed");
+    TEST_ASSERT(ring_buffer_write_multi(&spin_rb, (const uint8_t *)"spin", 4) == 4,
+                "Write failed");
+    TEST_ASSERT(ring_buffer_read_multi(&spin_rb, out, sizeof(out)) == 4 &&
+                memcmp(out, "spin", 4) == 0, "Read failed");
+    TEST_ASSERT(spin_rb.spin.owner == spin_rb.spin.next || spin_rb.spin.owner == 0,
+                "Lock should be released");
+
+    memset(spin_seen, 0, sizeof(spin_seen));
+    for (uintptr_t i = 0; i < SPIN_THREADS; i++) {
+        pthread_create(&th[i], NULL, spin_worker, (void *)i);
+    }
+    for (int i = 0; i < SPIN_THREADS; i++) {
+        pthread_join(th[i], NULL);
+    }
+
+    /* 剩余数据由本线程读出 */
+    uint16_t n;
+    while ((n = ring_buffer_read_multi(&spin_rb, out, sizeof(out))) > 0) {
+        for (uint16_t i = 0; i < n; i++) {
+            spin_seen[0][out[i]]++;
+        }
+    }
+
+    for (int src = 0; src < SPIN_THREADS; src++) {
+        uint32_t total = 0;
+        for (int dst = 0; dst < SPIN_THREADS; dst++) {
+            total += spin_seen[dst][src];
+        }
+        TEST_ASSERT(total == SPIN_PER_THREAD, "Bytes lost or duplicated under contention");
+    }
+
+    ring_buffer_destroy(&spin_rb);
+
+    TEST_PASS("Spinlock Strategy");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_COMBINING
+#define FC_THREADS      4
+#define FC_PER_THREAD   20000
+
+static ring_buffer_t fc_rb;
+static ring_buffer_combining_t fc_ctx;
+static uint32_t fc_seen[FC_THREADS][FC_THREADS];
+
+/**
+ * @brief 每个线程写入自己的编号，同时读出任意线程写入的字节并计数
+ */
+static void *fc_worker(void *arg)
+{
+    uint8_t id = (uint8_t)(uintptr_t)arg;
+    uint8_t out[8];
+    uint32_t sent = 0;
+
+    while (sent < FC_PER_THREAD) {
+        if (ring_buffer_write(&fc_rb, id)) {
+            sent++;
+        }
+        uint16_t n = ring_buffer_read_multi(&fc_rb, out, sizeof(out));
+        for (uint16_t i = 0; i < n; i++) {
+            fc_seen[id][out[i]]++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 测试合并模式（单线程读写语义不变，多线程下不丢不重）
+ */
+bool test_combining(void)
+{
+    pthread_t th[FC_THREADS];
+    uint8_t out[8];
+    uint8_t fill[100] = {0};
+    uint8_t hdr[2] = {'f', 'c'};
+    ring_buffer_iovec_t iov[2] = { { hdr, 2 }, { "ring", 4 } };
+    uint32_t requests;
+
+    TEST_ASSERT(ring_buffer_combining_create(&fc_rb, &fc_ctx, test_buffer, 64),
+                "Create combining ring failed");
+    TEST_ASSERT(ring_buffer_writev(&fc_rb, iov, 2) == 6, "Writev failed");
+    TEST_ASSERT(ring_buffer_available(&fc_rb) == 6, "Available mismatch");
+    TEST_ASSERT(ring_buffer_read(&fc_rb, &out[0]) && out[0] == 'f', "Read failed");
+    TEST_ASSERT(ring_buffer_read_multi(&fc_rb, out, sizeof(out)) == 5 &&
+                memcmp(out, "cring", 5) == 0, "Read multi failed");
+    TEST_ASSERT(ring_buffer_write_multi(&fc_rb, fill, sizeof(fill)) == 63, "Partial write failed");
+    TEST_ASSERT(ring_buffer_is_full(&fc_rb), "Should be full");
+    ring_buffer_clear(&fc_rb);
+    TEST_ASSERT(ring_buffer_is_empty(&fc_rb), "Should be empty after clear");
+    TEST_ASSERT(fc_ctx.lock == 0 && fc_ctx.combined == fc_ctx.batches,
+                "Single thread should combine one request per batch");
+
+    memset(fc_seen, 0, sizeof(fc_seen));
+    requests = fc_ctx.combined;
+    for (uintptr_t i = 0; i < FC_THREADS; i++) {
+        pthread_create(&th[i], NULL, fc_worker, (void *)i);
+    }
+    for (int i = 0; i < FC_THREADS; i++) {
+        pthread_join(th[i], NULL);
+    }
+
+    /* 剩余数据由本线程读出 */
+    uint16_t n;
+    while ((n = ring_buffer_read_multi(&fc_rb, out, sizeof(out))) > 0) {
+        for (uint16_t i = 0; i < n; i++) {
+            fc_seen[0][out[i]]++;
+        }
+    }
+
+    for (int src = 0; src < FC_THREADS; src++) {
+        uint32_t total = 0;
+        for (int dst = 0; dst < FC_THREADS; dst++) {
+            total += fc_seen[dst][src];
+        }
+        TEST_ASSERT(total == FC_PER_THREAD, "Bytes lost or duplicated under contention");
+    }
+    TEST_ASSERT(fc_ctx.combined - requests >= FC_THREADS * FC_PER_THREAD * 2,
+                "Every request should pass through a combiner");
+    for (int i = 0; i < RING_BUFFER_COMBINING_SLOTS; i++) {
+        TEST_ASSERT(fc_ctx.slot[i].state == 0, "All slots should be released");
+    }
+
+    ring_buffer_destroy(&fc_rb);
+
+    TEST_PASS("Combining Strategy");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_MUTEX && RING_BUFFER_MUTEX_COPY_OUTSIDE
+#define RSV_PRODUCERS   4
+#define RSV_RECORDS     200
+#define RSV_RECORD_LEN  300     /* 大于 RING_BUFFER_MUTEX_COPY_OUTSIDE，走锁外拷贝 */
+
+static uint8_t rsv_buffer[2048];
+static ring_buffer_t rsv_rb;
+
+/**
+ * @brief 每条记录：[生产者编号][序号 4 字节][以 编号^序号 填充的负载]
+ */
+static void *rsv_producer(void *arg)
+{
+    uint8_t id = (uint8_t)(uintptr_t)arg;
+    uint8_t payload[RSV_RECORD_LEN - 5];
+    ring_buffer_iovec_t iov[3] = {
+        { &id, 1 }, { NULL, 4 }, { payload, sizeof(payload) }
+    };
+
+    for (uint32_t seq = 0; seq < RSV_RECORDS; ) {
+        iov[1].base = &seq;
+        memset(payload, (uint8_t)(id ^ seq), sizeof(payload));
+        if (ring_buffer_writev(&rsv_rb, iov, 3) == RSV_RECORD_LEN) {
+            seq++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 测试互斥锁策略的锁外拷贝（多生产者下记录完整且按各自顺序到达）
+ */
+bool test_mutex_reserve(void)
+{
+    pthread_t th[RSV_PRODUCERS];
+    uint32_t next[RSV_PRODUCERS] = {0};
+    uint8_t rec[RSV_RECORD_LEN];
+    uint32_t got = 0;
+
+    TEST_ASSERT(ring_buffer_create(&rsv_rb, rsv_buffer, sizeof(rsv_buffer), RING_BUFFER_TYPE_MUTEX),
+                "Create mutex ring failed");
+
+    for (uintptr_t i = 0; i < RSV_PRODUCERS; i++) {
+        pthread_create(&th[i], NULL, rsv_producer, (void *)i);
+    }
+
+    while (got < RSV_PRODUCERS * RSV_RECORDS) {
+        uint16_t n = 0;
+        uint32_t seq;
+
+        /* 读满一条记录 */
+        while (n < RSV_RECORD_LEN) {
+            n += ring_buffer_read_multi(&rsv_rb, &rec[n], RSV_RECORD_LEN - n);
+        }
+        memcpy(&seq, &rec[1], sizeof(seq));
+        TEST_ASSERT(rec[0] < RSV_PRODUCERS, "Record header corrupted");
+        TEST_ASSERT(seq == next[rec[0]], "Records out of order");
+        for (uint16_t i = 5; i < RSV_RECORD_LEN; i++) {
+            TEST_ASSERT(rec[i] == (uint8_t)(rec[0] ^ seq), "Record payload torn");
+        }
+        next[rec[0]]++;
+        got++;
+    }
+
+    for (int i = 0; i < RSV_PRODUCERS; i++) {
+        pthread_join(th[i], NULL);
+    }
+
+    TEST_ASSERT(ring_buffer_is_empty(&rsv_rb), "Ring should be drained");
+    TEST_ASSERT(rsv_rb.rsv.count == 0 && rsv_rb.rsv.head == rsv_rb.head,
+                "Reservations should all be committed");
+
+    ring_buffer_destroy(&rsv_rb);
+
+    TEST_PASS("Mutex Copy-Outside Reservation");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_RESIZE
+#if RING_BUFFER_ENABLE_STATISTICS
+static uint8_t resize_pool[2][64];
+static int resize_released;
+
+static uint8_t *test_resize_alloc(uint16_t size, void *arg)
+{
+    (void)arg;
+    return (size <= 32) ? resize_pool[0] : resize_pool[1];
+}
+
+static void test_resize_release(uint8_t *buffer, uint16_t size, void *arg)
+{
+    (void)buffer;
+    (void)size;
+    (void)arg;
+    resize_released++;
+}
+#endif
+
+/**
+ * @brief 测试在线扩缩容（数据跨越环绕点）
+ */
+bool test_resize(void)
+{
+    static uint8_t small[16];
+    static uint8_t large[40];
+    static uint8_t tiny[8];
+    uint8_t data[30];
+    uint8_t temp[30];
+    uint8_t *old = NULL;
+    
+    for (int i = 0; i < 30; i++) {
+        data[i] = (uint8_t)(0x30 + i);
+    }
+    
+    ring_buffer_create(&test_rb, small, sizeof(small), RING_BUFFER_TYPE_LOCKFREE);
+    ring_buffer_write_multi(&test_rb, data, 12);
+    ring_buffer_read_multi(&test_rb, temp, 12);
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, 10) == 10, "Write failed");
+    
+    /* 缩得太小：数据放不下 */
+    TEST_ASSERT(!ring_buffer_resize(&test_rb, tiny, sizeof(tiny), &old), "Shrink should fail");
+    
+    /* 扩容：环绕数据被拼接到新存储块起始处 */
+    TEST_ASSERT(ring_buffer_resize(&test_rb, large, sizeof(large), &old), "Grow failed");
+    TEST_ASSERT(old == small, "Old buffer mismatch");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 10, "Available should be 10");
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, &data[10], 20) == 20, "Write after grow failed");
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, 30) == 30, "Read after grow failed");
+    TEST_ASSERT(memcmp(temp, data, 30) == 0, "Data mismatch after grow");
+    
+#if RING_BUFFER_ENABLE_STATISTICS
+    /* 自动扩容：溢出后翻倍 */
+    ring_buffer_resize_policy_t policy = {
+        .min_size = 16, .max_size = 64, .grow_overflows = 1, .shrink_checks = 2,
+        .alloc = test_resize_alloc, .release = test_resize_release,
+    };
+    ring_buffer_create(&test_rb, small, sizeof(small), RING_BUFFER_TYPE_LOCKFREE);
+    ring_buffer_write_multi(&test_rb, data, 20);
+    TEST_ASSERT(ring_buffer_auto_resize(&test_rb, &policy), "Auto grow failed");
+    TEST_ASSERT(test_rb.size == 32 && resize_released == 1, "Should grow to 32");
+    TEST_ASSERT(!ring_buffer_auto_resize(&test_rb, &policy), "No change expected");
+    
+    /* 持续空闲：减半 */
+    ring_buffer_clear(&test_rb);
+    policy.last_overflow = 0;
+    TEST_ASSERT(!ring_buffer_auto_resize(&test_rb, &policy), "First idle check only counts");
+    TEST_ASSERT(ring_buffer_auto_resize(&test_rb, &policy), "Auto shrink failed");
+    TEST_ASSERT(test_rb.size == 16, "Should shrink to 16");
+#endif
+    
+    ring_buffer_destroy(&test_rb);
+    
+    TEST_PASS("Resize");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_SEGMENTED || RING_BUFFER_ENABLE_LZ
+#define SPSC_BYTES  200000
+
+static void *spsc_producer(void *arg)
+{
+    ring_buffer_t *rb = (ring_buffer_t *)arg;
+    uint8_t chunk[97];
+    uint32_t sent = 0;
+    uint16_t len = 1;
+
+    while (sent < SPSC_BYTES) {
+        uint16_t n = (SPSC_BYTES - sent < len) ? (uint16_t)(SPSC_BYTES - sent) : len;
+
+        for (uint16_t i = 0; i < n; i++) {
+            chunk[i] = (uint8_t)(sent + i);
+        }
+        uint16_t w = ring_buffer_write_multi(rb, chunk, n);
+        sent += w;
+        if (w < n) {
+            sched_yield();
+        }
+        len = (uint16_t)(len % sizeof(chunk) + 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief 生产者线程写入序列，消费者按 available() 的结果分散读出
+ *
+ * available() 不得超过尚未读出的字节数，按它读出的 readv 必须整段读满
+ */
+static bool spsc_check(ring_buffer_t *rb)
+{
+    static uint8_t temp[0x10000];
+    pthread_t th;
+    uint32_t got = 0;
+    bool ok = true;
+
+    pthread_create(&th, NULL, spsc_producer, rb);
+
+    while (got < SPSC_BYTES && ok) {
+        uint16_t n = ring_buffer_available(rb);
+
+        if (n == 0) {
+            sched_yield();
+            continue;
+        }
+        if (n > SPSC_BYTES - got) {
+            ok = false;
+            break;
+        }
+
+        ring_buffer_iovec_t iov[2] = { { temp, n / 2 }, { &temp[n / 2], n - n / 2 } };
+        if (ring_buffer_readv(rb, iov, 2) != n) {
+            ok = false;
+            break;
+        }
+        for (uint16_t i = 0; i < n; i++) {
+            ok &= (temp[i] == (uint8_t)(got + i));
+        }
+        got += n;
+    }
+
+    pthread_join(th, NULL);
+    return ok;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_SEGMENTED
+/**
+ * @brief 测试分段缓冲区（跨块读写、块回收、上限、并发读写）
+ */
+bool test_segmented(void)
+{
+    static ring_buffer_seg_chunk_t chunks[4];
+    static uint8_t data[4 * RING_BUFFER_SEG_CHUNK_SIZE];
+    static uint8_t temp[4 * RING_BUFFER_SEG_CHUNK_SIZE];
+    const uint16_t chunk = RING_BUFFER_SEG_CHUNK_SIZE;
+    ring_buffer_seg_pool_t pool;
+    ring_buffer_seg_t seg;
+    
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 13 + 1);
+    }
+    
+    ring_buffer_seg_pool_init(&pool, chunks, 4);
+    TEST_ASSERT(ring_buffer_seg_create(&test_rb, &seg, &pool, 3), "Seg create failed");
+    TEST_ASSERT(pool.free_count == 3, "One chunk should be in use");
+    TEST_ASSERT(ring_buffer_free_space(&test_rb) == 3 * chunk, "Free space limited by max_chunks");
+    
+    /* 跨越两个块边界写入，受上限约束只能写 3 块 */
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, 4 * chunk) == 3 * chunk, "Write limited by max_chunks");
+    TEST_ASSERT(ring_buffer_is_full(&test_rb), "Should be full");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 3 * chunk, "Available mismatch");
+    
+    /* 读空第一块后归还块池 */
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, chunk + 10) == chunk + 10, "Read failed");
+    TEST_ASSERT(memcmp(temp, data, chunk + 10) == 0, "Data mismatch");
+    TEST_ASSERT(pool.free_count == 2, "Drained chunk should be recycled");
+    
+    /* 分散写入：刚好占满回收出的一块；空间不足时完全不写 */
+    ring_buffer_iovec_t iov[2] = {
+        { (void *)&data[3 * chunk], chunk - 10 },
+        { (void *)&data[4 * chunk - 10], 10 },
+    };
+    TEST_ASSERT(ring_buffer_writev(&test_rb, iov, 2) == chunk, "Writev failed");
+    TEST_ASSERT(ring_buffer_writev(&test_rb, iov, 2) == 0, "Writev should be all or nothing");
+    
+    uint16_t n = ring_buffer_read_multi(&test_rb, temp, sizeof(temp));
+    TEST_ASSERT(n == 3 * chunk - 10, "Read rest failed");
+    TEST_ASSERT(memcmp(temp, &data[chunk + 10], 2 * chunk - 10) == 0, "Data mismatch after recycle");
+    TEST_ASSERT(memcmp(&temp[2 * chunk - 10], &data[3 * chunk], chunk) == 0, "Writev data mismatch");
+    TEST_ASSERT(ring_buffer_is_empty(&test_rb), "Should be empty");
+    
+    ring_buffer_seg_destroy(&test_rb);
+    TEST_ASSERT(pool.free_count == 4, "All chunks should be returned");
+    
+    /* 分散写入中途失败：预留的块全部归还，生产者当前块不会被消费者回收 */
+    ring_buffer_seg_pool_init(&pool, chunks, 3);
+    TEST_ASSERT(ring_buffer_seg_create(&test_rb, &seg, &pool, 0), "Seg create failed");
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, chunk) == chunk, "Fill first chunk failed");
+    
+    ring_buffer_iovec_t big[1] = { { (void *)data, 4 * chunk } };
+    TEST_ASSERT(ring_buffer_writev(&test_rb, big, 1) == 0, "Oversized writev should fail");
+    TEST_ASSERT(pool.free_count == 2, "Reserved chunks should be returned on failure");
+    
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, chunk) == chunk, "Read first chunk failed");
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, 1) == 0, "Should be empty");
+    for (ring_buffer_seg_chunk_t *c = pool.free_list; c != NULL; c = c->next) {
+        TEST_ASSERT(c != seg.wr_chunk, "Producer chunk must not be recycled");
+    }
+    
+    /* 跨块分散写入整条发布，之后仍可正常读写 */
+    TEST_ASSERT(ring_buffer_writev(&test_rb, iov, 2) == chunk, "Writev after failure failed");
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, 10) == 10, "Write after failure failed");
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, sizeof(temp)) == chunk + 10, "Read after failure failed");
+    TEST_ASSERT(memcmp(temp, &data[3 * chunk], chunk - 10) == 0, "Writev data mismatch after failure");
+    TEST_ASSERT(memcmp(&temp[chunk], data, 10) == 0, "Write data mismatch after failure");
+    
+    ring_buffer_seg_destroy(&test_rb);
+    TEST_ASSERT(pool.free_count == 3, "All chunks should be returned");
+    
+    /* 并发读写：可读量不超过已写入未读出的数据 */
+    ring_buffer_seg_pool_init(&pool, chunks, 4);
+    TEST_ASSERT(ring_buffer_seg_create(&test_rb, &seg, &pool, 0), "Seg create failed");
+    TEST_ASSERT(spsc_check(&test_rb), "Concurrent available/readv mismatch");
+    ring_buffer_seg_destroy(&test_rb);
+    
+    TEST_PASS("Segmented Ring");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_LZ
+/**
+ * @brief 测试压缩缓冲区（压缩后容量、跨环绕帧、分次读出、不可压缩数据、并发读写）
+ */
+bool test_lz(void)
+{
+    static ring_buffer_lz_t lz;
+    static uint8_t storage[200];
+    static uint8_t data[1024];
+    static uint8_t temp[1024];
+    uint16_t n;
+    
+    /* 重复度高的遥测文本 */
+    for (unsigned i = 0; i < sizeof(data); i += 16) {
+        memcpy(&data[i], "temp=23.5 st=OK\n", 16);
+        data[i + 5] = (uint8_t)('0' + (i / 16) % 3);
+    }
+    
+    TEST_ASSERT(ring_buffer_lz_create(&test_rb, &lz, storage, sizeof(storage)), "LZ create failed");
+    
+    /* 写入的原始数据多于存储区大小 */
+    uint16_t total = ring_buffer_write_multi(&test_rb, data, sizeof(data));
+    TEST_ASSERT(total > sizeof(storage), "Compressed write should exceed storage size");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == total, "Available should count raw bytes");
+    TEST_ASSERT(lz.packed_in < sizeof(storage), "Data should be compressed");
+    
+    /* 小块读出，余下数据暂存在上下文中 */
+    uint16_t got = 0;
+    while ((n = ring_buffer_read_multi(&test_rb, &temp[got], 7)) > 0) {
+        got += n;
+    }
+    TEST_ASSERT(got == total && memcmp(temp, data, total) == 0, "Decompressed data mismatch");
+    TEST_ASSERT(ring_buffer_is_empty(&test_rb), "Should be empty");
+    
+    /* 反复写读，帧头与负载跨越环绕点 */
+    for (int round = 0; round < 40; round++) {
+        uint16_t off = (uint16_t)(round * 37 % 400);
+        uint16_t len = (uint16_t)(50 + round * 11 % 150);
+        TEST_ASSERT(ring_buffer_write_multi(&test_rb, &data[off], len) == len, "Wrap write failed");
+        TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, sizeof(temp)) == len, "Wrap read failed");
+        TEST_ASSERT(memcmp(temp, &data[off], len) == 0, "Wrap data mismatch");
+    }
+    
+    /* 分散写入拼块压缩，分散读出 */
+    ring_buffer_iovec_t wiov[2] = { { data, 100 }, { &data[100], 300 } };
+    ring_buffer_iovec_t riov[2] = { { temp, 150 }, { &temp[150], 250 } };
+    TEST_ASSERT(ring_buffer_writev(&test_rb, wiov, 2) == 400, "LZ writev failed");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 400, "LZ writev available mismatch");
+    TEST_ASSERT(ring_buffer_readv(&test_rb, riov, 2) == 400, "LZ readv failed");
+    TEST_ASSERT(memcmp(temp, data, 400) == 0, "LZ readv data mismatch");
+    TEST_ASSERT(ring_buffer_is_empty(&test_rb), "Should be empty after readv");
+    
+    /* 不可压缩数据原样存储，存储区不足时整帧不写 */
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)((i * 2654435761U) >> 13);
+    }
+    n = ring_buffer_write_multi(&test_rb, data, 400);
+    TEST_ASSERT(n < 400 && n > 0, "Raw frames should fill storage partially");
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, sizeof(temp)) == n, "Raw read failed");
+    TEST_ASSERT(memcmp(temp, data, n) == 0, "Raw data mismatch");
+    
+    /* 分散写入全部帧放不下时完全不写；可读数据不足时分散读出完全不读 */
+    TEST_ASSERT(ring_buffer_writev(&test_rb, wiov, 2) == 0, "LZ writev should be all or nothing");
+    TEST_ASSERT(ring_buffer_is_empty(&test_rb), "Failed writev must not commit frames");
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, 100) == 100, "Raw write failed");
+    TEST_ASSERT(ring_buffer_readv(&test_rb, riov, 2) == 0, "LZ readv should be all or nothing");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 100, "Failed readv must not consume");
+    ring_buffer_destroy(&test_rb);
+    
+    /* 并发读写：可读量不超过已写入未读出的数据 */
+    TEST_ASSERT(ring_buffer_lz_create(&test_rb, &lz, storage, sizeof(storage)), "LZ create failed");
+    TEST_ASSERT(spsc_check(&test_rb), "Concurrent available/readv mismatch");
+    
+    ring_buffer_destroy(&test_rb);
+    TEST_PASS("LZ Compressed Ring");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_AES
+/**
+ * @brief 测试 AES-CTR 加密缓冲区（FIPS-197 / SP 800-38A 向量、环绕、单字节）
+ */
+bool test_aes(void)
+{
+    /* FIPS-197 附录 C：明文 00112233...ff，密钥 000102...；零明文 + IV=明文 即得密文 */
+    static const uint8_t fips_pt[16] = {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF,
+    };
+    static const uint8_t fips_ct[3][16] = {
+        { 0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+          0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A },   /* AES-128 */
+        { 0xDD, 0xA9, 0x7C, 0xA4, 0x86, 0x4C, 0xDF, 0xE0,
+          0x6E, 0xAF, 0x70, 0xA0, 0xEC, 0x0D, 0x71, 0x91 },   /* AES-192 */
+        { 0x8E, 0xA2, 0xB7, 0xCA, 0x51, 0x67, 0x45, 0xBF,
+          0xEA, 0xFC, 0x49, 0x90, 0x4B, 0x49, 0x60, 0x89 },   /* AES-256 */
+    };
+    /* SP 800-38A F.5.1 CTR-AES128.Encrypt，计数器低字节进位 */
+    static const uint8_t ctr_key[16] = {
+        0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+        0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C,
+    };
+    static const uint8_t ctr_iv[16] = {
+        0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7,
+        0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF,
+    };
+    static const uint8_t ctr_pt[64] = {
+        0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96, 0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A,
+        0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C, 0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51,
+        0x30, 0xC8, 0x1C, 0x46, 0xA3, 0x5C, 0xE4, 0x11, 0xE5, 0xFB, 0xC1, 0x19, 0x1A, 0x0A, 0x52, 0xEF,
+        0xF6, 0x9F, 0x24, 0x45, 0xDF, 0x4F, 0x9B, 0x17, 0xAD, 0x2B, 0x41, 0x7B, 0xE6, 0x6C, 0x37, 0x10,
+    };
+    static const uint8_t ctr_ct[64] = {
+        0x87, 0x4D, 0x61, 0x91, 0xB6, 0x20, 0xE3, 0x26, 0x1B, 0xEF, 0x68, 0x64, 0x99, 0x0D, 0xB6, 0xCE,
+        0x98, 0x06, 0xF6, 0x6B, 0x79, 0x70, 0xFD, 0xFF, 0x86, 0x17, 0x18, 0x7B, 0xB9, 0xFF, 0xFD, 0xFF,
+        0x5A, 0xE4, 0xDF, 0x3E, 0xDB, 0xD5, 0xD3, 0x5E, 0x5B, 0x4F, 0x09, 0x02, 0x0D, 0xB0, 0x3E, 0xAB,
+        0x1E, 0x03, 0x1D, 0xDA, 0x2F, 0xBE, 0x03, 0xD1, 0x79, 0x21, 0x70, 0xA0, 0xF3, 0x00, 0x9C, 0xEE,
+    };
+    static ring_buffer_aes_t aes;
+    uint8_t key[32];
+    uint8_t zero[16] = {0};
+    uint8_t storage[80];
+    uint8_t temp[128];
+    
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)i;
+    }
+    
+    for (int k = 0; k < 3; k++) {
+        TEST_ASSERT(ring_buffer_aes_create(&test_rb, &aes, storage, sizeof(storage),
+                                           key, (uint8_t)(16 + 8 * k), fips_pt), "AES create failed");
+        TEST_ASSERT(ring_buffer_write_multi(&test_rb, zero, 16) == 16, "AES write failed");
+        TEST_ASSERT(memcmp(storage, fips_ct[k], 16) == 0, "FIPS-197 vector mismatch");
+        TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, 16) == 16, "AES read failed");
+        TEST_ASSERT(memcmp(temp, zero, 16) == 0, "AES decrypt mismatch");
+        ring_buffer_aes_destroy(&test_rb);
+    }
+    TEST_ASSERT(!ring_buffer_aes_create(&test_rb, &aes, storage, sizeof(storage), key, 20, fips_pt),
+                "Bad key length should fail");
+    
+    /* 不对齐的分次写入与读出，存储区中应为标准 CTR 密文 */
+    TEST_ASSERT(ring_buffer_aes_create(&test_rb, &aes, storage, sizeof(storage),
+                                       ctr_key, 16, ctr_iv), "AES create failed");
+    uint16_t off = 0;
+    for (uint16_t step = 1; off < 64; step += 6) {
+        uint16_t n = (off + step > 64) ? (uint16_t)(64 - off) : step;
+        TEST_ASSERT(ring_buffer_write_multi(&test_rb, &ctr_pt[off], n) == n, "CTR write failed");
+        off += n;
+    }
+    TEST_ASSERT(memcmp(storage, ctr_ct, 64) == 0, "SP 800-38A CTR vector mismatch");
+    
+    for (off = 0; off < 64; off++) {
+        TEST_ASSERT(ring_buffer_read(&test_rb, &temp[off]), "CTR byte read failed");
+    }
+    TEST_ASSERT(memcmp(temp, ctr_pt, 64) == 0, "CTR decrypt mismatch");
+    
+    /* 环绕后继续往返，分散读写与清空保持流偏移同步 */
+    for (int round = 0; round < 50; round++) {
+        uint16_t len = (uint16_t)(1 + round * 7 % 70);
+        TEST_ASSERT(ring_buffer_write_multi(&test_rb, ctr_pt, len) == len, "Wrap write failed");
+        TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, sizeof(temp)) == len, "Wrap read failed");
+        TEST_ASSERT(memcmp(temp, ctr_pt, len) == 0, "Wrap data mismatch");
+    }
+    
+    ring_buffer_iovec_t iov[2] = {
+        { (void *)ctr_pt, 10 },
+        { (void *)&ctr_pt[10], 30 },
+    };
+    ring_buffer_write_multi(&test_rb, ctr_pt, 9);
+    ring_buffer_clear(&test_rb);
+    TEST_ASSERT(ring_buffer_writev(&test_rb, iov, 2) == 40, "AES writev failed");
+    iov[0].base = temp;
+    iov[1].base = &temp[10];
+    TEST_ASSERT(ring_buffer_readv(&test_rb, iov, 2) == 40, "AES readv failed");
+    TEST_ASSERT(memcmp(temp, ctr_pt, 40) == 0, "Scatter/gather data mismatch after clear");
+    
+    ring_buffer_aes_destroy(&test_rb);
+    TEST_ASSERT(aes.rounds == 0, "Key schedule should be wiped");
+    
+    TEST_PASS("AES-CTR Encrypted Ring");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_TRACE
+static uint8_t trace_out[sizeof(ring_buffer_trace_file_hdr_t) +
+                         (RING_BUFFER_TRACE_MAX_THREADS + 1) *
+                         (sizeof(ring_buffer_trace_block_hdr_t) +
+                          RING_BUFFER_TRACE_EVENTS * sizeof(ring_buffer_trace_event_t))];
+static size_t trace_out_len;
+
+static void trace_sink(const void *data, size_t len, void *arg)
+{
+    (void)arg;
+    if (trace_out_len + len <= sizeof(trace_out)) {
+        memcpy(&trace_out[trace_out_len], data, len);
+    }
+    trace_out_len += len;
+}
+
+static void *trace_worker(void *arg)
+{
+    static uint8_t storage[2][32];
+    ring_buffer_t rb;
+    uint8_t id = (uint8_t)(uintptr_t)arg;
+    uint8_t temp[8] = {0};
+    
+    ring_buffer_create(&rb, storage[id - 10], sizeof(storage[0]), RING_BUFFER_TYPE_LOCKFREE);
+    ring_buffer_trace_set_id(&rb, id);
+    ring_buffer_write_multi(&rb, temp, sizeof(temp));
+    ring_buffer_read_multi(&rb, temp, sizeof(temp));
+    ring_buffer_destroy(&rb);
+    ring_buffer_trace_thread_exit();
+    return NULL;
+}
+
+/**
+ * @brief 在导出数据中查找某线程块，返回事件起始地址
+ */
+/* 导出流中的结构体不保证对齐，逐个拷贝到对齐的副本中再访问（同 trace2json） */
+static ring_buffer_trace_event_t trace_ev[RING_BUFFER_TRACE_EVENTS];
+
+static ring_buffer_trace_file_hdr_t trace_hdr(void)
+{
+    ring_buffer_trace_file_hdr_t hdr;
+    
+    memcpy(&hdr, trace_out, sizeof(hdr));
+    return hdr;
+}
+
+static const ring_buffer_trace_event_t *trace_find_block(uint32_t thread, uint32_t *count,
+                                                         uint32_t *lost)
+{
+    ring_buffer_trace_file_hdr_t hdr = trace_hdr();
+    size_t off = sizeof(hdr);
+    
+    for (uint32_t i = 0; i < hdr.threads; i++) {
+        ring_buffer_trace_block_hdr_t blk;
+        
+        memcpy(&blk, &trace_out[off], sizeof(blk));
+        off += sizeof(blk);
+        if (blk.thread == thread) {
+            *count = blk.count;
+            *lost = blk.lost;
+            if (blk.count > RING_BUFFER_TRACE_EVENTS) {
+                return NULL;
+            }
+            memcpy(trace_ev, &trace_out[off], blk.count * sizeof(ring_buffer_trace_event_t));
+            return trace_ev;
+        }
+        off += blk.count * sizeof(ring_buffer_trace_event_t);
+    }
+    return NULL;
+}
+
+/**
+ * @brief 测试事件追踪
+ */
+bool test_trace(void)
+{
+    ring_buffer_t quiet_rb;
+    static uint8_t quiet_storage[16];
+    uint8_t temp[32];
+    uint32_t count, lost;
+    
+    memset(temp, 0x5A, sizeof(temp));
+    ring_buffer_create(&test_rb, test_buffer, 16, RING_BUFFER_TYPE_LOCKFREE);
+    ring_buffer_create(&quiet_rb, quiet_storage, sizeof(quiet_storage), RING_BUFFER_TYPE_LOCKFREE);
+    ring_buffer_trace_set_id(&test_rb, 3);
+    
+    /* 未开始记录时不产生事件 */
+    ring_buffer_write_multi(&test_rb, temp, 4);
+    ring_buffer_read_multi(&test_rb, temp, 4);
+    
+    ring_buffer_trace_reset();
+    ring_buffer_trace_start();
+    
+    ring_buffer_write_multi(&test_rb, temp, 10);        /* 完整写入 */
+    ring_buffer_write_multi(&test_rb, temp, 10);        /* 只写入 5 字节：溢出 */
+    TEST_ASSERT(!ring_buffer_write(&test_rb, 0x11), "Write to full ring should fail");
+    ring_buffer_read_multi(&test_rb, temp, 20);         /* 只读出 15 字节 */
+    TEST_ASSERT(!ring_buffer_read(&test_rb, temp), "Read from empty ring should fail");
+    ring_buffer_iovec_t iov[2] = { { temp, 10 }, { temp, 10 } };
+    TEST_ASSERT(ring_buffer_writev(&test_rb, iov, 2) == 0, "Oversized writev should fail");
+    ring_buffer_write_multi(&quiet_rb, temp, 4);        /* 未设置编号：不记录 */
+    
+    ring_buffer_trace_stop();
+    ring_buffer_write_multi(&test_rb, temp, 1);         /* 停止后不记录 */
+    
+    trace_out_len = 0;
+    TEST_ASSERT(ring_buffer_trace_dump(trace_sink, NULL) == 6, "Expected 6 events");
+    TEST_ASSERT(trace_out_len <= sizeof(trace_out), "Dump too large");
+    
+    ring_buffer_trace_file_hdr_t hdr = trace_hdr();
+    TEST_ASSERT(hdr.magic == RING_BUFFER_TRACE_MAGIC, "Bad magic");
+    TEST_ASSERT(hdr.event_size == sizeof(ring_buffer_trace_event_t), "Bad event size");
+    TEST_ASSERT(sizeof(ring_buffer_trace_event_t) == 16, "Event should be 16 bytes");
+    
+    const ring_buffer_trace_event_t *ev = trace_find_block(0, &count, &lost);
+    TEST_ASSERT(ev != NULL && count == 6 && lost == 0, "Main thread block mismatch");
+    
+    TEST_ASSERT(ev[0].ring_id == 3 && ev[0].op == RING_BUFFER_OP_WRITE_MULTI, "Event 0 mismatch");
+    TEST_ASSERT(ev[0].req == 10 && ev[0].len == 10 && ev[0].occupancy == 10, "Event 0 lengths");
+    TEST_ASSERT(ev[1].req == 10 && ev[1].len == 5 && ev[1].occupancy == 15, "Overflow not recorded");
+    TEST_ASSERT(ev[2].op == RING_BUFFER_OP_WRITE && ev[2].len == 0, "Single-byte overflow missing");
+    TEST_ASSERT(ev[3].op == RING_BUFFER_OP_READ_MULTI && ev[3].len == 15 &&
+                ev[3].occupancy == 0, "Read event mismatch");
+    TEST_ASSERT(ev[4].op == RING_BUFFER_OP_READ && ev[4].req == 1 && ev[4].len == 0,
+                "Single-byte underrun missing");
+    TEST_ASSERT(ev[5].op == RING_BUFFER_OP_WRITEV && ev[5].req == 20 && ev[5].len == 0,
+                "Writev overflow missing");
+    TEST_ASSERT(ev[0].ts <= ev[1].ts && ev[1].ts <= ev[3].ts, "Timestamps not monotonic");
+    
+    /* 写满后覆盖最旧的事件 */
+    ring_buffer_trace_reset();
+    ring_buffer_trace_start();
+    for (uint32_t i = 0; i < RING_BUFFER_TRACE_EVENTS + 3; i++) {
+        ring_buffer_write_multi(&test_rb, temp, 1);
+        ring_buffer_read_multi(&test_rb, temp, 1);
+    }
+    ring_buffer_trace_stop();
+    trace_out_len = 0;
+    ring_buffer_trace_dump(trace_sink, NULL);
+    ev = trace_find_block(0, &count, &lost);
+    TEST_ASSERT(ev != NULL && count == RING_BUFFER_TRACE_EVENTS, "Wrapped block should be full");
+    TEST_ASSERT(lost == RING_BUFFER_TRACE_EVENTS + 6, "Lost count mismatch");
+    TEST_ASSERT(ev[count - 1].op == RING_BUFFER_OP_READ_MULTI, "Newest event should be last");
+    
+    /* 每个线程写自己的追踪缓冲区，退出的线程归还缓冲区，后来的线程复用 */
+    pthread_t th[2];
+    
+    ring_buffer_trace_reset();
+    ring_buffer_trace_start();
+    pthread_create(&th[0], NULL, trace_worker, (void *)(uintptr_t)10);
+    pthread_join(th[0], NULL);
+    pthread_create(&th[1], NULL, trace_worker, (void *)(uintptr_t)11);
+    pthread_join(th[1], NULL);
+    for (uint32_t i = 0; i < RING_BUFFER_TRACE_MAX_THREADS + 2; i++) {
+        pthread_create(&th[0], NULL, trace_worker, (void *)(uintptr_t)10);
+        pthread_join(th[0], NULL);
+    }
+    ring_buffer_trace_stop();
+    
+    trace_out_len = 0;
+    TEST_ASSERT(ring_buffer_trace_dump(trace_sink, NULL) == 2 * (RING_BUFFER_TRACE_MAX_THREADS + 4),
+                "Expected 2 events per worker");
+    hdr = trace_hdr();
+    TEST_ASSERT(hdr.threads == 2, "Exited workers should recycle one buffer");
+    ev = trace_find_block(1, &count, &lost);
+    TEST_ASSERT(ev != NULL && count == 2 * (RING_BUFFER_TRACE_MAX_THREADS + 4), "Worker block mismatch");
+    TEST_ASSERT(ev[0].ring_id == 10 && ev[2].ring_id == 11 &&
+                ev[3].op == RING_BUFFER_OP_READ_MULTI, "Worker events out of order");
+    
+    ring_buffer_trace_reset();
+    ring_buffer_destroy(&quiet_rb);
+    ring_buffer_destroy(&test_rb);
+    
+    TEST_PASS("Event Trace");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_SNAPSHOT
+#define SNAP_BYTES  20000
+
+static ring_buffer_t snap_rb;
+
+static void *snap_producer(void *arg)
+{
+    uint8_t chunk[13];
+    uint32_t sent = 0;
+
+    (void)arg;
+    memset(chunk, 0xA5, sizeof(chunk));
+    while (sent < SNAP_BYTES) {
+        uint16_t len = (uint16_t)(1 + sent % sizeof(chunk));
+        sent += ring_buffer_write_multi(&snap_rb, chunk, len);
+    }
+    return NULL;
+}
+
+static void *snap_consumer(void *arg)
+{
+    uint8_t out[7];
+    uint32_t got = 0;
+
+    (void)arg;
+    while (got < SNAP_BYTES) {
+        got += ring_buffer_read_multi(&snap_rb, out, sizeof(out));
+    }
+    return NULL;
+}
+
+/**
+ * @brief 测试一致性快照（生产者、消费者运行时快照内各字段互相吻合）
+ */
+bool test_snapshot(void)
+{
+    ring_buffer_snapshot_t s;
+    pthread_t th[2];
+    uint32_t taken = 0;
+    
+    ring_buffer_create(&snap_rb, test_buffer, 64, RING_BUFFER_TYPE_LOCKFREE);
+    ring_buffer_write_multi(&snap_rb, (const uint8_t *)"snapshot", 8);
+    
+    TEST_ASSERT(ring_buffer_snapshot(&snap_rb, &s), "Idle snapshot should succeed");
+    TEST_ASSERT(s.size == 64 && s.head == 8 && s.tail == 0 && s.occupancy == 8,
+                "Idle snapshot mismatch");
+#if RING_BUFFER_ENABLE_STATISTICS
+    TEST_ASSERT(s.write_count == 8 && s.read_count == 0 && s.overflow_count == 0,
+                "Idle counters mismatch");
+#endif
+    ring_buffer_clear(&snap_rb);
+    
+    pthread_create(&th[0], NULL, snap_producer, NULL);
+    pthread_create(&th[1], NULL, snap_consumer, NULL);
+    
+#if RING_BUFFER_ENABLE_STATISTICS
+    uint32_t last_read = 0;
+    
+    while (last_read < SNAP_BYTES) {
+        if (!ring_buffer_snapshot(&snap_rb, &s)) {
+            continue;
+        }
+        taken++;
+        TEST_ASSERT(s.occupancy < s.size, "Occupancy out of range");
+        TEST_ASSERT(s.write_count - s.read_count == s.occupancy,
+                    "Counters disagree with indices (torn snapshot)");
+        TEST_ASSERT(s.read_count >= last_read, "Read counter went backwards");
+        last_read = s.read_count;
+    }
+#else
+    for (uint32_t i = 0; i < 10000; i++) {
+        if (ring_buffer_snapshot(&snap_rb, &s)) {
+            taken++;
+            TEST_ASSERT(s.occupancy < s.size &&
+                        s.occupancy == (uint16_t)((s.head + s.size - s.tail) % s.size),
+                        "Torn snapshot");
+        }
+    }
+#endif
+    
+    pthread_join(th[0], NULL);
+    pthread_join(th[1], NULL);
+    TEST_ASSERT(taken > 0, "No snapshot succeeded");
+    
+    ring_buffer_destroy(&snap_rb);
+    
+    TEST_PASS("Snapshot");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_RING_SET
+static int set_signal_count;
+
+static void test_set_signal(void *arg)
+{
+    (void)arg;
+    set_signal_count++;
+}
+
+static bool test_set_wait(void *arg, uint32_t timeout_ms)
+{
+    (void)arg;
+    (void)timeout_ms;
+    return false;   /* 立即超时 */
+}
+
+/**
+ * @brief 测试多缓冲区选择器（优先级 / 轮询 / 唤醒）
+ */
+bool test_ring_set(void)
+{
+    static uint8_t bufs[3][16];
+    ring_buffer_t rbs[3];
+    ring_buffer_set_t set;
+    uint8_t temp[16];
+    
+    ring_buffer_set_init(&set, RING_BUFFER_SET_PRIORITY);
+    ring_buffer_set_waiter(&set, test_set_signal, test_set_wait, NULL);
+    for (int i = 0; i < 3; i++) {
+        ring_buffer_create(&rbs[i], bufs[i], sizeof(bufs[i]), RING_BUFFER_TYPE_LOCKFREE);
+        TEST_ASSERT(ring_buffer_set_add(&set, &rbs[i]) == i, "Set index mismatch");
+    }
+    
+    TEST_ASSERT(ring_buffer_set_next(&set) == NULL, "Empty set should return NULL");
+    TEST_ASSERT(ring_buffer_set_wait(&set, 10) == NULL, "Wait should time out");
+    
+    /* 只有由空变为非空时才唤醒 */
+    set_signal_count = 0;
+    ring_buffer_write_multi(&rbs[2], (const uint8_t *)"ab", 2);
+    ring_buffer_write(&rbs[2], 'c');
+    ring_buffer_write(&rbs[0], 'x');
+    TEST_ASSERT(set_signal_count == 2, "Signal count should be 2");
+    TEST_ASSERT(set.ready == 0x5, "Ready bitmap should be 0b101");
+    
+    /* 优先级：先 0 后 2，只读一部分时仍会被再次取到 */
+    TEST_ASSERT(ring_buffer_set_next(&set) == &rbs[0], "Ring 0 first");
+    ring_buffer_read_multi(&rbs[0], temp, sizeof(temp));
+    TEST_ASSERT(ring_buffer_set_wait(&set, 10) == &rbs[2], "Ring 2 next");
+    ring_buffer_read_multi(&rbs[2], temp, 1);
+    TEST_ASSERT(ring_buffer_set_next(&set) == &rbs[2], "Ring 2 still ready");
+    ring_buffer_read_multi(&rbs[2], temp, sizeof(temp));
+    TEST_ASSERT(ring_buffer_set_next(&set) == NULL, "All drained");
+    TEST_ASSERT(set.ready == 0, "Ready bitmap should be clear");
+    
+    /* 轮询：三个缓冲区都有数据时依次取出 */
+    set.order = RING_BUFFER_SET_ROUND_ROBIN;
+    for (int i = 0; i < 3; i++) {
+        ring_buffer_write(&rbs[i], (uint8_t)i);
+    }
+    TEST_ASSERT(ring_buffer_set_next(&set) == &rbs[0], "RR 0");
+    TEST_ASSERT(ring_buffer_set_next(&set) == &rbs[1], "RR 1");
+    TEST_ASSERT(ring_buffer_set_next(&set) == &rbs[2], "RR 2");
+    TEST_ASSERT(ring_buffer_set_next(&set) == &rbs[0], "RR wrap to 0");
+    
+    /* 销毁时自动移出 */
+    ring_buffer_destroy(&rbs[1]);
+    TEST_ASSERT(set.rings[1] == NULL && !(set.ready & 0x2), "Destroy should remove ring");
+    ring_buffer_destroy(&rbs[0]);
+    ring_buffer_destroy(&rbs[2]);
+    TEST_ASSERT(ring_buffer_set_next(&set) == NULL, "Set should be empty");
+    
+    TEST_PASS("Ring Set");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_GROUP
+/**
+ * @brief 测试优先级缓冲区组（配额防饿死）
+ */
+bool test_group(void)
+{
+    static uint8_t bufs[3][16];
+    static const uint8_t fill[10] = {0};
+    static const int expect_src[] = {0, 1, 2, 0, 1, 0, 1};
+    static const uint16_t expect_len[] = {4, 2, 3, 4, 2, 2, 1};
+    ring_buffer_t rbs[3];
+    ring_buffer_group_t group;
+    uint8_t temp[16];
+    int src;
+    
+    ring_buffer_group_init(&group);
+    for (int i = 0; i < 3; i++) {
+        ring_buffer_create(&rbs[i], bufs[i], sizeof(bufs[i]), RING_BUFFER_TYPE_LOCKFREE);
+    }
+    
+    /* 高优先级每轮 4 字节，中优先级 2 字节，低优先级不限 */
+    TEST_ASSERT(ring_buffer_group_add(&group, &rbs[0], 4) == 0, "Add 0 failed");
+    TEST_ASSERT(ring_buffer_group_add(&group, &rbs[1], 2) == 1, "Add 1 failed");
+    TEST_ASSERT(ring_buffer_group_add(&group, &rbs[2], 0) == 2, "Add 2 failed");
+    
+    ring_buffer_write_multi(&rbs[0], fill, 10);
+    ring_buffer_write_multi(&rbs[1], fill, 5);
+    ring_buffer_write_multi(&rbs[2], fill, 3);
+    
+    for (unsigned i = 0; i < sizeof(expect_src) / sizeof(expect_src[0]); i++) {
+        uint16_t n = ring_buffer_group_read(&group, temp, sizeof(temp), &src);
+        TEST_ASSERT(n == expect_len[i], "Group read length mismatch");
+        TEST_ASSERT(src == expect_src[i], "Group read source mismatch");
+    }
+    TEST_ASSERT(ring_buffer_group_read(&group, temp, sizeof(temp), &src) == 0, "Group should be empty");
+    
+    for (int i = 0; i < 3; i++) {
+        ring_buffer_destroy(&rbs[i]);
+    }
+    
+    TEST_PASS("Priority Group");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_SHARD
+#define SHARD_PRODUCERS  4
+#define SHARD_RECORDS    5000
+
+static uint8_t shard_storage[SHARD_PRODUCERS * 256];
+static ring_buffer_sharded_t shard_set;
+
+/**
+ * @brief 每条记录：[生产者编号][序号 4 字节]，时间戳即序号
+ */
+static void *shard_producer(void *arg)
+{
+    ring_buffer_t *mine = ring_buffer_shard_claim(&shard_set);
+    uint8_t rec[5];
+
+    (void)arg;
+    rec[0] = (uint8_t)((ring_buffer_shard_t *)mine - shard_set.shard);
+    for (uint32_t seq = 0; seq < SHARD_RECORDS; ) {
+        memcpy(&rec[1], &seq, sizeof(seq));
+        if (ring_buffer_shard_write(mine, seq, rec, sizeof(rec))) {
+            seq++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 测试分片缓冲区（轮询 / 时间戳合并，多生产者下每条记录完整且按序）
+ */
+bool test_shard(void)
+{
+    static const uint64_t stamps[3][2] = { {5, 9}, {2, 7}, {3, 8} };
+    static const int expect_src[] = {1, 2, 0, 1, 2, 0};
+    pthread_t th[SHARD_PRODUCERS];
+    uint32_t next[SHARD_PRODUCERS] = {0};
+    uint8_t out[16];
+    uint64_t ts;
+    int src;
+
+    /* 时间戳顺序：各分片首条记录中最小者先出 */
+    TEST_ASSERT(ring_buffer_shard_init(&shard_set, shard_storage, 64, 3,
+                                       RING_BUFFER_SHARD_TIMESTAMP), "Init failed");
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 2; j++) {
+            uint8_t v = (uint8_t)(i * 10 + j);
+            TEST_ASSERT(ring_buffer_shard_write(&shard_set.shard[i].rb, stamps[i][j], &v, 1),
+                        "Shard write failed");
+        }
+    }
+    uint64_t last = 0;
+    for (int k = 0; k < 6; k++) {
+        TEST_ASSERT(ring_buffer_shard_read(&shard_set, out, sizeof(out), &src, &ts) == 1,
+                    "Shard read failed");
+        TEST_ASSERT(ts >= last, "Timestamp order violated");
+        TEST_ASSERT(out[0] == (uint8_t)(src * 10 + (ts == stamps[src][1])), "Wrong record");
+        last = ts;
+    }
+    TEST_ASSERT(ring_buffer_shard_read(&shard_set, out, sizeof(out), &src, &ts) == 0,
+                "Shards should be empty");
+
+    /* 轮询顺序与截断 */
+    TEST_ASSERT(ring_buffer_shard_init(&shard_set, shard_storage, 64, 3,
+                                       RING_BUFFER_SHARD_ROUND_ROBIN), "Init failed");
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT(ring_buffer_shard_write(&shard_set.shard[i].rb, 0, "record", 6) &&
+                    ring_buffer_shard_write(&shard_set.shard[i].rb, 0, "ab", 2), "Shard write failed");
+    }
+    TEST_ASSERT(ring_buffer_shard_read(&shard_set, out, 4, &src, NULL) == 4 && src == 0 &&
+                memcmp(out, "reco", 4) == 0, "Truncated read failed");
+    for (unsigned k = 0; k < sizeof(expect_src) / sizeof(expect_src[0]) - 1; k++) {
+        TEST_ASSERT(ring_buffer_shard_read(&shard_set, out, sizeof(out), &src, NULL) > 0 &&
+                    src == expect_src[k], "Round robin order mismatch");
+    }
+    TEST_ASSERT(ring_buffer_shard_read(&shard_set, out, sizeof(out), &src, NULL) == 0,
+                "Shards should be empty");
+
+    /* 多生产者：每个生产者独占一个分片 */
+    TEST_ASSERT(ring_buffer_shard_init(&shard_set, shard_storage, 256, SHARD_PRODUCERS,
+                                       RING_BUFFER_SHARD_ROUND_ROBIN), "Init failed");
+    for (int i = 0; i < SHARD_PRODUCERS; i++) {
+        pthread_create(&th[i], NULL, shard_producer, NULL);
+    }
+    for (uint32_t got = 0; got < SHARD_PRODUCERS * SHARD_RECORDS; ) {
+        uint32_t seq;
+
+        if (ring_buffer_shard_read(&shard_set, out, sizeof(out), &src, &ts) == 0) {
+            continue;
+        }
+        memcpy(&seq, &out[1], sizeof(seq));
+        TEST_ASSERT(out[0] == src && seq == ts, "Record corrupted");
+        TEST_ASSERT(seq == next[src], "Records out of order within a shard");
+        next[src]++;
+        got++;
+    }
+    for (int i = 0; i < SHARD_PRODUCERS; i++) {
+        pthread_join(th[i], NULL);
+    }
+    TEST_ASSERT(ring_buffer_shard_claim(&shard_set) == NULL, "All shards should be claimed");
+
+    TEST_PASS("Sharded MPSC");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_PERSIST
+/**
+ * @brief 测试掉电/崩溃恢复（模拟 RAM 丢失后重新打开同一区域）
+ */
+bool test_persist(void)
+{
+    static uint8_t region[RING_BUFFER_PERSIST_REGION_SIZE(32)];
+    uint8_t data[40];
+    uint8_t temp[40];
+    
+    for (int i = 0; i < 40; i++) {
+        data[i] = (uint8_t)(0xA0 + i);
+    }
+    
+    /* 区域内容随机时应初始化为空 */
+    memset(region, 0x5A, sizeof(region));
+    TEST_ASSERT(ring_buffer_persist_open(&test_rb, region, sizeof(region)) ==
+                RING_BUFFER_PERSIST_NEW, "Garbage region should open as new");
+    TEST_ASSERT(ring_buffer_is_empty(&test_rb), "New region should be empty");
+    
+    /* 移动指针后写入，使数据跨越环绕点 */
+    ring_buffer_write_multi(&test_rb, data, 25);
+    ring_buffer_read_multi(&test_rb, temp, 25);
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, 20) == 20, "Write failed");
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, 5) == 5, "Read failed");
+    
+    /* 模拟崩溃：RAM 中的控制结构丢失 */
+    memset(&test_rb, 0, sizeof(test_rb));
+    
+    TEST_ASSERT(ring_buffer_persist_open(&test_rb, region, sizeof(region)) ==
+                RING_BUFFER_PERSIST_RECOVERED, "Should recover");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 15, "Recovered available should be 15");
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, 40) == 15, "Recovered read failed");
+    TEST_ASSERT(memcmp(temp, &data[5], 15) == 0, "Recovered data mismatch");
+    TEST_ASSERT(((ring_buffer_persist_hdr_t *)region)->recover_count == 1, "Recover count mismatch");
+    
+    /* 索引越界视为损坏 */
+    ((ring_buffer_persist_hdr_t *)region)->head = 32;
+    TEST_ASSERT(ring_buffer_persist_open(&test_rb, region, sizeof(region)) ==
+                RING_BUFFER_PERSIST_NEW, "Corrupt index should open as new");
+    
+    ring_buffer_persist_sync(&test_rb);
+    ring_buffer_destroy(&test_rb);
+    
+    TEST_PASS("Persistent Recovery");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_CRC
+/**
+ * @brief 测试带 CRC 的批量读写（标准校验值 "123456789"）
+ */
+bool test_crc(void)
+{
+    static const struct {
+        ring_buffer_crc_type_t type;
+        uint32_t check;
+    } cases[] = {
+        { RING_BUFFER_CRC16_CCITT,  0x29B1 },
+        { RING_BUFFER_CRC16_MODBUS, 0x4B37 },
+        { RING_BUFFER_CRC32,        0xCBF43926 },
+        { RING_BUFFER_CRC32C,       0xE3069283 },
+    };
+    const uint8_t msg[] = "123456789";
+    uint8_t temp[16];
+    
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        ring_buffer_create(&test_rb, test_buffer, 16, RING_BUFFER_TYPE_LOCKFREE);
+        
+        /* 先移动读写指针，使数据跨越环绕点 */
+        ring_buffer_write_multi(&test_rb, temp, 12);
+        ring_buffer_read_multi(&test_rb, temp, 12);
+        
+        uint32_t wcrc = ring_buffer_crc_init(cases[i].type);
+        uint32_t rcrc = ring_buffer_crc_init(cases[i].type);
+        
+        /* 分两次写入，验证 CRC 可累计 */
+        TEST_ASSERT(ring_buffer_write_multi_crc(&test_rb, msg, 4, cases[i].type, &wcrc) == 4,
+                    "CRC write count mismatch");
+        TEST_ASSERT(ring_buffer_write_multi_crc(&test_rb, &msg[4], 5, cases[i].type, &wcrc) == 5,
+                    "CRC write count mismatch");
+        TEST_ASSERT(ring_buffer_crc_final(cases[i].type, wcrc) == cases[i].check,
+                    "CRC on write mismatch");
+        
+        TEST_ASSERT(ring_buffer_read_multi_crc(&test_rb, temp, 9, cases[i].type, &rcrc) == 9,
+                    "CRC read count mismatch");
+        TEST_ASSERT(memcmp(temp, msg, 9) == 0, "CRC read data mismatch");
+        TEST_ASSERT(ring_buffer_crc_final(cases[i].type, rcrc) == cases[i].check,
+                    "CRC on read mismatch");
+        
+        ring_buffer_destroy(&test_rb);
+    }
+    
+    TEST_PASS("CRC Read/Write");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_FD_IO
+/**
+ * @brief 测试文件描述符直接读写（管道，跨越环绕点）
+ */
+bool test_fd_io(void)
+{
+    int pfd[2];
+    TEST_ASSERT(pipe(pfd) == 0, "Pipe create failed");
+    
+    ring_buffer_create(&test_rb, test_buffer, 16, RING_BUFFER_TYPE_LOCKFREE);
+    
+    /* 先移动读写指针，使数据跨越环绕点 */
+    uint8_t temp[16];
+    ring_buffer_write_multi(&test_rb, temp, 12);
+    ring_buffer_read_multi(&test_rb, temp, 12);
+    
+    const uint8_t msg[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    TEST_ASSERT(write(pfd[1], msg, sizeof(msg)) == sizeof(msg), "Pipe write failed");
+    
+    /* 管道 → 缓冲区 */
+    TEST_ASSERT(ring_buffer_fill_from_fd(&test_rb, pfd[0], 64) == 10, "Fill count mismatch");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 10, "Available should be 10");
+    
+    /* 缓冲区 → 管道，限制最多 6 字节 */
+    TEST_ASSERT(ring_buffer_drain_to_fd(&test_rb, pfd[1], 6) == 6, "Drain count mismatch");
+    TEST_ASSERT(ring_buffer_drain_to_fd(&test_rb, pfd[1], 64) == 4, "Drain rest mismatch");
+    TEST_ASSERT(ring_buffer_drain_to_fd(&test_rb, pfd[1], 64) == 0, "Drain should be 0 when empty");
+    
+    TEST_ASSERT(read(pfd[0], temp, sizeof(temp)) == 10, "Pipe read failed");
+    TEST_ASSERT(memcmp(temp, msg, 10) == 0, "Data mismatch");
+    
+    ring_buffer_destroy(&test_rb);
+    close(pfd[0]);
+    close(pfd[1]);
+    
+    TEST_PASS("FD I/O");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_ZEROCOPY
+/**
+ * @brief 测试零拷贝发送（本地 TCP 回环）
+ */
+bool test_zerocopy(void)
+{
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    int lfd = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT(lfd >= 0, "Socket create failed");
+    TEST_ASSERT(bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) == 0, "Bind failed");
+    TEST_ASSERT(listen(lfd, 1) == 0, "Listen failed");
+    getsockname(lfd, (struct sockaddr *)&addr, &addr_len);
+    
+    int cfd = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT(connect(cfd, (struct sockaddr *)&addr, sizeof(addr)) == 0, "Connect failed");
+    int sfd = accept(lfd, NULL, NULL);
+    TEST_ASSERT(sfd >= 0, "Accept failed");
+    
+    ring_buffer_zc_t zc;
+    TEST_ASSERT(ring_buffer_zc_init(&zc, cfd), "Zerocopy init failed");
+    
+    ring_buffer_create(&test_rb, test_buffer, 64, RING_BUFFER_TYPE_LOCKFREE);
+    
+    uint8_t data[40];
+    uint8_t temp[40];
+    for (int i = 0; i < 40; i++) {
+        data[i] = (uint8_t)(0x40 + i);
+    }
+    
+    /* 先移动读写指针，使数据跨越环绕点 */
+    ring_buffer_write_multi(&test_rb, data, 40);
+    ring_buffer_read_multi(&test_rb, temp, 40);
+    
+    ring_buffer_write_multi(&test_rb, data, 40);
+    
+    /* 分两次发送，发送后 tail 不动 */
+    TEST_ASSERT(ring_buffer_zc_send(&test_rb, &zc, 25) == 25, "First send mismatch");
+    TEST_ASSERT(ring_buffer_zc_send(&test_rb, &zc, 64) == 15, "Second send mismatch");
+    TEST_ASSERT(ring_buffer_zc_send(&test_rb, &zc, 64) == 0, "Nothing left to send");
+    TEST_ASSERT(ring_buffer_available(&test_rb) == 40, "Tail moved before completion");
+    
+    /* 等待内核完成通知 */
+    uint16_t released = 0;
+    for (int tries = 0; tries < 100 && released < 40; tries++) {
+        struct pollfd pfd = { .fd = cfd, .events = 0 };
+        poll(&pfd, 1, 10);
+        released += ring_buffer_zc_reap(&test_rb, &zc);
+    }
+    TEST_ASSERT(released == 40, "Completion not received");
+    TEST_ASSERT(ring_buffer_is_empty(&test_rb), "Should be empty after reap");
+    
+    TEST_ASSERT(recv(sfd, temp, 40, MSG_WAITALL) == 40, "Receive failed");
+    TEST_ASSERT(memcmp(temp, data, 40) == 0, "Data mismatch");
+    
+    ring_buffer_destroy(&test_rb);
+    close(sfd);
+    close(cfd);
+    close(lfd);
+    
+    TEST_PASS("Zerocopy Send");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_IO_URING
+/**
+ * @brief 测试 io_uring 引擎（文件 → 缓冲区 A → 缓冲区 B → 管道）
+ */
+bool test_io_uring(void)
+{
+    static uint8_t buf_a[64];
+    static uint8_t buf_b[32];
+    ring_buffer_t rb_a, rb_b;
+    ring_buffer_uring_t eng;
+    uint8_t data[200];
+    uint8_t temp[200];
+    int pfd[2];
+    
+    for (int i = 0; i < 200; i++) {
+        data[i] = (uint8_t)(i * 7 + 3);
+    }
+    
+    FILE *fp = tmpfile();
+    TEST_ASSERT(fp != NULL, "Temp file create failed");
+    TEST_ASSERT(fwrite(data, 1, sizeof(data), fp) == sizeof(data), "Temp file write failed");
+    fflush(fp);
+    rewind(fp);
+    TEST_ASSERT(pipe(pfd) == 0, "Pipe create failed");
+    
+    TEST_ASSERT(ring_buffer_uring_init(&eng, 8), "io_uring init failed");
+    ring_buffer_create(&rb_a, buf_a, sizeof(buf_a), RING_BUFFER_TYPE_LOCKFREE);
+    ring_buffer_create(&rb_b, buf_b, sizeof(buf_b), RING_BUFFER_TYPE_LOCKFREE);
+    int fill = ring_buffer_uring_add(&eng, &rb_a, fileno(fp), RING_BUFFER_URING_FILL);
+    int drain = ring_buffer_uring_add(&eng, &rb_b, pfd[1], RING_BUFFER_URING_DRAIN);
+    TEST_ASSERT(fill == 0 && drain == 1, "Slot index mismatch");
+    
+    /* 提交失败时收回 SQE，不计入在途，槽位下一轮可重新提交 */
+    int ring_fd = eng.ring_fd;
+    unsigned sq_tail = *eng.sq_tail;
+    eng.ring_fd = -1;
+    TEST_ASSERT(ring_buffer_uring_run(&eng, false) == -1, "Submit on bad fd should fail");
+    TEST_ASSERT(eng.inflight == 0 && !eng.slots[fill].busy, "Rejected SQE counted as inflight");
+    TEST_ASSERT(*eng.sq_tail == sq_tail, "Rejected SQE not rolled back");
+    eng.ring_fd = ring_fd;
+    
+    /* 引擎负责两端 I/O，这里只在两个缓冲区之间搬运 */
+    for (int round = 0; round < 1000; round++) {
+        TEST_ASSERT(ring_buffer_uring_run(&eng, true) >= 0, "io_uring run failed");
+        
+        uint16_t n = ring_buffer_read_multi(&rb_a, temp, ring_buffer_free_space(&rb_b));
+        ring_buffer_write_multi(&rb_b, temp, n);
+        
+        if (eng.slots[fill].eof && eng.inflight == 0 &&
+            ring_buffer_is_empty(&rb_a) && ring_buffer_is_empty(&rb_b)) {
+            break;
+        }
+    }
+    TEST_ASSERT(eng.slots[fill].eof, "EOF not reached");
+    TEST_ASSERT(eng.slots[fill].err == 0 && eng.slots[drain].err == 0, "Slot error");
+    TEST_ASSERT(ring_buffer_is_empty(&rb_b), "Drain ring not empty");
+    
+    TEST_ASSERT(read(pfd[0], temp, sizeof(temp)) == sizeof(temp), "Pipe read failed");
+    TEST_ASSERT(memcmp(temp, data, sizeof(data)) == 0, "Data mismatch");
+    
+    ring_buffer_uring_deinit(&eng);
+    ring_buffer_destroy(&rb_a);
+    ring_buffer_destroy(&rb_b);
+    fclose(fp);
+    close(pfd[0]);
+    close(pfd[1]);
+    
+    TEST_PASS("io_uring Engine");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_SHM
+/**
+ * @brief 测试共享内存进程间缓冲区（子进程生产，父进程消费）
+ */
+bool test_shm(void)
+{
+    ring_buffer_shm_t prod, cons;
+    const uint32_t total = 100000;
+    uint8_t chunk[97];
+    
+    FILE *fp = tmpfile();
+    TEST_ASSERT(fp != NULL, "Temp file create failed");
+    
+    /* 未初始化的对象应拒绝连接 */
+    TEST_ASSERT(ftruncate(fileno(fp), 4096) == 0, "Truncate failed");
+    TEST_ASSERT(!ring_buffer_shm_attach(&cons, fileno(fp)), "Attach should fail without magic");
+    
+    TEST_ASSERT(ring_buffer_shm_create(&prod, fileno(fp), 1000), "Shm create failed");
+    TEST_ASSERT(ring_buffer_shm_free_space(&prod) == 999, "Free space should be 999");
+    
+    pid_t pid = fork();
+    TEST_ASSERT(pid >= 0, "Fork failed");
+    
+    if (pid == 0) {
+        /* 子进程：重新连接后写入 0, 1, 2, ... 序列 */
+        ring_buffer_shm_detach(&prod);
+        if (!ring_buffer_shm_attach(&prod, fileno(fp))) {
+            _exit(1);
+        }
+        for (uint32_t sent = 0; sent < total; ) {
+            uint32_t n = (total - sent < sizeof(chunk)) ? total - sent : sizeof(chunk);
+            for (uint32_t i = 0; i < n; i++) {
+                chunk[i] = (uint8_t)(sent + i);
+            }
+            uint32_t w = ring_buffer_shm_write(&prod, chunk, n);
+            sent += w;
+            if (w < n) {
+                usleep(10);
+            }
+        }
+        _exit(0);
+    }
+    
+    TEST_ASSERT(ring_buffer_shm_attach(&cons, fileno(fp)), "Shm attach failed");
+    
+    uint32_t received = 0;
+    bool ok = true;
+    while (received < total) {
+        uint32_t n = ring_buffer_shm_read(&cons, chunk, sizeof(chunk));
+        for (uint32_t i = 0; i < n; i++) {
+            ok &= (chunk[i] == (uint8_t)(received + i));
+        }
+        received += n;
+        if (n == 0) {
+            usleep(10);
+        }
+    }
+    
+    int status;
+    waitpid(pid, &status, 0);
+    TEST_ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0, "Producer failed");
+    TEST_ASSERT(ok, "Data mismatch");
+    TEST_ASSERT(ring_buffer_shm_available(&cons) == 0, "Should be empty");
+    
+    /* 共享内存中自己的索引被写坏时拒绝读写，不越界拷贝 */
+    uint32_t saved = prod.hdr->head;
+    prod.hdr->head = prod.size + 5;
+    TEST_ASSERT(ring_buffer_shm_write(&prod, chunk, 1) == 0, "Corrupt own head should be rejected");
+    prod.hdr->head = saved;
+    saved = cons.hdr->tail;
+    cons.hdr->tail = cons.size;
+    TEST_ASSERT(ring_buffer_shm_read(&cons, chunk, 1) == 0, "Corrupt own tail should be rejected");
+    cons.hdr->tail = saved;
+    
+    ring_buffer_shm_detach(&cons);
+    ring_buffer_shm_detach(&prod);
+    fclose(fp);
+    
+    TEST_PASS("Shared Memory IPC");
+    return true;
+}
+#endif
+
+#if RING_BUFFER_ENABLE_LINUX_STORAGE
+/**
+ * @brief 测试 Linux 存储分配器
+ */
+bool test_linux_storage(void)
+{
+    ring_buffer_storage_t st;
+    
+    /* 大页不可用时应自动回退 */
+    bool ret = ring_buffer_storage_alloc(&st, 4096, -1,
+                                         RING_BUFFER_STORAGE_HUGETLB |
+                                         RING_BUFFER_STORAGE_PREFAULT);
+    TEST_ASSERT(ret == true, "Storage alloc failed");
+    TEST_ASSERT(st.buffer != NULL, "Storage buffer is NULL");
+    TEST_ASSERT(st.map_len >= 4096, "Mapping too small");
+    TEST_ASSERT(st.flags & RING_BUFFER_STORAGE_PREFAULT, "Prefault flag lost");
+    
+    ret = ring_buffer_create(&test_rb, st.buffer, st.size, RING_BUFFER_TYPE_LOCKFREE);
+    TEST_ASSERT(ret == true, "Create on allocated storage failed");
+    
+    uint8_t data[100];
+    uint8_t temp[100];
+    memset(data, 0x5C, sizeof(data));
+    TEST_ASSERT(ring_buffer_write_multi(&test_rb, data, 100) == 100, "Write failed");
+    TEST_ASSERT(ring_buffer_read_multi(&test_rb, temp, 100) == 100, "Read failed");
+    TEST_ASSERT(memcmp(data, temp, 100) == 0, "Data mismatch");
+    
+    ring_buffer_destroy(&test_rb);
+    ring_buffer_storage_free(&st);
+    TEST_ASSERT(st.buffer == NULL, "Storage not cleared");
+    
+    TEST_PASS("Linux Storage");
+    return true;
+}
+#endif
+
 /* ==================== 主测试函数 ==================== */
 
 int main(void)
@@ -300,9 +2122,72 @@ int main(void)
     test_single_byte_rw();
     test_multi_byte_rw();
     test_wrap_around();
+    test_copy_lengths();
+#if RING_BUFFER_STREAM_THRESHOLD
+    test_stream_copy();
+#endif
+    test_iovec_rw();
     test_full_condition();
     test_clear();
     test_custom_strategy();
+    test_decorator();
+#if RING_BUFFER_ENABLE_SPINLOCK
+    test_spinlock();
+#endif
+#if RING_BUFFER_ENABLE_COMBINING
+    test_combining();
+#endif
+#if RING_BUFFER_ENABLE_MUTEX && RING_BUFFER_MUTEX_COPY_OUTSIDE
+    test_mutex_reserve();
+#endif
+#if RING_BUFFER_ENABLE_RESIZE
+    test_resize();
+#endif
+#if RING_BUFFER_ENABLE_SEGMENTED
+    test_segmented();
+#endif
+#if RING_BUFFER_ENABLE_LZ
+    test_lz();
+#endif
+#if RING_BUFFER_ENABLE_AES
+    test_aes();
+#endif
+#if RING_BUFFER_ENABLE_TRACE
+    test_trace();
+#endif
+#if RING_BUFFER_ENABLE_SNAPSHOT
+    test_snapshot();
+#endif
+#if RING_BUFFER_ENABLE_RING_SET
+    test_ring_set();
+#endif
+#if RING_BUFFER_ENABLE_GROUP
+    test_group();
+#endif
+#if RING_BUFFER_ENABLE_SHARD
+    test_shard();
+#endif
+#if RING_BUFFER_ENABLE_PERSIST
+    test_persist();
+#endif
+#if RING_BUFFER_ENABLE_CRC
+    test_crc();
+#endif
+#if RING_BUFFER_ENABLE_FD_IO
+    test_fd_io();
+#endif
+#if RING_BUFFER_ENABLE_ZEROCOPY
+    test_zerocopy();
+#endif
+#if RING_BUFFER_ENABLE_IO_URING
+    test_io_uring();
+#endif
+#if RING_BUFFER_ENABLE_SHM
+    test_shm();
+#endif
+#if RING_BUFFER_ENABLE_LINUX_STORAGE
+    test_linux_storage();
+#endif
     
     printf("\n========== All Tests Passed! ==========\n\n");
     
@@ -0,0 +1,247 @@
+/**
+ * @file    ring_buffer_trace.c
+ * @brief   环形缓冲区事件追踪
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 适用场景：
+ * - 流水线卡顿时定位是哪个缓冲区、在什么时刻满了或空了
+ * - 生产环境常开的"飞行记录仪"，出问题后导出最近的事件
+ *
+ * 实现方式：
+ * - ring_buffer.c 的读写入口在缓冲区设置了追踪编号时调用 rb_trace_record()
+ * - 每个线程首次记录时领取一个空闲的静态追踪缓冲区，之后只写自己的缓冲区，
+ *   线程之间没有共享写入；线程退出前调用 ring_buffer_trace_thread_exit()
+ *   归还，供之后的线程复用。同时存活的线程超出 RING_BUFFER_TRACE_MAX_THREADS
+ *   时，多出的线程共用最后一个
+ * - 事件写完后才发布（推进 pos），记录进行中导出也不会读到写了一半的事件；
+ *   导出期间线程写满一圈时，最旧的事件仍可能被覆盖，需要完整结果时先停止记录
+ * - 追踪缓冲区写满后覆盖最旧的事件，导出时按时间先后输出并报告被覆盖的条数
+ * - 导出为紧凑的二进制格式，由主机端 ring_buffer_trace2json 转换为 JSON
+ */
+
+#include "ring_buffer_internal.h"
+
+#if RING_BUFFER_ENABLE_TRACE
+
+#if (RING_BUFFER_TRACE_EVENTS & (RING_BUFFER_TRACE_EVENTS - 1)) != 0
+#error "RING_BUFFER_TRACE_EVENTS 必须是 2 的幂"
+#endif
+
+#ifndef RING_BUFFER_TRACE_TIMESTAMP
+#include <time.h>
+
+static inline uint64_t trace_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#define RING_BUFFER_TRACE_TIMESTAMP()  trace_now()
+#endif
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+ * @brief 单个线程的追踪缓冲区
+ */
+typedef struct {
+    uint32_t pos;                           /**< 已发布的事件总数（单调递增）*/
+    uint32_t claim;                         /**< 已占用的事件格数 */
+    uint32_t done;                          /**< 已写完的事件格数 */
+    uint8_t owned;                          /**< 已被某个线程领取（仅独占缓冲区）*/
+    ring_buffer_trace_event_t events[RING_BUFFER_TRACE_EVENTS];
+} trace_buf_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+/* 最后一个缓冲区由超出数量的线程共用 */
+static trace_buf_t trace_bufs[RING_BUFFER_TRACE_MAX_THREADS + 1];
+static trace_buf_t *const trace_shared = &trace_bufs[RING_BUFFER_TRACE_MAX_THREADS];
+static uint32_t trace_threads;              /* 用过的缓冲区个数（导出范围）*/
+static bool trace_running;
+static RING_BUFFER_TRACE_TLS trace_buf_t *trace_self;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void trace_raise_threads(uint32_t n)
+{
+    uint32_t cur = __atomic_load_n(&trace_threads, __ATOMIC_RELAXED);
+
+    while (cur < n &&
+           !__atomic_compare_exchange_n(&trace_threads, &cur, n, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+}
+
+static trace_buf_t *trace_attach(void)
+{
+    for (uint32_t i = 0; i < RING_BUFFER_TRACE_MAX_THREADS; i++) {
+        uint8_t expected = 0;
+
+        if (__atomic_load_n(&trace_bufs[i].owned, __ATOMIC_RELAXED) == 0 &&
+            __atomic_compare_exchange_n(&trace_bufs[i].owned, &expected, 1, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            trace_raise_threads(i + 1);
+            trace_self = &trace_bufs[i];
+            return trace_self;
+        }
+    }
+
+    trace_raise_threads(RING_BUFFER_TRACE_MAX_THREADS + 1);
+    trace_self = trace_shared;
+    return trace_self;
+}
+
+static void trace_fill(ring_buffer_trace_event_t *ev, const ring_buffer_t *rb,
+                       uint8_t op, uint16_t req, uint16_t len)
+{
+    ev->ts = RING_BUFFER_TRACE_TIMESTAMP();
+    ev->ring_id = rb->trace_id;
+    ev->op = op;
+    ev->req = req;
+    ev->len = len;
+    ev->occupancy = rb->ops->available(rb);
+}
+
+static void trace_emit_events(const trace_buf_t *buf, uint32_t first, uint32_t count,
+                              ring_buffer_trace_sink_t sink, void *arg)
+{
+    uint32_t start = first & (RING_BUFFER_TRACE_EVENTS - 1);
+    uint32_t n1 = RING_BUFFER_TRACE_EVENTS - start;
+
+    if (n1 > count) {
+        n1 = count;
+    }
+    if (n1 > 0) {
+        sink(&buf->events[start], n1 * sizeof(ring_buffer_trace_event_t), arg);
+    }
+    if (count > n1) {
+        sink(&buf->events[0], (count - n1) * sizeof(ring_buffer_trace_event_t), arg);
+    }
+}
+
+/* Exported functions (for ring_buffer.c) ------------------------------------*/
+
+void rb_trace_record(const ring_buffer_t *rb, uint8_t op, uint16_t req, uint16_t len)
+{
+    if (!__atomic_load_n(&trace_running, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    trace_buf_t *buf = trace_self;
+
+    if (buf == NULL) {
+        buf = trace_attach();
+    }
+
+    /*
+     * 原子递增各占一格（共用缓冲区或被中断打断时不会重叠），写完后计入 done；
+     * done 追上 claim 时之前占用的格都已写完，才把 pos 推进到该值
+     */
+    uint32_t pos = __atomic_fetch_add(&buf->claim, 1, __ATOMIC_RELAXED);
+
+    trace_fill(&buf->events[pos & (RING_BUFFER_TRACE_EVENTS - 1)], rb, op, req, len);
+
+    uint32_t done = __atomic_add_fetch(&buf->done, 1, __ATOMIC_ACQ_REL);
+
+    if (done == __atomic_load_n(&buf->claim, __ATOMIC_ACQUIRE)) {
+        uint32_t cur = __atomic_load_n(&buf->pos, __ATOMIC_RELAXED);
+
+        while ((int32_t)(done - cur) > 0 &&
+               !__atomic_compare_exchange_n(&buf->pos, &cur, done, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+void ring_buffer_trace_set_id(ring_buffer_t *rb, uint8_t id)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (rb == NULL) {
+        return;
+    }
+#endif
+
+    rb->trace_id = id;
+}
+
+void ring_buffer_trace_thread_exit(void)
+{
+    trace_buf_t *buf = trace_self;
+
+    if (buf != NULL && buf != trace_shared) {
+        __atomic_store_n(&buf->owned, 0, __ATOMIC_RELEASE);
+    }
+    trace_self = NULL;
+}
+
+void ring_buffer_trace_start(void)
+{
+    __atomic_store_n(&trace_running, true, __ATOMIC_RELEASE);
+}
+
+void ring_buffer_trace_stop(void)
+{
+    __atomic_store_n(&trace_running, false, __ATOMIC_RELEASE);
+}
+
+void ring_buffer_trace_reset(void)
+{
+    for (uint32_t i = 0; i <= RING_BUFFER_TRACE_MAX_THREADS; i++) {
+        __atomic_store_n(&trace_bufs[i].pos, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&trace_bufs[i].claim, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&trace_bufs[i].done, 0, __ATOMIC_RELAXED);
+    }
+}
+
+uint32_t ring_buffer_trace_dump(ring_buffer_trace_sink_t sink, void *arg)
+{
+#if RING_BUFFER_ENABLE_PARAM_CHECK
+    if (sink == NULL) {
+        return 0;
+    }
+#endif
+
+    uint32_t threads = __atomic_load_n(&trace_threads, __ATOMIC_ACQUIRE);
+    uint32_t total = 0;
+
+    if (threads > RING_BUFFER_TRACE_MAX_THREADS + 1) {
+        threads = RING_BUFFER_TRACE_MAX_THREADS + 1;
+    }
+
+    ring_buffer_trace_file_hdr_t hdr = {
+        .magic = RING_BUFFER_TRACE_MAGIC,
+        .version = RING_BUFFER_TRACE_VERSION,
+        .event_size = sizeof(ring_buffer_trace_event_t),
+        .ticks_per_us = RING_BUFFER_TRACE_TICKS_PER_US,
+        .threads = threads,
+    };
+
+    sink(&hdr, sizeof(hdr), arg);
+
+    for (uint32_t i = 0; i < threads; i++) {
+        const trace_buf_t *buf = &trace_bufs[i];
+        uint32_t pos = __atomic_load_n(&buf->pos, __ATOMIC_ACQUIRE);
+        uint32_t count = (pos > RING_BUFFER_TRACE_EVENTS) ? RING_BUFFER_TRACE_EVENTS : pos;
+        ring_buffer_trace_block_hdr_t blk = {
+            .thread = i,
+            .count = count,
+            .lost = pos - count,
+        };
+
+        sink(&blk, sizeof(blk), arg);
+        trace_emit_events(buf, pos - count, count, sink, arg);
+        total += count;
+    }
+
+    return total;
+}
+
+#endif /* RING_BUFFER_ENABLE_TRACE */
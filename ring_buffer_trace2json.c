@@ -0,0 +1,171 @@
+/**
+ * @file    ring_buffer_trace2json.c
+ * @brief   追踪文件转换工具：二进制 → Chrome trace / Perfetto JSON
+ * @author  CRITTY.熙影
+ * @date    2024-12-27
+ * @version 2.1
+ *
+ * @details
+ * 读取 ring_buffer_trace_dump() 导出的文件，输出 Chrome trace 事件格式：
+ * - 每个缓冲区一条计数器轨道（"ring N"），显示操作后的数据量
+ * - 每次操作一个线程内瞬时事件，参数含请求/实际长度
+ * - 写入被截断（溢出）或读出数据不足时，事件名分别为 overflow / underrun，
+ *   便于在时间轴上搜索
+ *
+ * 在 chrome://tracing 或 https://ui.perfetto.dev 中打开输出文件
+ *
+ * 编译方式（主机）：
+ * gcc -o ring_buffer_trace2json ring_buffer_trace2json.c -I.
+ *
+ * 运行：
+ * ./ring_buffer_trace2json trace.bin > trace.json
+ *
+ * @note 导出文件为本机字节序，须在与目标相同字节序的主机上转换
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define RING_BUFFER_ENABLE_TRACE  1
+#include "ring_buffer.h"
+
+/* Private functions ---------------------------------------------------------*/
+
+static const char *op_name(uint8_t op)
+{
+    static const char *const names[RING_BUFFER_OP_COUNT] = {
+        [RING_BUFFER_OP_WRITE]           = "write",
+        [RING_BUFFER_OP_READ]            = "read",
+        [RING_BUFFER_OP_WRITE_MULTI]     = "write_multi",
+        [RING_BUFFER_OP_READ_MULTI]      = "read_multi",
+        [RING_BUFFER_OP_AVAILABLE]       = "available",
+        [RING_BUFFER_OP_FREE_SPACE]      = "free_space",
+        [RING_BUFFER_OP_IS_EMPTY]        = "is_empty",
+        [RING_BUFFER_OP_IS_FULL]         = "is_full",
+        [RING_BUFFER_OP_CLEAR]           = "clear",
+        [RING_BUFFER_OP_WRITEV]          = "writev",
+        [RING_BUFFER_OP_READV]           = "readv",
+        [RING_BUFFER_OP_WRITE_MULTI_CRC] = "write_multi_crc",
+        [RING_BUFFER_OP_READ_MULTI_CRC]  = "read_multi_crc",
+        [RING_BUFFER_OP_FILL_FROM_FD]    = "fill_from_fd",
+        [RING_BUFFER_OP_DRAIN_TO_FD]     = "drain_to_fd",
+        [RING_BUFFER_OP_RESIZE]          = "resize",
+    };
+
+    return (op < RING_BUFFER_OP_COUNT && names[op] != NULL) ? names[op] : "unknown";
+}
+
+static bool op_is_write(uint8_t op)
+{
+    return op == RING_BUFFER_OP_WRITE || op == RING_BUFFER_OP_WRITE_MULTI ||
+           op == RING_BUFFER_OP_WRITEV || op == RING_BUFFER_OP_WRITE_MULTI_CRC ||
+           op == RING_BUFFER_OP_FILL_FROM_FD;
+}
+
+static void emit_sep(FILE *out, bool *first)
+{
+    fputs(*first ? "\n" : ",\n", out);
+    *first = false;
+}
+
+static void emit_event(FILE *out, bool *first, uint32_t thread, double ts_us,
+                       const ring_buffer_trace_event_t *ev)
+{
+    const char *name = op_name(ev->op);
+
+    if (ev->len < ev->req) {
+        name = op_is_write(ev->op) ? "overflow" : "underrun";
+    }
+
+    emit_sep(out, first);
+    fprintf(out, "{\"name\":\"%s\",\"cat\":\"ring %u\",\"ph\":\"i\",\"s\":\"t\","
+            "\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+            "\"args\":{\"ring\":%u,\"op\":\"%s\",\"req\":%u,\"len\":%u,\"occupancy\":%u}}",
+            name, ev->ring_id, ts_us, thread,
+            ev->ring_id, op_name(ev->op), ev->req, ev->len, ev->occupancy);
+
+    emit_sep(out, first);
+    fprintf(out, "{\"name\":\"ring %u\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,"
+            "\"args\":{\"occupancy\":%u}}",
+            ev->ring_id, ts_us, ev->occupancy);
+}
+
+/**
+ * @brief 转换整个文件
+ *
+ * @return 0=成功, 非 0=格式错误
+ */
+static int trace2json(FILE *in, FILE *out)
+{
+    ring_buffer_trace_file_hdr_t hdr;
+    bool first = true;
+
+    if (fread(&hdr, sizeof(hdr), 1, in) != 1 ||
+        hdr.magic != RING_BUFFER_TRACE_MAGIC ||
+        hdr.version != RING_BUFFER_TRACE_VERSION ||
+        hdr.event_size != sizeof(ring_buffer_trace_event_t) ||
+        hdr.ticks_per_us == 0) {
+        fprintf(stderr, "trace2json: not a ring buffer trace file\n");
+        return 1;
+    }
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out);
+
+    for (uint32_t t = 0; t < hdr.threads; t++) {
+        ring_buffer_trace_block_hdr_t blk;
+
+        if (fread(&blk, sizeof(blk), 1, in) != 1) {
+            fprintf(stderr, "trace2json: truncated thread block %u\n", t);
+            return 1;
+        }
+
+        emit_sep(out, &first);
+        fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                "\"args\":{\"name\":\"thread %u\"}}", blk.thread, blk.thread);
+
+        if (blk.lost > 0) {
+            fprintf(stderr, "trace2json: thread %u lost %u oldest events\n",
+                    blk.thread, blk.lost);
+        }
+
+        for (uint32_t i = 0; i < blk.count; i++) {
+            ring_buffer_trace_event_t ev;
+
+            if (fread(&ev, sizeof(ev), 1, in) != 1) {
+                fprintf(stderr, "trace2json: truncated events in thread %u\n", blk.thread);
+                return 1;
+            }
+            emit_event(out, &first, blk.thread, (double)ev.ts / hdr.ticks_per_us, &ev);
+        }
+    }
+
+    fputs("\n]}\n", out);
+    return 0;
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    FILE *in = stdin;
+
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [trace.bin] > trace.json\n", argv[0]);
+        return 2;
+    }
+
+    if (argc == 2) {
+        in = fopen(argv[1], "rb");
+        if (in == NULL) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    int ret = trace2json(in, stdout);
+
+    if (in != stdin) {
+        fclose(in);
+    }
+    return ret;
+}